@@ -0,0 +1,70 @@
+//***************************************************************************************
+// CameraPath.cpp
+//***************************************************************************************
+
+#include "CameraPath.h"
+
+using namespace DirectX;
+
+void CameraPath::AddKey(const XMFLOAT3& position, const XMFLOAT3& target)
+{
+	mPositions.push_back(position);
+	mTargets.push_back(target);
+}
+
+void CameraPath::Build(UINT samplesPerSegment)
+{
+	assert(mPositions.size() >= 2 && samplesPerSegment > 0);
+
+	mSamplesPerSegment = samplesPerSegment;
+
+	const UINT sampleCount = SegmentCount() * samplesPerSegment + 1;
+	mLengths.resize(sampleCount);
+	mLengths[0] = 0.0f;
+
+	XMVECTOR prev = XMLoadFloat3(&mPositions[0]);
+	for(UINT i = 1; i < sampleCount; ++i)
+	{
+		UINT segment = std::min<UINT>((i - 1) / samplesPerSegment, SegmentCount() - 1);
+		float t = (float)(i - segment * samplesPerSegment) / (float)samplesPerSegment;
+
+		XMVECTOR p = CatmullRom(mPositions, segment, t);
+		mLengths[i] = mLengths[i - 1] + XMVectorGetX(XMVector3Length(p - prev));
+		prev = p;
+	}
+}
+
+UINT CameraPath::Evaluate(float distance, XMFLOAT3& position, XMFLOAT3& target)const
+{
+	assert(!mLengths.empty());
+
+	distance = MathHelper::Clamp(distance, 0.0f, Length());
+
+	// First sample at or past distance, then interpolate within the sample interval.
+	UINT hi = (UINT)(std::lower_bound(mLengths.begin(), mLengths.end(), distance) - mLengths.begin());
+	hi = std::max<UINT>(1, std::min<UINT>(hi, (UINT)mLengths.size() - 1));
+	UINT lo = hi - 1;
+
+	float span = mLengths[hi] - mLengths[lo];
+	float fraction = span > 0.0f ? (distance - mLengths[lo]) / span : 0.0f;
+
+	float sample = (float)lo + fraction;
+	UINT segment = std::min<UINT>((UINT)(sample / mSamplesPerSegment), SegmentCount() - 1);
+	float t = (sample - (float)(segment * mSamplesPerSegment)) / (float)mSamplesPerSegment;
+
+	XMStoreFloat3(&position, CatmullRom(mPositions, segment, t));
+	XMStoreFloat3(&target, CatmullRom(mTargets, segment, t));
+	return segment;
+}
+
+XMVECTOR CameraPath::CatmullRom(const std::vector<XMFLOAT3>& keys, UINT segment, float t)
+{
+	const UINT last = (UINT)keys.size() - 1;
+
+	XMVECTOR p0 = XMLoadFloat3(&keys[segment > 0 ? segment - 1 : 0]);
+	XMVECTOR p1 = XMLoadFloat3(&keys[segment]);
+	XMVECTOR p2 = XMLoadFloat3(&keys[std::min<UINT>(segment + 1, last)]);
+	XMVECTOR p3 = XMLoadFloat3(&keys[std::min<UINT>(segment + 2, last)]);
+
+	return XMVectorCatmullRom(p0, p1, p2, p3, t);
+}
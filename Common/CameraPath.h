@@ -0,0 +1,48 @@
+//***************************************************************************************
+// CameraPath.h
+//
+// Camera spline through a list of keys (eye position and look-at target).  Both are
+// interpolated with uniform Catmull-Rom splines, which pass through every key; the
+// end keys are repeated as the outer control points.
+//
+// The path is parametrised by arc length of the eye position: Build samples each
+// segment and Evaluate maps a distance along the path back to a segment and spline
+// parameter, so a camera moved by equal distances moves at constant speed however
+// unevenly the keys are spaced.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class CameraPath
+{
+public:
+	void AddKey(const DirectX::XMFLOAT3& position, const DirectX::XMFLOAT3& target);
+
+	///<summary>
+	/// Builds the arc length table.  Call after adding the keys (at least two).
+	///</summary>
+	void Build(UINT samplesPerSegment = 64);
+
+	UINT SegmentCount()const { return mPositions.size() > 1 ? (UINT)mPositions.size() - 1 : 0; }
+	float Length()const { return mLengths.empty() ? 0.0f : mLengths.back(); }
+
+	///<summary>
+	/// Eye position and target at distance (clamped to [0, Length()]) along the path.
+	/// Returns the index of the segment the point lies on.
+	///</summary>
+	UINT Evaluate(float distance, DirectX::XMFLOAT3& position, DirectX::XMFLOAT3& target)const;
+
+private:
+	static DirectX::XMVECTOR CatmullRom(const std::vector<DirectX::XMFLOAT3>& keys, UINT segment, float t);
+
+private:
+	std::vector<DirectX::XMFLOAT3> mPositions;
+	std::vector<DirectX::XMFLOAT3> mTargets;
+
+	// Arc length from the start of the path at each sample; sample i lies on segment
+	// i / mSamplesPerSegment at t = (i % mSamplesPerSegment) / mSamplesPerSegment.
+	std::vector<float> mLengths;
+	UINT mSamplesPerSegment = 0;
+};
@@ -0,0 +1,87 @@
+//***************************************************************************************
+// CharacterController.cpp
+//***************************************************************************************
+
+#include "CharacterController.h"
+
+using namespace DirectX;
+
+XMFLOAT3 CharacterController::Move(
+	const ColliderGrid& colliders,
+	const XMFLOAT3& position,
+	const XMFLOAT3& displacement)const
+{
+	XMVECTOR pos = XMLoadFloat3(&position);
+	XMVECTOR remaining = XMLoadFloat3(&displacement);
+
+	// Normal of the previous contact, used to slide along the crease when the
+	// character is wedged between two walls.
+	XMVECTOR prevNormal = XMVectorZero();
+	bool hasPrevNormal = false;
+
+	for(UINT iteration = 0; iteration < MaxIterations; ++iteration)
+	{
+		float length = XMVectorGetX(XMVector3Length(remaining));
+		if(length < 1e-5f)
+			break;
+
+		BoundingSphere sphere;
+		XMStoreFloat3(&sphere.Center, pos);
+		sphere.Radius = Radius;
+
+		XMFLOAT3 delta;
+		XMStoreFloat3(&delta, remaining);
+
+		SweptSphere::Hit hit;
+		UINT collider = 0;
+		if(!colliders.Sweep(sphere, delta, hit, collider))
+		{
+			pos = XMVectorAdd(pos, remaining);
+			break;
+		}
+
+		XMVECTOR normal = XMLoadFloat3(&hit.Normal);
+
+		if(hit.T > 0.0f)
+		{
+			// Advance to just short of the contact.
+			float travel = std::max<float>(0.0f, hit.T * length - SkinWidth);
+			pos = XMVectorAdd(pos, XMVectorScale(remaining, travel / length));
+			remaining = XMVectorScale(remaining, 1.0f - hit.T);
+		}
+		else
+		{
+			// Started in contact (e.g. spawned inside a wall): nudge out along the
+			// normal and slide the whole move.
+			pos = XMVectorAdd(pos, XMVectorScale(normal, SkinWidth));
+		}
+
+		// Drop the part of the move that goes into the wall.
+		float into = XMVectorGetX(XMVector3Dot(remaining, normal));
+		if(into < 0.0f)
+			remaining = XMVectorSubtract(remaining, XMVectorScale(normal, into));
+
+		// Against two walls at once, only movement along their shared edge is free.
+		if(hasPrevNormal && XMVectorGetX(XMVector3Dot(remaining, prevNormal)) < 0.0f)
+		{
+			XMVECTOR crease = XMVector3Cross(prevNormal, normal);
+			float creaseLength = XMVectorGetX(XMVector3Length(crease));
+			if(creaseLength > 1e-5f)
+			{
+				crease = XMVectorScale(crease, 1.0f / creaseLength);
+				remaining = XMVectorScale(crease, XMVectorGetX(XMVector3Dot(remaining, crease)));
+			}
+			else
+			{
+				remaining = XMVectorZero();
+			}
+		}
+
+		prevNormal = normal;
+		hasPrevNormal = true;
+	}
+
+	XMFLOAT3 result;
+	XMStoreFloat3(&result, pos);
+	return result;
+}
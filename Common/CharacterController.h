@@ -0,0 +1,37 @@
+//***************************************************************************************
+// CharacterController.h
+//
+// Collide-and-slide movement for a sphere shaped character (e.g. the camera).  Each
+// move is swept against the colliders instead of being tested only at its end
+// point, so fast moves cannot tunnel through thin walls.  On contact the character
+// stops just short of the wall and the rest of the move is projected onto the wall
+// so it slides along it instead of sticking.
+//***************************************************************************************
+
+#pragma once
+
+#include "ColliderGrid.h"
+
+class CharacterController
+{
+public:
+	// Collision radius of the character.
+	float Radius = 0.5f;
+
+	// Gap kept between the character and what it touches, so the next sweep does
+	// not start in contact.
+	float SkinWidth = 0.01f;
+
+	// Upper bound on sweeps per move.  Each contact uses one; what remains of the
+	// move after the last one is dropped.
+	UINT MaxIterations = 4;
+
+	///<summary>
+	/// Moves the character from position by displacement, sliding along any
+	/// colliders in the way, and returns where it ends up.
+	///</summary>
+	DirectX::XMFLOAT3 Move(
+		const ColliderGrid& colliders,
+		const DirectX::XMFLOAT3& position,
+		const DirectX::XMFLOAT3& displacement)const;
+};
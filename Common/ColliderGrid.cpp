@@ -0,0 +1,197 @@
+//***************************************************************************************
+// ColliderGrid.cpp
+//***************************************************************************************
+
+#include "ColliderGrid.h"
+#include <cmath>
+#include <ppl.h>
+
+using namespace DirectX;
+
+namespace
+{
+	// Below this many queries the batched Intersects runs on the calling thread.
+	const UINT ParallelQueryThreshold = 256;
+}
+
+void ColliderGrid::Build(const std::vector<BoundingBox>& colliders, float cellSize)
+{
+	assert(cellSize > 0.0f);
+
+	mColliders = colliders;
+	mCellSize = cellSize;
+	mInvCellSize = 1.0f / cellSize;
+
+	mCellStart.clear();
+	mCellItems.clear();
+	mColliderCells.clear();
+
+	if(mColliders.empty())
+	{
+		mCellsX = mCellsZ = 0;
+		return;
+	}
+
+	// Grid bounds in xz.
+	float minX = +MathHelper::Infinity, minZ = +MathHelper::Infinity;
+	float maxX = -MathHelper::Infinity, maxZ = -MathHelper::Infinity;
+	for(const BoundingBox& box : mColliders)
+	{
+		minX = std::min<float>(minX, box.Center.x - box.Extents.x);
+		minZ = std::min<float>(minZ, box.Center.z - box.Extents.z);
+		maxX = std::max<float>(maxX, box.Center.x + box.Extents.x);
+		maxZ = std::max<float>(maxZ, box.Center.z + box.Extents.z);
+	}
+
+	mOriginX = minX;
+	mOriginZ = minZ;
+	mCellsX = std::max<int>(1, (int)std::ceil((maxX - minX) * mInvCellSize));
+	mCellsZ = std::max<int>(1, (int)std::ceil((maxZ - minZ) * mInvCellSize));
+
+	// Counting sort of (cell, collider) pairs: count, prefix sum, then scatter.
+	const size_t cellCount = (size_t)mCellsX * mCellsZ;
+	mCellStart.assign(cellCount + 1, 0);
+
+	mColliderCells.resize(mColliders.size());
+	for(size_t i = 0; i < mColliders.size(); ++i)
+	{
+		CellRange range = CellsOverlapping(mColliders[i]);
+		mColliderCells[i] = range;
+
+		for(int z = range.MinZ; z <= range.MaxZ; ++z)
+			for(int x = range.MinX; x <= range.MaxX; ++x)
+				++mCellStart[(size_t)z * mCellsX + x + 1];
+	}
+
+	for(size_t c = 0; c < cellCount; ++c)
+		mCellStart[c + 1] += mCellStart[c];
+
+	mCellItems.resize(mCellStart[cellCount]);
+	std::vector<UINT> cursor(mCellStart.begin(), mCellStart.end() - 1);
+	for(size_t i = 0; i < mColliders.size(); ++i)
+	{
+		const CellRange& range = mColliderCells[i];
+		for(int z = range.MinZ; z <= range.MaxZ; ++z)
+			for(int x = range.MinX; x <= range.MaxX; ++x)
+				mCellItems[cursor[(size_t)z * mCellsX + x]++] = (UINT)i;
+	}
+}
+
+ColliderGrid::CellRange ColliderGrid::CellsOverlapping(float minX, float minZ, float maxX, float maxZ)const
+{
+	CellRange range;
+	if(mCellsX == 0)
+		return range;
+
+	range.MinX = MathHelper::Clamp((int)std::floor((minX - mOriginX) * mInvCellSize), 0, mCellsX - 1);
+	range.MinZ = MathHelper::Clamp((int)std::floor((minZ - mOriginZ) * mInvCellSize), 0, mCellsZ - 1);
+	range.MaxX = MathHelper::Clamp((int)std::floor((maxX - mOriginX) * mInvCellSize), 0, mCellsX - 1);
+	range.MaxZ = MathHelper::Clamp((int)std::floor((maxZ - mOriginZ) * mInvCellSize), 0, mCellsZ - 1);
+	return range;
+}
+
+ColliderGrid::CellRange ColliderGrid::CellsOverlapping(const BoundingBox& box)const
+{
+	return CellsOverlapping(
+		box.Center.x - box.Extents.x, box.Center.z - box.Extents.z,
+		box.Center.x + box.Extents.x, box.Center.z + box.Extents.z);
+}
+
+template<typename Func>
+bool ColliderGrid::ForEachCandidate(const CellRange& range, Func func)const
+{
+	for(int z = range.MinZ; z <= range.MaxZ; ++z)
+	{
+		for(int x = range.MinX; x <= range.MaxX; ++x)
+		{
+			const size_t cell = (size_t)z * mCellsX + x;
+			for(UINT k = mCellStart[cell]; k < mCellStart[cell + 1]; ++k)
+			{
+				UINT i = mCellItems[k];
+
+				// Only the first cell shared by the query and the collider reports it.
+				const CellRange& cells = mColliderCells[i];
+				if(x != std::max<int>(cells.MinX, range.MinX) || z != std::max<int>(cells.MinZ, range.MinZ))
+					continue;
+
+				if(func(i))
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void ColliderGrid::GatherCandidates(const BoundingBox& bounds, std::vector<UINT>& candidates)const
+{
+	ForEachCandidate(CellsOverlapping(bounds), [&](UINT i)
+	{
+		candidates.push_back(i);
+		return false;
+	});
+}
+
+bool ColliderGrid::Intersects(const BoundingSphere& sphere)const
+{
+	CellRange range = CellsOverlapping(
+		sphere.Center.x - sphere.Radius, sphere.Center.z - sphere.Radius,
+		sphere.Center.x + sphere.Radius, sphere.Center.z + sphere.Radius);
+
+	return ForEachCandidate(range, [&](UINT i)
+	{
+		return mColliders[i].Intersects(sphere);
+	});
+}
+
+void ColliderGrid::Intersects(const BoundingSphere* spheres, UINT count, std::uint8_t* hits)const
+{
+	if(count < ParallelQueryThreshold)
+	{
+		for(UINT i = 0; i < count; ++i)
+			hits[i] = Intersects(spheres[i]) ? 1 : 0;
+		return;
+	}
+
+	// Queries only read the grid, so chunks can run concurrently.
+	const UINT chunkSize = ParallelQueryThreshold;
+	const UINT chunkCount = (count + chunkSize - 1) / chunkSize;
+	concurrency::parallel_for(0u, chunkCount, [&](UINT chunk)
+	{
+		UINT first = chunk * chunkSize;
+		UINT last = std::min<UINT>(first + chunkSize, count);
+		for(UINT i = first; i < last; ++i)
+			hits[i] = Intersects(spheres[i]) ? 1 : 0;
+	});
+}
+
+bool ColliderGrid::Sweep(
+	const BoundingSphere& sphere,
+	const XMFLOAT3& displacement,
+	SweptSphere::Hit& hit,
+	UINT& colliderIndex)const
+{
+	// Candidates come from every cell the swept sphere passes over.
+	const XMFLOAT3& c = sphere.Center;
+	const float r = sphere.Radius;
+	CellRange range = CellsOverlapping(
+		std::min<float>(c.x, c.x + displacement.x) - r, std::min<float>(c.z, c.z + displacement.z) - r,
+		std::max<float>(c.x, c.x + displacement.x) + r, std::max<float>(c.z, c.z + displacement.z) + r);
+
+	bool found = false;
+	float maxT = 1.0f;
+	ForEachCandidate(range, [&](UINT i)
+	{
+		SweptSphere::Hit candidate;
+		if(SweptSphere::IntersectAabb(mColliders[i], c, r, displacement, maxT, candidate))
+		{
+			hit = candidate;
+			colliderIndex = i;
+			maxT = candidate.T;
+			found = true;
+		}
+		return false;
+	});
+
+	return found;
+}
@@ -0,0 +1,95 @@
+//***************************************************************************************
+// ColliderGrid.h
+//
+// Static broadphase for the level's axis aligned colliders.  The colliders are
+// binned into a uniform grid over the xz-plane (levels are flat, so y is left to
+// the exact test).  Cells are stored compressed: one offset per cell into a single
+// array of collider indices, so a query touches a few contiguous runs of indices
+// no matter how many colliders the level has.
+//
+// A collider that overlaps several cells is listed in each of them.  Queries only
+// report it from the first cell where it and the query region overlap, so results
+// never contain duplicates and no per-query "already tested" state is needed.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include "SweptSphere.h"
+
+class ColliderGrid
+{
+public:
+	///<summary>
+	/// Bins the colliders into cells of cellSize x cellSize world units.  A cell
+	/// around the typical wall length keeps both the cell count and the number of
+	/// colliders per cell small.  Build copies the colliders.
+	///</summary>
+	void Build(const std::vector<DirectX::BoundingBox>& colliders, float cellSize);
+
+	UINT ColliderCount()const { return (UINT)mColliders.size(); }
+	const DirectX::BoundingBox& Collider(UINT i)const { return mColliders[i]; }
+
+	///<summary>
+	/// Appends the index of every collider whose cells overlap bounds in xz.  These
+	/// are broadphase candidates; each is reported once.
+	///</summary>
+	void GatherCandidates(const DirectX::BoundingBox& bounds, std::vector<UINT>& candidates)const;
+
+	///<summary>
+	/// True if the sphere intersects any collider.
+	///</summary>
+	bool Intersects(const DirectX::BoundingSphere& sphere)const;
+
+	///<summary>
+	/// Batched form of Intersects: hits[i] is set to 1 if spheres[i] intersects a
+	/// collider and 0 otherwise.  Large batches are split across worker threads.
+	///</summary>
+	void Intersects(const DirectX::BoundingSphere* spheres, UINT count, std::uint8_t* hits)const;
+
+	///<summary>
+	/// Sweeps the sphere along displacement and returns true with the earliest
+	/// contact if it touches any collider on the way.  colliderIndex receives the
+	/// collider that was hit.
+	///</summary>
+	bool Sweep(
+		const DirectX::BoundingSphere& sphere,
+		const DirectX::XMFLOAT3& displacement,
+		SweptSphere::Hit& hit,
+		UINT& colliderIndex)const;
+
+private:
+	struct CellRange
+	{
+		int MinX = 0;
+		int MinZ = 0;
+		int MaxX = -1;
+		int MaxZ = -1;
+	};
+
+	// Cells overlapped by [minX, maxX] x [minZ, maxZ], clamped to the grid.
+	CellRange CellsOverlapping(float minX, float minZ, float maxX, float maxZ)const;
+	CellRange CellsOverlapping(const DirectX::BoundingBox& box)const;
+
+	// Calls func(colliderIndex) for each collider overlapping range, once each.
+	// Returns early, with true, as soon as func returns true.
+	template<typename Func>
+	bool ForEachCandidate(const CellRange& range, Func func)const;
+
+private:
+	float mCellSize = 1.0f;
+	float mInvCellSize = 1.0f;
+	float mOriginX = 0.0f;
+	float mOriginZ = 0.0f;
+	int mCellsX = 0;
+	int mCellsZ = 0;
+
+	// Cell c holds mCellItems[mCellStart[c], mCellStart[c + 1]).
+	std::vector<UINT> mCellStart;
+	std::vector<UINT> mCellItems;
+
+	// Cells each collider occupies; the minimum corner is used to skip duplicates.
+	std::vector<CellRange> mColliderCells;
+
+	std::vector<DirectX::BoundingBox> mColliders;
+};
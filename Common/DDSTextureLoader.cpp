@@ -268,6 +268,117 @@ static HRESULT LoadTextureDataFromFile( _In_z_ const wchar_t* fileName,
     return S_OK;
 }
 
+//--------------------------------------------------------------------------------------
+// Same as LoadTextureDataFromFile, but maps the file read-only instead of reading it
+// into a heap buffer; the pages are read in as the texels are first touched.
+static HRESULT MapTextureDataFromFile( _In_z_ const wchar_t* fileName,
+                                       std::unique_ptr<const void, DDSFileViewCloser>& fileView,
+                                       const DDS_HEADER** header,
+                                       const uint8_t** bitData,
+                                       size_t* bitSize
+                                     )
+{
+    if (!header || !bitData || !bitSize)
+    {
+        return E_POINTER;
+    }
+
+    // open the file
+#if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
+    ScopedHandle hFile( safe_handle( CreateFile2( fileName,
+                                                  GENERIC_READ,
+                                                  FILE_SHARE_READ,
+                                                  OPEN_EXISTING,
+                                                  nullptr ) ) );
+#else
+    ScopedHandle hFile( safe_handle( CreateFileW( fileName,
+                                                  GENERIC_READ,
+                                                  FILE_SHARE_READ,
+                                                  nullptr,
+                                                  OPEN_EXISTING,
+                                                  FILE_ATTRIBUTE_NORMAL,
+                                                  nullptr ) ) );
+#endif
+
+    if ( !hFile )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+    // Get the file size
+    LARGE_INTEGER FileSize = { 0 };
+    if ( !GetFileSizeEx( hFile.get(), &FileSize ) )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+    // File is too big to map into a 32-bit process, so reject it
+    if (FileSize.HighPart > 0)
+    {
+        return E_FAIL;
+    }
+
+    // Need at least enough data to fill the header and magic number to be a valid DDS
+    if (FileSize.LowPart < ( sizeof(DDS_HEADER) + sizeof(uint32_t) ) )
+    {
+        return E_FAIL;
+    }
+
+    // The view keeps the mapping (and the file) open after both handles are closed
+    ScopedHandle hMapping( CreateFileMappingW( hFile.get(), nullptr, PAGE_READONLY, 0, 0, nullptr ) );
+    if ( !hMapping )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+    fileView.reset( MapViewOfFile( hMapping.get(), FILE_MAP_READ, 0, 0, 0 ) );
+    if ( !fileView )
+    {
+        return HRESULT_FROM_WIN32( GetLastError() );
+    }
+
+    auto ddsData = static_cast<const uint8_t*>( fileView.get() );
+
+    // DDS files always start with the same magic number ("DDS ")
+    uint32_t dwMagicNumber = *( const uint32_t* )( ddsData );
+    if (dwMagicNumber != DDS_MAGIC)
+    {
+        return E_FAIL;
+    }
+
+    auto hdr = reinterpret_cast<const DDS_HEADER*>( ddsData + sizeof( uint32_t ) );
+
+    // Verify header to validate DDS file
+    if (hdr->size != sizeof(DDS_HEADER) ||
+        hdr->ddspf.size != sizeof(DDS_PIXELFORMAT))
+    {
+        return E_FAIL;
+    }
+
+    // Check for DX10 extension
+    bool bDXT10Header = false;
+    if ((hdr->ddspf.flags & DDS_FOURCC) &&
+        (MAKEFOURCC( 'D', 'X', '1', '0' ) == hdr->ddspf.fourCC))
+    {
+        // Must be long enough for both headers and magic value
+        if (FileSize.LowPart < ( sizeof(DDS_HEADER) + sizeof(uint32_t) + sizeof(DDS_HEADER_DXT10) ) )
+        {
+            return E_FAIL;
+        }
+
+        bDXT10Header = true;
+    }
+
+    // setup the pointers in the process request
+    *header = hdr;
+    ptrdiff_t offset = sizeof( uint32_t ) + sizeof( DDS_HEADER )
+                       + (bDXT10Header ? sizeof( DDS_HEADER_DXT10 ) : 0);
+    *bitData = ddsData + offset;
+    *bitSize = FileSize.LowPart - offset;
+
+    return S_OK;
+}
+
 
 //--------------------------------------------------------------------------------------
 // Return the BPP for a particular format
@@ -1674,16 +1785,14 @@ static HRESULT CreateTextureFromDDS( _In_ ID3D11Device* d3dDevice,
     return hr;
 }
 
-static HRESULT CreateTextureFromDDS12(
-	_In_ ID3D12Device* device,
-	_In_opt_ ID3D12GraphicsCommandList* cmdList,
+// Validates the header and fills in data's description and subresources, which
+// point into bitData.
+static HRESULT LayoutTextureFromDDS12(
 	_In_ const DDS_HEADER* header,
 	_In_reads_bytes_(bitSize) const uint8_t* bitData,
 	_In_ size_t bitSize,
 	_In_ size_t maxsize,
-	_In_ bool forceSRGB,
-	ComPtr<ID3D12Resource>& texture,
-	ComPtr<ID3D12Resource>& textureUploadHeap)
+	DDSTextureData12& data)
 {
 	HRESULT hr = S_OK;
 
@@ -1840,15 +1949,7 @@ static HRESULT CreateTextureFromDDS12(
 		return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
 	}
 
-	// Create the texture
-	std::unique_ptr<D3D12_SUBRESOURCE_DATA[]> initData(
-		new (std::nothrow) D3D12_SUBRESOURCE_DATA[mipCount * arraySize]
-		);
-
-	if (!initData)
-	{
-		return E_OUTOFMEMORY;
-	}
+	data.Subresources.resize(mipCount * arraySize);
 
 	size_t skipMip = 0;
 	size_t twidth = 0;
@@ -1857,20 +1958,50 @@ static HRESULT CreateTextureFromDDS12(
 
 	hr = FillInitData12(
 		width, height, depth, mipCount, arraySize, format, maxsize, bitSize, bitData,
-		twidth, theight, tdepth, skipMip, initData.get()
+		twidth, theight, tdepth, skipMip, data.Subresources.data()
 		);
 
+	if (SUCCEEDED(hr))
+	{
+		data.Dimension = resDim;
+		data.Width = twidth;
+		data.Height = theight;
+		data.Depth = tdepth;
+		data.MipCount = mipCount - skipMip;
+		data.ArraySize = arraySize;
+		data.Format = format;
+		data.IsCubeMap = isCubeMap;
+		data.Subresources.resize(data.MipCount * arraySize);
+	}
+
+	return hr;
+}
+
+static HRESULT CreateTextureFromDDS12(
+	_In_ ID3D12Device* device,
+	_In_opt_ ID3D12GraphicsCommandList* cmdList,
+	_In_ const DDS_HEADER* header,
+	_In_reads_bytes_(bitSize) const uint8_t* bitData,
+	_In_ size_t bitSize,
+	_In_ size_t maxsize,
+	_In_ bool forceSRGB,
+	ComPtr<ID3D12Resource>& texture,
+	ComPtr<ID3D12Resource>& textureUploadHeap)
+{
+	DDSTextureData12 data;
+	HRESULT hr = LayoutTextureFromDDS12(header, bitData, bitSize, maxsize, data);
+
 	if (SUCCEEDED(hr))
 	{
 		hr = CreateD3DResources12(
 			device, cmdList,
-			resDim, twidth, theight, tdepth,
-			mipCount - skipMip,
-			arraySize,
-			format,
+			data.Dimension, data.Width, data.Height, data.Depth,
+			data.MipCount,
+			data.ArraySize,
+			data.Format,
 			false, // forceSRGB
-			isCubeMap,
-			initData.get(),
+			data.IsCubeMap,
+			data.Subresources.data(),
 			texture, 
 			textureUploadHeap);
 	}
@@ -2165,72 +2296,191 @@ HRESULT DirectX::CreateDDSTextureFromFile12(_In_ ID3D12Device* device,
 		return E_INVALIDARG;
 	}
 
-	DDS_HEADER* header = nullptr;
-	uint8_t* bitData = nullptr;
+	// Mapped and copied once into the upload heap; see DDSTextureData12.
+	DDSTextureData12 data;
+	HRESULT hr = LoadDDSTextureData12(szFileName, data, maxsize);
+	if (SUCCEEDED(hr))
+	{
+		hr = CreateDDSTextureFromData12(device, cmdList, data, texture, textureUploadHeap);
+	}
+
+	if (SUCCEEDED(hr) && alphaMode)
+	{
+		*alphaMode = data.AlphaMode;
+	}
+
+	return hr;
+}
+
+HRESULT DirectX::LoadDDSTextureData12(_In_z_ const wchar_t* szFileName,
+	_Out_ DDSTextureData12& data,
+	_In_ size_t maxsize)
+{
+	data = DDSTextureData12();
+
+	if (!szFileName)
+	{
+		return E_INVALIDARG;
+	}
+
+	const DDS_HEADER* header = nullptr;
+	const uint8_t* bitData = nullptr;
 	size_t bitSize = 0;
 
-	std::unique_ptr<uint8_t[]> ddsData;
-	HRESULT hr = LoadTextureDataFromFile(szFileName, ddsData, &header, &bitData, &bitSize);
+	HRESULT hr = MapTextureDataFromFile(szFileName, data.FileView, &header, &bitData, &bitSize);
 	if (FAILED(hr))
 	{
 		return hr;
 	}
 
-	hr = CreateTextureFromDDS12(device, cmdList, header,
-		bitData, bitSize, maxsize, false, texture, textureUploadHeap);
+	hr = LayoutTextureFromDDS12(header, bitData, bitSize, maxsize, data);
+	if (FAILED(hr))
+	{
+		data = DDSTextureData12();
+		return hr;
+	}
 
-	if (SUCCEEDED(hr))
+	// Touch every page of the texels so the disk reads happen here, on the loading
+	// thread, rather than as page faults during the copy in CreateDDSTextureFromData12.
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+
+	volatile uint8_t touched = 0;
+	for (size_t offset = 0; offset < bitSize; offset += systemInfo.dwPageSize)
 	{
-/*
-#if !defined(NO_D3D11_DEBUG_NAME) && ( defined(_DEBUG) || defined(PROFILE) )
-		if (texture != 0 || textureView != 0)
-		{
-			CHAR strFileA[MAX_PATH];
-			int result = WideCharToMultiByte(CP_ACP,
-				WC_NO_BEST_FIT_CHARS,
-				fileName,
-				-1,
-				strFileA,
-				MAX_PATH,
-				nullptr,
-				FALSE
-				);
-			if (result > 0)
-			{
-				const CHAR* pstrName = strrchr(strFileA, '\\');
-				if (!pstrName)
-				{
-					pstrName = strFileA;
-				}
-				else
-				{
-					pstrName++;
-				}
+		touched ^= bitData[offset];
+	}
 
-				if (texture != 0 && *texture != 0)
-				{
-					(*texture)->SetPrivateData(WKPDID_D3DDebugObjectName,
-						static_cast<UINT>(strnlen_s(pstrName, MAX_PATH)),
-						pstrName
-						);
-				}
+	data.AlphaMode = GetAlphaMode(header);
+	return S_OK;
+}
 
-				if (textureView != 0 && *textureView != 0)
-				{
-					(*textureView)->SetPrivateData(WKPDID_D3DDebugObjectName,
-						static_cast<UINT>(strnlen_s(pstrName, MAX_PATH)),
-						pstrName
-						);
-				}
+HRESULT DirectX::CreateDDSTextureFromData12(_In_ ID3D12Device* device,
+	_In_ ID3D12GraphicsCommandList* cmdList,
+	_In_ const DDSTextureData12& data,
+	_Out_ ComPtr<ID3D12Resource>& texture,
+	_Out_ ComPtr<ID3D12Resource>& textureUploadHeap)
+{
+	texture = nullptr;
+	textureUploadHeap = nullptr;
+
+	if (!device || !cmdList || data.Subresources.empty())
+	{
+		return E_INVALIDARG;
+	}
+
+	// Like CreateD3DResources12, only 2D textures (including arrays and cubes).
+	if (data.Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D)
+	{
+		return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+	}
+
+	D3D12_RESOURCE_DESC texDesc;
+	ZeroMemory(&texDesc, sizeof(D3D12_RESOURCE_DESC));
+	texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	texDesc.Alignment = 0;
+	texDesc.Width = data.Width;
+	texDesc.Height = (uint32_t)data.Height;
+	texDesc.DepthOrArraySize = (data.Depth > 1) ? (uint16_t)data.Depth : (uint16_t)data.ArraySize;
+	texDesc.MipLevels = (uint16_t)data.MipCount;
+	texDesc.Format = data.Format;
+	texDesc.SampleDesc.Count = 1;
+	texDesc.SampleDesc.Quality = 0;
+	texDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+	texDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	// Created ready to copy into, so no barrier is needed before the copies.
+	auto defaultHeap = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+	HRESULT hr = device->CreateCommittedResource(
+		&defaultHeap,
+		D3D12_HEAP_FLAG_NONE,
+		&texDesc,
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(&texture));
+	if (FAILED(hr))
+	{
+		texture = nullptr;
+		return hr;
+	}
+
+	// Where each subresource goes in the upload buffer, with its rows padded out to
+	// D3D12_TEXTURE_DATA_PITCH_ALIGNMENT.
+	const UINT numSubresources = (UINT)data.Subresources.size();
+	std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(numSubresources);
+	std::vector<UINT> numRows(numSubresources);
+	std::vector<UINT64> rowSizes(numSubresources);
+	UINT64 uploadBufferSize = 0;
+	device->GetCopyableFootprints(&texDesc, 0, numSubresources, 0,
+		layouts.data(), numRows.data(), rowSizes.data(), &uploadBufferSize);
+
+	auto uploadHeap = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	auto buffer = CD3DX12_RESOURCE_DESC::Buffer(uploadBufferSize);
+	hr = device->CreateCommittedResource(
+		&uploadHeap,
+		D3D12_HEAP_FLAG_NONE,
+		&buffer,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&textureUploadHeap));
+	if (FAILED(hr))
+	{
+		texture = nullptr;
+		textureUploadHeap = nullptr;
+		return hr;
+	}
+
+	uint8_t* mapped = nullptr;
+	D3D12_RANGE noRead = { 0, 0 };
+	hr = textureUploadHeap->Map(0, &noRead, reinterpret_cast<void**>(&mapped));
+	if (FAILED(hr))
+	{
+		texture = nullptr;
+		textureUploadHeap = nullptr;
+		return hr;
+	}
+
+	// The only copy of the texels on the CPU: from the file mapping to their final
+	// place in the upload buffer.  Rows are copied one by one unless the file's
+	// pitch already matches the footprint's.
+	for (UINT i = 0; i < numSubresources; ++i)
+	{
+		const D3D12_SUBRESOURCE_DATA& src = data.Subresources[i];
+		const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = layouts[i];
+		const size_t rowSize = (size_t)rowSizes[i];
+		const size_t dstRowPitch = layout.Footprint.RowPitch;
+		const size_t dstSlicePitch = dstRowPitch * numRows[i];
+
+		for (UINT z = 0; z < layout.Footprint.Depth; ++z)
+		{
+			uint8_t* dstSlice = mapped + layout.Offset + dstSlicePitch * z;
+			const uint8_t* srcSlice = static_cast<const uint8_t*>(src.pData) + src.SlicePitch * z;
+
+			if ((size_t)src.RowPitch == dstRowPitch)
+			{
+				memcpy(dstSlice, srcSlice, dstRowPitch * (numRows[i] - 1) + rowSize);
+				continue;
 			}
+
+			for (UINT y = 0; y < numRows[i]; ++y)
+				memcpy(dstSlice + dstRowPitch * y, srcSlice + src.RowPitch * y, rowSize);
 		}
-#endif
-*/
-		if (alphaMode)
-			*alphaMode = GetAlphaMode(header);
 	}
 
-	return hr;
+	textureUploadHeap->Unmap(0, nullptr);
+
+	for (UINT i = 0; i < numSubresources; ++i)
+	{
+		CD3DX12_TEXTURE_COPY_LOCATION dst(texture.Get(), i);
+		CD3DX12_TEXTURE_COPY_LOCATION src(textureUploadHeap.Get(), layouts[i]);
+		cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+	}
+
+	auto transition = CD3DX12_RESOURCE_BARRIER::Transition(texture.Get(),
+		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+	cmdList->ResourceBarrier(1, &transition);
+
+	return S_OK;
 }
 
 _Use_decl_annotations_
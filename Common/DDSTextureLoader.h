@@ -32,6 +32,9 @@
 
 #pragma warning(pop)
 
+#include <memory>
+#include <vector>
+
 #if defined(_MSC_VER) && (_MSC_VER<1610) && !defined(_In_reads_)
 #define _In_reads_(exp)
 #define _Out_writes_(exp)
@@ -92,6 +95,47 @@ namespace DirectX
 		                               _Out_opt_ DDS_ALPHA_MODE* alphaMode = nullptr
 		                               );
 
+	// Unmaps a read-only view of a DDS file.
+	struct DDSFileViewCloser
+	{
+		void operator()(const void* view) const { if (view) UnmapViewOfFile(view); }
+	};
+
+	// A DDS file mapped and parsed into everything resource creation needs.  Loading
+	// touches neither the device nor a command list, so it may run on any thread;
+	// CreateDDSTextureFromData12 then creates the texture on the thread that owns
+	// the command list.  The file is memory mapped rather than read into a heap
+	// buffer, and Subresources point into the mapping, so the texels are copied once:
+	// from the mapping straight to their row-pitched place in the upload heap.
+	struct DDSTextureData12
+	{
+		std::unique_ptr<const void, DDSFileViewCloser> FileView;
+
+		uint32_t Dimension = 0; // D3D12_RESOURCE_DIMENSION
+		size_t Width = 0;
+		size_t Height = 0;
+		size_t Depth = 0;
+		size_t MipCount = 0;
+		size_t ArraySize = 0;
+		DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+		bool IsCubeMap = false;
+		DDS_ALPHA_MODE AlphaMode = DDS_ALPHA_MODE_UNKNOWN;
+
+		std::vector<D3D12_SUBRESOURCE_DATA> Subresources;
+	};
+
+	HRESULT LoadDDSTextureData12(_In_z_ const wchar_t* szFileName,
+		                         _Out_ DDSTextureData12& data,
+		                         _In_ size_t maxsize = 0
+		                         );
+
+	HRESULT CreateDDSTextureFromData12(_In_ ID3D12Device* device,
+		                               _In_ ID3D12GraphicsCommandList* cmdList,
+		                               _In_ const DDSTextureData12& data,
+		                               _Out_ Microsoft::WRL::ComPtr<ID3D12Resource>& texture,
+		                               _Out_ Microsoft::WRL::ComPtr<ID3D12Resource>& textureUploadHeap
+		                               );
+
     // Standard version with optional auto-gen mipmap support
     HRESULT CreateDDSTextureFromMemory( _In_ ID3D11Device* d3dDevice,
                                         _In_opt_ ID3D11DeviceContext* d3dContext,
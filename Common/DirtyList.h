@@ -0,0 +1,74 @@
+//***************************************************************************************
+// DirtyList.h
+//
+// Set of indices whose data is stale in one copy of a buffer (e.g. one frame
+// resource's constant buffer).  Marking is O(1) and ignores indices already queued;
+// flushing visits only the queued indices, so a mostly static scene costs nothing
+// per frame.  Keep one list per frame resource and mark an index in all of them
+// when its data changes.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class DirtyList
+{
+public:
+	///<summary>
+	/// Sizes the list for indices [0, count) and queues all of them, since a fresh
+	/// buffer holds no valid data yet.
+	///</summary>
+	void Reset(UINT count)
+	{
+		mQueued.assign(count, 1);
+		mItems.resize(count);
+		for(UINT i = 0; i < count; ++i)
+			mItems[i] = i;
+	}
+
+	///<summary>
+	/// Extends the list to indices [0, count), queuing the new ones.
+	///</summary>
+	void Grow(UINT count)
+	{
+		for(UINT i = (UINT)mQueued.size(); i < count; ++i)
+		{
+			mQueued.push_back(1);
+			mItems.push_back(i);
+		}
+	}
+
+	// Indices [0, Capacity()) may be marked.
+	UINT Capacity()const { return (UINT)mQueued.size(); }
+
+	void Mark(UINT index)
+	{
+		if(!mQueued[index])
+		{
+			mQueued[index] = 1;
+			mItems.push_back(index);
+		}
+	}
+
+	UINT Count()const { return (UINT)mItems.size(); }
+
+	///<summary>
+	/// Calls update(index) for every queued index, in the order they were marked,
+	/// and empties the list.
+	///</summary>
+	template<typename F>
+	void Flush(F update)
+	{
+		for(UINT index : mItems)
+		{
+			update(index);
+			mQueued[index] = 0;
+		}
+		mItems.clear();
+	}
+
+private:
+	std::vector<UINT> mItems;
+	std::vector<std::uint8_t> mQueued;
+};
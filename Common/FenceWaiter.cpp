@@ -0,0 +1,52 @@
+//***************************************************************************************
+// FenceWaiter.cpp
+//***************************************************************************************
+
+#include "FenceWaiter.h"
+#include "Profiler.h"
+
+FenceWaiter::FenceWaiter()
+{
+	// Auto-reset, so the event is ready for the next wait as soon as one returns.
+	mEvent = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+	if(mEvent == nullptr)
+		ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	mMsPerCount = 1000.0 / (double)frequency.QuadPart;
+}
+
+FenceWaiter::~FenceWaiter()
+{
+	if(mEvent != nullptr)
+		CloseHandle(mEvent);
+}
+
+bool FenceWaiter::Wait(ID3D12Fence* fence, UINT64 value)
+{
+	if(fence->GetCompletedValue() >= value)
+		return false;
+
+	PROFILE_SCOPE("Fence wait");
+
+	LARGE_INTEGER start;
+	QueryPerformanceCounter(&start);
+
+	ThrowIfFailed(fence->SetEventOnCompletion(value, mEvent));
+	WaitForSingleObject(mEvent, INFINITE);
+
+	LARGE_INTEGER end;
+	QueryPerformanceCounter(&end);
+
+	double ms = (double)(end.QuadPart - start.QuadPart) * mMsPerCount;
+	mFrameStallMs += ms;
+	mTotalStallMs += ms;
+	return true;
+}
+
+void FenceWaiter::EndFrame()
+{
+	mLastFrameStallMs = (float)mFrameStallMs;
+	mFrameStallMs = 0.0;
+}
@@ -0,0 +1,44 @@
+//***************************************************************************************
+// FenceWaiter.h
+//
+// Blocks the CPU until a fence reaches a value, reusing one Win32 event for every
+// wait instead of creating and closing one each time.  It also times the waits, so
+// the render loop can see how long the CPU stalled on the GPU in each frame.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class FenceWaiter
+{
+public:
+	FenceWaiter();
+	FenceWaiter(const FenceWaiter& rhs) = delete;
+	FenceWaiter& operator=(const FenceWaiter& rhs) = delete;
+	~FenceWaiter();
+
+	///<summary>
+	/// Returns once fence has reached value.  Returns true if that meant waiting.
+	///</summary>
+	bool Wait(ID3D12Fence* fence, UINT64 value);
+
+	///<summary>
+	/// Closes the frame's stall accounting: LastFrameStallMs becomes the time spent
+	/// waiting since the previous call.
+	///</summary>
+	void EndFrame();
+
+	float LastFrameStallMs()const { return mLastFrameStallMs; }
+
+	// Time spent waiting since creation, in milliseconds.
+	double TotalStallMs()const { return mTotalStallMs; }
+
+private:
+	HANDLE mEvent = nullptr;
+	double mMsPerCount = 0.0;
+
+	double mFrameStallMs = 0.0;
+	float mLastFrameStallMs = 0.0f;
+	double mTotalStallMs = 0.0;
+};
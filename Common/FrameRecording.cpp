@@ -0,0 +1,90 @@
+//***************************************************************************************
+// FrameRecording.cpp
+//***************************************************************************************
+
+#include "FrameRecording.h"
+
+FrameRecorder::~FrameRecorder()
+{
+	Close();
+}
+
+bool FrameRecorder::Open(const std::string& path)
+{
+	Close();
+
+	mFile.open(path, std::ios::binary | std::ios::trunc);
+	if(!mFile.is_open())
+		return false;
+
+	FrameRecordingHeader header;
+	header.FrameByteSize = sizeof(RecordedFrame);
+	mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	mFrameCount = 0;
+	return (bool)mFile;
+}
+
+void FrameRecorder::Write(const RecordedFrame& frame)
+{
+	mFile.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+	++mFrameCount;
+}
+
+void FrameRecorder::Close()
+{
+	if(!mFile.is_open())
+		return;
+
+	FrameRecordingHeader header;
+	header.FrameByteSize = sizeof(RecordedFrame);
+	header.FrameCount = mFrameCount;
+
+	mFile.seekp(0);
+	mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	mFile.close();
+}
+
+bool FrameReplay::Open(const std::string& path)
+{
+	mFrames.clear();
+	mNext = 0;
+	mOpen = false;
+
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	if(!file.is_open())
+		return false;
+
+	std::uint64_t fileSize = (std::uint64_t)file.tellg();
+	file.seekg(0);
+
+	FrameRecordingHeader header;
+	if(fileSize < sizeof(header) || !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+		return false;
+
+	if(header.Magic != FrameRecording::Magic ||
+	   header.Version != FrameRecording::Version ||
+	   header.FrameByteSize != sizeof(RecordedFrame))
+		return false;
+
+	// A recording that was never closed has a count of 0; use what is in the file.
+	std::uint64_t framesInFile = (fileSize - sizeof(header)) / sizeof(RecordedFrame);
+	std::uint64_t frameCount = header.FrameCount != 0 ?
+		std::min<std::uint64_t>(header.FrameCount, framesInFile) : framesInFile;
+
+	mFrames.resize((size_t)frameCount);
+	if(frameCount > 0 && !file.read(reinterpret_cast<char*>(mFrames.data()), frameCount * sizeof(RecordedFrame)))
+		return false;
+
+	mOpen = true;
+	return true;
+}
+
+bool FrameReplay::Next(RecordedFrame& frame)
+{
+	if(Finished())
+		return false;
+
+	frame = mFrames[mNext++];
+	return true;
+}
@@ -0,0 +1,104 @@
+//***************************************************************************************
+// FrameRecording.h
+//
+// Record and replay of everything that makes one run differ from the next: each
+// frame's delta time, the input state polled that frame and the seed the C runtime
+// RNG was reset to.  Replaying a recording feeds the same values back in the same
+// order, so two builds can be compared over an identical frame sequence.
+//
+// File layout (*.rec, little endian):
+//
+//   FrameRecordingHeader
+//   RecordedFrame[FrameCount]
+//
+// FrameCount is written when the recorder is closed; a recording cut short (e.g. by
+// a crash) still replays up to its last complete frame.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+namespace FrameRecording
+{
+	const std::uint32_t Magic = 0x43455246; // 'FREC'
+	const std::uint32_t Version = 1;
+
+	// Bits of RecordedFrame::Keys.
+	const std::uint32_t KeyForward = 1 << 0;
+	const std::uint32_t KeyBackward = 1 << 1;
+	const std::uint32_t KeyLeft = 1 << 2;
+	const std::uint32_t KeyRight = 1 << 3;
+	const std::uint32_t KeyFast = 1 << 4;
+}
+
+struct FrameRecordingHeader
+{
+	std::uint32_t Magic = FrameRecording::Magic;
+	std::uint32_t Version = FrameRecording::Version;
+	std::uint32_t FrameByteSize = 0;
+	std::uint32_t FrameCount = 0;
+};
+
+struct RecordedFrame
+{
+	float DeltaTime = 0.0f;
+	std::uint32_t Keys = 0;
+
+	// Camera rotation from mouse drags this frame, in radians.
+	float Pitch = 0.0f;
+	float Yaw = 0.0f;
+
+	// Seed passed to srand at the start of the frame.
+	std::uint32_t Seed = 0;
+};
+
+class FrameRecorder
+{
+public:
+	FrameRecorder() = default;
+	FrameRecorder(const FrameRecorder& rhs) = delete;
+	FrameRecorder& operator=(const FrameRecorder& rhs) = delete;
+	~FrameRecorder();
+
+	bool Open(const std::string& path);
+	void Write(const RecordedFrame& frame);
+
+	///<summary>
+	/// Writes the frame count into the header and closes the file.
+	///</summary>
+	void Close();
+
+	bool IsOpen()const { return mFile.is_open(); }
+	UINT FrameCount()const { return mFrameCount; }
+
+private:
+	std::ofstream mFile;
+	UINT mFrameCount = 0;
+};
+
+class FrameReplay
+{
+public:
+	///<summary>
+	/// Loads a recording.  Returns false if the file is missing or was written by an
+	/// incompatible version.
+	///</summary>
+	bool Open(const std::string& path);
+
+	///<summary>
+	/// Copies the next frame to frame and returns true, or returns false once every
+	/// frame has been replayed.
+	///</summary>
+	bool Next(RecordedFrame& frame);
+
+	bool IsOpen()const { return mOpen; }
+	bool Finished()const { return mNext >= (UINT)mFrames.size(); }
+	UINT FrameCount()const { return (UINT)mFrames.size(); }
+	UINT FramesReplayed()const { return mNext; }
+
+private:
+	std::vector<RecordedFrame> mFrames;
+	UINT mNext = 0;
+	bool mOpen = false;
+};
@@ -0,0 +1,189 @@
+//***************************************************************************************
+// FrameStats.cpp
+//***************************************************************************************
+
+#include "FrameStats.h"
+#include <intrin.h>
+#include <cmath>
+#include <iomanip>
+
+FrameTimeHistogram::FrameTimeHistogram()
+{
+	Reset();
+}
+
+void FrameTimeHistogram::Record(std::uint64_t microseconds)
+{
+	std::uint32_t value = (std::uint32_t)std::min<std::uint64_t>(microseconds, 0xFFFFFFFFu);
+
+	mBuckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	mCount.fetch_add(1, std::memory_order_relaxed);
+	mTotal.fetch_add(value, std::memory_order_relaxed);
+
+	// Only the recording thread writes, so no compare-exchange loop is needed.
+	if(value > mMax.load(std::memory_order_relaxed))
+		mMax.store(value, std::memory_order_relaxed);
+}
+
+void FrameTimeHistogram::Reset()
+{
+	for(auto& bucket : mBuckets)
+		bucket.store(0, std::memory_order_relaxed);
+
+	mCount.store(0, std::memory_order_relaxed);
+	mTotal.store(0, std::memory_order_relaxed);
+	mMax.store(0, std::memory_order_relaxed);
+}
+
+void FrameTimeHistogram::Merge(const FrameTimeHistogram& other)
+{
+	for(UINT i = 0; i < BucketCount; ++i)
+		mBuckets[i].fetch_add(other.mBuckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	mCount.fetch_add(other.Count(), std::memory_order_relaxed);
+	mTotal.fetch_add(other.mTotal.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+	if(other.Max() > Max())
+		mMax.store(other.Max(), std::memory_order_relaxed);
+}
+
+double FrameTimeHistogram::Mean()const
+{
+	std::uint64_t count = Count();
+	return count > 0 ? (double)mTotal.load(std::memory_order_relaxed) / (double)count : 0.0;
+}
+
+std::uint64_t FrameTimeHistogram::ValueAtPercentile(double percentile)const
+{
+	std::uint64_t count = Count();
+	if(count == 0)
+		return 0;
+
+	percentile = std::min<double>(std::max<double>(percentile, 0.0), 100.0);
+	std::uint64_t target = std::max<std::uint64_t>(1, (std::uint64_t)std::ceil(percentile / 100.0 * (double)count));
+
+	std::uint64_t seen = 0;
+	for(UINT i = 0; i < BucketCount; ++i)
+	{
+		seen += mBuckets[i].load(std::memory_order_relaxed);
+		if(seen >= target)
+			return std::min<std::uint64_t>(BucketHighestValue(i), Max());
+	}
+
+	return Max();
+}
+
+UINT FrameTimeHistogram::BucketIndex(std::uint32_t value)
+{
+	if(value < SubBucketCount)
+		return value;
+
+	unsigned long msb;
+	_BitScanReverse(&msb, value);
+
+	// The SubBucketBits bits below the leading one pick the bucket within its
+	// power of two.
+	UINT shift = (UINT)msb - SubBucketBits;
+	UINT subBucket = (value >> shift) - SubBucketCount;
+	return SubBucketCount + shift * SubBucketCount + subBucket;
+}
+
+std::uint64_t FrameTimeHistogram::BucketHighestValue(UINT index)
+{
+	if(index < SubBucketCount)
+		return index;
+
+	UINT shift = (index - SubBucketCount) / SubBucketCount;
+	UINT subBucket = (index - SubBucketCount) % SubBucketCount;
+	std::uint64_t lowest = (std::uint64_t)(SubBucketCount + subBucket) << shift;
+	return lowest + ((std::uint64_t)1 << shift) - 1;
+}
+
+FrameStats::FrameStats(float windowSeconds) :
+	mWindowSeconds(windowSeconds)
+{
+}
+
+FrameStats::~FrameStats()
+{
+	StopCsv();
+}
+
+bool FrameStats::AddFrame(float totalTime, float frameSeconds)
+{
+	std::uint64_t microseconds = (std::uint64_t)(std::max<float>(frameSeconds, 0.0f) * 1e6f + 0.5f);
+	mSubWindows[mSubWindow].Record(microseconds);
+	mOverall.Record(microseconds);
+
+	if(mCsv.is_open())
+		mCsv << mFrameNumber << ',' << totalTime << ',' << frameSeconds * 1000.0f << '\n';
+	++mFrameNumber;
+
+	float elapsed = totalTime - mSubWindowStart;
+	if(elapsed < mWindowSeconds / SubWindowCount)
+		return false;
+
+	mSubWindowSeconds[mSubWindow] = elapsed;
+
+	// The report covers the last SubWindowCount sub-windows (fewer at startup).
+	mWindow.Reset();
+	float windowSeconds = 0.0f;
+	for(UINT i = 0; i < SubWindowCount; ++i)
+	{
+		mWindow.Merge(mSubWindows[i]);
+		windowSeconds += mSubWindowSeconds[i];
+	}
+	mLastReport = Summarize(mWindow, windowSeconds);
+
+	// The oldest sub-window drops out of the window and is refilled next.
+	mSubWindow = (mSubWindow + 1) % SubWindowCount;
+	mSubWindows[mSubWindow].Reset();
+	mSubWindowSeconds[mSubWindow] = 0.0f;
+	mSubWindowStart = totalTime;
+	return true;
+}
+
+FrameStatsReport FrameStats::OverallReport(float totalTime)const
+{
+	return Summarize(mOverall, totalTime - mOverallStart);
+}
+
+void FrameStats::ResetOverall(float totalTime)
+{
+	mOverall.Reset();
+	mOverallStart = totalTime;
+}
+
+bool FrameStats::StartCsv(const std::string& path)
+{
+	StopCsv();
+
+	mCsv.open(path);
+	if(!mCsv.is_open())
+		return false;
+
+	mCsv << std::fixed << std::setprecision(4);
+	mCsv << "frame,time_s,frame_ms\n";
+	return true;
+}
+
+void FrameStats::StopCsv()
+{
+	if(mCsv.is_open())
+		mCsv.close();
+}
+
+FrameStatsReport FrameStats::Summarize(const FrameTimeHistogram& histogram, float seconds)
+{
+	FrameStatsReport report;
+	report.WindowSeconds = seconds;
+	report.Frames = histogram.Count();
+	report.Fps = seconds > 0.0f ? (float)report.Frames / seconds : 0.0f;
+	report.MeanMs = (float)(histogram.Mean() / 1000.0);
+	report.P50Ms = histogram.ValueAtPercentile(50.0) / 1000.0f;
+	report.P90Ms = histogram.ValueAtPercentile(90.0) / 1000.0f;
+	report.P99Ms = histogram.ValueAtPercentile(99.0) / 1000.0f;
+	report.P999Ms = histogram.ValueAtPercentile(99.9) / 1000.0f;
+	report.MaxMs = histogram.Max() / 1000.0f;
+	return report;
+}
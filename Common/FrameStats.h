@@ -0,0 +1,138 @@
+//***************************************************************************************
+// FrameStats.h
+//
+// Frame time statistics that keep the tail visible.
+//
+// FrameTimeHistogram is a log-linear (HDR histogram style) histogram of frame times
+// in microseconds: values below 2^SubBucketBits get a bucket each, and every power of
+// two above that is split into 2^SubBucketBits buckets, so any value is stored with
+// under 1/2^SubBucketBits (about 3%) relative error in a fixed 3.5KB.  Counts are
+// atomics written by one thread, so other threads may read percentiles while frames
+// are being added.
+//
+// FrameStats reports over a rolling window: frames go into a ring of SubWindowCount
+// histograms, each covering 1/SubWindowCount of the window, and every time one
+// fills the ring is merged into a report of the last full window.  The report is
+// thus refreshed several times per window without the tail of the previous window
+// being dropped at a boundary.  FrameStats also keeps a histogram of the whole run
+// and can log every frame time to a CSV file.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include <atomic>
+
+class FrameTimeHistogram
+{
+public:
+	static const UINT SubBucketBits = 5;
+	static const UINT SubBucketCount = 1 << SubBucketBits;
+
+	// Values above 2^32-1 microseconds (over an hour) are clamped.
+	static const UINT BucketCount = SubBucketCount + (32 - SubBucketBits) * SubBucketCount;
+
+	FrameTimeHistogram();
+	FrameTimeHistogram(const FrameTimeHistogram& rhs) = delete;
+	FrameTimeHistogram& operator=(const FrameTimeHistogram& rhs) = delete;
+
+	void Record(std::uint64_t microseconds);
+	void Reset();
+
+	// Adds every value recorded in other.
+	void Merge(const FrameTimeHistogram& other);
+
+	std::uint64_t Count()const { return mCount.load(std::memory_order_relaxed); }
+	std::uint64_t Max()const { return mMax.load(std::memory_order_relaxed); }
+	double Mean()const;
+
+	///<summary>
+	/// Smallest recorded value v such that percentile% of the values are <= v, up to
+	/// the histogram's precision.  Returns 0 when empty.
+	///</summary>
+	std::uint64_t ValueAtPercentile(double percentile)const;
+
+private:
+	static UINT BucketIndex(std::uint32_t value);
+	static std::uint64_t BucketHighestValue(UINT index);
+
+private:
+	std::atomic<std::uint32_t> mBuckets[BucketCount];
+	std::atomic<std::uint64_t> mCount;
+	std::atomic<std::uint64_t> mTotal;
+	std::atomic<std::uint64_t> mMax;
+};
+
+// Summary of one reporting window.  Times are in milliseconds.
+struct FrameStatsReport
+{
+	float WindowSeconds = 0.0f;
+	std::uint64_t Frames = 0;
+	float Fps = 0.0f;
+	float MeanMs = 0.0f;
+	float P50Ms = 0.0f;
+	float P90Ms = 0.0f;
+	float P99Ms = 0.0f;
+	float P999Ms = 0.0f;
+	float MaxMs = 0.0f;
+};
+
+class FrameStats
+{
+public:
+	// Sub-windows the rolling window is split into; also how many reports it yields.
+	static const UINT SubWindowCount = 4;
+
+	explicit FrameStats(float windowSeconds = 1.0f);
+	~FrameStats();
+
+	///<summary>
+	/// Sets the reporting window length.  Takes effect when the current sub-window
+	/// closes.
+	///</summary>
+	void SetWindow(float seconds) { mWindowSeconds = seconds; }
+
+	///<summary>
+	/// Adds a frame that took frameSeconds, ending at totalTime seconds.  Returns true
+	/// when this frame closed a sub-window; LastReport() then summarizes the window
+	/// that ends there.
+	///</summary>
+	bool AddFrame(float totalTime, float frameSeconds);
+
+	const FrameStatsReport& LastReport()const { return mLastReport; }
+
+	// Every frame since the start, or since ResetOverall was called at totalTime.
+	const FrameTimeHistogram& Overall()const { return mOverall; }
+	FrameStatsReport OverallReport(float totalTime)const;
+	void ResetOverall(float totalTime);
+
+	///<summary>
+	/// Starts writing one "frame,time_s,frame_ms" row per frame to path.  Returns
+	/// false if the file cannot be opened.
+	///</summary>
+	bool StartCsv(const std::string& path);
+	void StopCsv();
+	bool CsvActive()const { return mCsv.is_open(); }
+
+private:
+	static FrameStatsReport Summarize(const FrameTimeHistogram& histogram, float seconds);
+
+private:
+	float mWindowSeconds;
+	float mSubWindowStart = 0.0f;
+	float mOverallStart = 0.0f;
+
+	// Ring of the window's sub-windows and how long each lasted; mSubWindow is the
+	// one being filled.
+	FrameTimeHistogram mSubWindows[SubWindowCount];
+	float mSubWindowSeconds[SubWindowCount] = {};
+	UINT mSubWindow = 0;
+
+	// Scratch for merging the ring into a report.
+	FrameTimeHistogram mWindow;
+	FrameTimeHistogram mOverall;
+	FrameStatsReport mLastReport;
+
+	std::uint64_t mFrameNumber = 0;
+	std::ofstream mCsv;
+};
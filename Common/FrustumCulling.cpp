@@ -0,0 +1,187 @@
+//***************************************************************************************
+// FrustumCulling.cpp
+//***************************************************************************************
+
+#include "FrustumCulling.h"
+
+using namespace DirectX;
+
+namespace
+{
+	UINT PaddedCount(UINT count)
+	{
+		return (count + AabbList::BatchSize - 1) & ~(AabbList::BatchSize - 1);
+	}
+
+	XMVECTOR LoadLanes(const float* p)
+	{
+		return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(p));
+	}
+}
+
+void AabbList::Clear()
+{
+	mCount = 0;
+	mCenterX.clear();
+	mCenterY.clear();
+	mCenterZ.clear();
+	mExtentX.clear();
+	mExtentY.clear();
+	mExtentZ.clear();
+}
+
+void AabbList::Reserve(UINT count)
+{
+	UINT padded = PaddedCount(count);
+	mCenterX.reserve(padded);
+	mCenterY.reserve(padded);
+	mCenterZ.reserve(padded);
+	mExtentX.reserve(padded);
+	mExtentY.reserve(padded);
+	mExtentZ.reserve(padded);
+}
+
+UINT AabbList::Add(const BoundingBox& box)
+{
+	UINT i = mCount++;
+
+	// Grow a whole batch at a time.  The padding lanes are zero sized boxes at the
+	// origin; Cull never reports them.
+	UINT padded = PaddedCount(mCount);
+	if(padded > (UINT)mCenterX.size())
+	{
+		mCenterX.resize(padded, 0.0f);
+		mCenterY.resize(padded, 0.0f);
+		mCenterZ.resize(padded, 0.0f);
+		mExtentX.resize(padded, 0.0f);
+		mExtentY.resize(padded, 0.0f);
+		mExtentZ.resize(padded, 0.0f);
+	}
+
+	Set(i, box);
+	return i;
+}
+
+void AabbList::RemoveLast()
+{
+	assert(mCount > 0);
+
+	Set(mCount - 1, BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 0.0f, 0.0f)));
+	--mCount;
+}
+
+void AabbList::Set(UINT i, const BoundingBox& box)
+{
+	assert(i < mCount);
+
+	mCenterX[i] = box.Center.x;
+	mCenterY[i] = box.Center.y;
+	mCenterZ[i] = box.Center.z;
+	mExtentX[i] = box.Extents.x;
+	mExtentY[i] = box.Extents.y;
+	mExtentZ[i] = box.Extents.z;
+}
+
+BoundingBox AabbList::Get(UINT i)const
+{
+	assert(i < mCount);
+
+	return BoundingBox(
+		XMFLOAT3(mCenterX[i], mCenterY[i], mCenterZ[i]),
+		XMFLOAT3(mExtentX[i], mExtentY[i], mExtentZ[i]));
+}
+
+void FrustumCulling::ExtractPlanes(FXMMATRIX viewProj, XMFLOAT4 planes[6])
+{
+	// With row vectors, clip = p * M, so each clip coordinate is p dotted with a
+	// column of M.  Inside means -w <= x <= w, -w <= y <= w and 0 <= z <= w.
+	XMMATRIX columns = XMMatrixTranspose(viewProj);
+	XMVECTOR x = columns.r[0];
+	XMVECTOR y = columns.r[1];
+	XMVECTOR z = columns.r[2];
+	XMVECTOR w = columns.r[3];
+
+	XMVECTOR p[6] =
+	{
+		XMVectorAdd(w, x),      // left
+		XMVectorSubtract(w, x), // right
+		XMVectorAdd(w, y),      // bottom
+		XMVectorSubtract(w, y), // top
+		z,                      // near
+		XMVectorSubtract(w, z)  // far
+	};
+
+	for(int i = 0; i < 6; ++i)
+		XMStoreFloat4(&planes[i], XMPlaneNormalize(p[i]));
+}
+
+void FrustumCulling::Cull(const XMFLOAT4 planes[6], const AabbList& boxes, std::vector<UINT>& visible)
+{
+	visible.clear();
+
+	// Splat every plane once.  The absolute normal gives the box's projected
+	// radius onto the plane normal: r = |n.x|*e.x + |n.y|*e.y + |n.z|*e.z.
+	XMVECTOR nx[6], ny[6], nz[6], nd[6];
+	XMVECTOR ax[6], ay[6], az[6];
+	for(int p = 0; p < 6; ++p)
+	{
+		nx[p] = XMVectorReplicate(planes[p].x);
+		ny[p] = XMVectorReplicate(planes[p].y);
+		nz[p] = XMVectorReplicate(planes[p].z);
+		nd[p] = XMVectorReplicate(planes[p].w);
+		ax[p] = XMVectorAbs(nx[p]);
+		ay[p] = XMVectorAbs(ny[p]);
+		az[p] = XMVectorAbs(nz[p]);
+	}
+
+	const float* cx = boxes.CenterX();
+	const float* cy = boxes.CenterY();
+	const float* cz = boxes.CenterZ();
+	const float* ex = boxes.ExtentX();
+	const float* ey = boxes.ExtentY();
+	const float* ez = boxes.ExtentZ();
+
+	const UINT count = boxes.Count();
+	const XMVECTOR zero = XMVectorZero();
+
+	for(UINT base = 0; base < count; base += AabbList::BatchSize)
+	{
+		// Lanes 0-3 and 4-7 of the batch.
+		XMVECTOR cx0 = LoadLanes(cx + base), cx1 = LoadLanes(cx + base + 4);
+		XMVECTOR cy0 = LoadLanes(cy + base), cy1 = LoadLanes(cy + base + 4);
+		XMVECTOR cz0 = LoadLanes(cz + base), cz1 = LoadLanes(cz + base + 4);
+		XMVECTOR ex0 = LoadLanes(ex + base), ex1 = LoadLanes(ex + base + 4);
+		XMVECTOR ey0 = LoadLanes(ey + base), ey1 = LoadLanes(ey + base + 4);
+		XMVECTOR ez0 = LoadLanes(ez + base), ez1 = LoadLanes(ez + base + 4);
+
+		XMVECTOR outside0 = XMVectorFalseInt();
+		XMVECTOR outside1 = XMVectorFalseInt();
+
+		for(int p = 0; p < 6; ++p)
+		{
+			// Signed distance of the center plus the projected radius: the box is
+			// fully outside this plane when even its corner furthest along the
+			// normal is behind it.
+			XMVECTOR d0 = XMVectorMultiplyAdd(nx[p], cx0, XMVectorMultiplyAdd(ny[p], cy0, XMVectorMultiplyAdd(nz[p], cz0, nd[p])));
+			XMVECTOR d1 = XMVectorMultiplyAdd(nx[p], cx1, XMVectorMultiplyAdd(ny[p], cy1, XMVectorMultiplyAdd(nz[p], cz1, nd[p])));
+
+			XMVECTOR r0 = XMVectorMultiplyAdd(ax[p], ex0, XMVectorMultiplyAdd(ay[p], ey0, XMVectorMultiply(az[p], ez0)));
+			XMVECTOR r1 = XMVectorMultiplyAdd(ax[p], ex1, XMVectorMultiplyAdd(ay[p], ey1, XMVectorMultiply(az[p], ez1)));
+
+			outside0 = XMVectorOrInt(outside0, XMVectorLess(XMVectorAdd(d0, r0), zero));
+			outside1 = XMVectorOrInt(outside1, XMVectorLess(XMVectorAdd(d1, r1), zero));
+		}
+
+		// All four lanes of each mask; XMStoreInt would only write the first.
+		alignas(16) std::uint32_t lanes[AabbList::BatchSize];
+		XMStoreInt4A(&lanes[0], outside0);
+		XMStoreInt4A(&lanes[4], outside1);
+
+		const UINT batchCount = std::min<UINT>(AabbList::BatchSize, count - base);
+		for(UINT lane = 0; lane < batchCount; ++lane)
+		{
+			if(lanes[lane] == 0)
+				visible.push_back(base + lane);
+		}
+	}
+}
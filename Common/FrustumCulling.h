@@ -0,0 +1,70 @@
+//***************************************************************************************
+// FrustumCulling.h
+//
+// Batched view frustum culling of world space axis aligned boxes.  The boxes are
+// stored as a structure of arrays (one array per center/extent component), padded
+// to a multiple of eight, and tested against the six frustum planes eight boxes at
+// a time as two 4-wide DirectXMath vectors.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class AabbList
+{
+public:
+	static const UINT BatchSize = 8;
+
+	void Clear();
+	void Reserve(UINT count);
+
+	///<summary>
+	/// Appends a box and returns its index.
+	///</summary>
+	UINT Add(const DirectX::BoundingBox& box);
+
+	///<summary>
+	/// Drops the last box; its lane becomes padding again.
+	///</summary>
+	void RemoveLast();
+
+	void Set(UINT i, const DirectX::BoundingBox& box);
+	DirectX::BoundingBox Get(UINT i)const;
+
+	UINT Count()const { return mCount; }
+
+	// Component arrays, each at least Count() rounded up to BatchSize long.
+	const float* CenterX()const { return mCenterX.data(); }
+	const float* CenterY()const { return mCenterY.data(); }
+	const float* CenterZ()const { return mCenterZ.data(); }
+	const float* ExtentX()const { return mExtentX.data(); }
+	const float* ExtentY()const { return mExtentY.data(); }
+	const float* ExtentZ()const { return mExtentZ.data(); }
+
+private:
+	UINT mCount = 0;
+	std::vector<float> mCenterX;
+	std::vector<float> mCenterY;
+	std::vector<float> mCenterZ;
+	std::vector<float> mExtentX;
+	std::vector<float> mExtentY;
+	std::vector<float> mExtentZ;
+};
+
+namespace FrustumCulling
+{
+	///<summary>
+	/// Extracts the six planes (left, right, bottom, top, near, far) of the frustum
+	/// described by a view-projection matrix.  Each plane is (a, b, c, d) with a
+	/// unit length normal pointing into the frustum, so a point p is inside when
+	/// a*p.x + b*p.y + c*p.z + d >= 0 for every plane.
+	///</summary>
+	void ExtractPlanes(DirectX::FXMMATRIX viewProj, DirectX::XMFLOAT4 planes[6]);
+
+	///<summary>
+	/// Replaces visible with the indices, in increasing order, of the boxes that are
+	/// inside or intersect the frustum.  Boxes that straddle a plane are kept.
+	///</summary>
+	void Cull(const DirectX::XMFLOAT4 planes[6], const AabbList& boxes, std::vector<UINT>& visible);
+}
@@ -125,6 +125,21 @@ void GameTimer::Tick()
 	}
 }
 
+void GameTimer::Tick(double deltaTime)
+{
+	if( mStopped )
+	{
+		mDeltaTime = 0.0;
+		return;
+	}
+
+	mCurrTime = mPrevTime + (__int64)(deltaTime / mSecondsPerCount + 0.5);
+	mDeltaTime = deltaTime < 0.0 ? 0.0 : deltaTime;
+
+	// Prepare for next frame.
+	mPrevTime = mCurrTime;
+}
+
 
 
 
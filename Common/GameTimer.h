@@ -18,6 +18,11 @@ public:
 	void Stop();  // Call when paused.
 	void Tick();  // Call every frame.
 
+	// Advances the clock by exactly deltaTime seconds instead of reading the
+	// performance counter, e.g. to replay recorded frame times.  Use for a whole
+	// run; mixing it with Tick() makes the next real delta jump.
+	void Tick(double deltaTime);
+
 private:
 	double mSecondsPerCount;
 	double mDeltaTime;
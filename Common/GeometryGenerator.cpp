@@ -3,93 +3,45 @@
 //***************************************************************************************
 
 #include "GeometryGenerator.h"
+#include "PrimitiveTables.h"
 #include <algorithm>
+#include <iterator>
+#include <ppl.h>
 
 using namespace DirectX;
 
-GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float height, float depth, uint32 numSubdivisions)
+namespace
 {
-	MeshData meshData;
-
-	//
-	// Create the vertices.
-	//
-
-	Vertex v[24];
-
-	float w2 = 0.5f * width;
-	float h2 = 0.5f * height;
-	float d2 = 0.5f * depth;
-
-	// Fill in the front face vertex data.
-	v[0] = Vertex(-w2, -h2, -d2, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-	v[1] = Vertex(-w2, +h2, -d2, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	v[2] = Vertex(+w2, +h2, -d2, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-	v[3] = Vertex(+w2, -h2, -d2, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f);
-
-	// Fill in the back face vertex data.
-	v[4] = Vertex(-w2, -h2, +d2, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f);
-	v[5] = Vertex(+w2, -h2, +d2, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-	v[6] = Vertex(+w2, +h2, +d2, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	v[7] = Vertex(-w2, +h2, +d2, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-
-	// Fill in the top face vertex data.
-	v[8] = Vertex(-w2, +h2, -d2, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-	v[9] = Vertex(-w2, +h2, +d2, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	v[10] = Vertex(+w2, +h2, +d2, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-	v[11] = Vertex(+w2, +h2, -d2, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f);
-
-	// Fill in the bottom face vertex data.
-	v[12] = Vertex(-w2, -h2, -d2, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f);
-	v[13] = Vertex(+w2, -h2, -d2, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-	v[14] = Vertex(+w2, -h2, +d2, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	v[15] = Vertex(-w2, -h2, +d2, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-
-	// Fill in the left face vertex data.
-	v[16] = Vertex(-w2, -h2, +d2, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f);
-	v[17] = Vertex(-w2, +h2, +d2, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f);
-	v[18] = Vertex(-w2, +h2, -d2, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f);
-	v[19] = Vertex(-w2, -h2, -d2, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f);
-
-	// Fill in the right face vertex data.
-	v[20] = Vertex(+w2, -h2, -d2, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f);
-	v[21] = Vertex(+w2, +h2, -d2, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
-	v[22] = Vertex(+w2, +h2, +d2, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f);
-	v[23] = Vertex(+w2, -h2, +d2, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
-
-	meshData.Vertices.assign(&v[0], &v[24]);
-
-	//
-	// Create the indices.
-	//
-
-	uint32 i[36];
-
-	// Fill in the front face index data
-	i[0] = 0; i[1] = 1; i[2] = 2;
-	i[3] = 0; i[4] = 2; i[5] = 3;
-
-	// Fill in the back face index data
-	i[6] = 4; i[7] = 5; i[8] = 6;
-	i[9] = 4; i[10] = 6; i[11] = 7;
-
-	// Fill in the top face index data
-	i[12] = 8; i[13] = 9; i[14] = 10;
-	i[15] = 8; i[16] = 10; i[17] = 11;
+	// Builds a MeshData from a unit space table; only the positions are touched.
+	template<std::size_t VertexCount, std::size_t IndexCount>
+	GeometryGenerator::MeshData ScaledPrimitive(
+		const PrimitiveTables::Table<VertexCount, IndexCount>& table,
+		float sx, float sy, float sz)
+	{
+		GeometryGenerator::MeshData meshData;
+		meshData.Vertices.resize(VertexCount);
+		meshData.Indices32.assign(std::begin(table.Indices), std::end(table.Indices));
 
-	// Fill in the bottom face index data
-	i[18] = 12; i[19] = 13; i[20] = 14;
-	i[21] = 12; i[22] = 14; i[23] = 15;
+		XMVECTOR scale = XMVectorSet(sx, sy, sz, 0.0f);
+		for(std::size_t i = 0; i < VertexCount; ++i)
+		{
+			const PrimitiveTables::Vertex& src = table.Vertices[i];
+			GeometryGenerator::Vertex& dst = meshData.Vertices[i];
 
-	// Fill in the left face index data
-	i[24] = 16; i[25] = 17; i[26] = 18;
-	i[27] = 16; i[28] = 18; i[29] = 19;
+			XMStoreFloat3(&dst.Position, XMVectorMultiply(XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(src.Position)), scale));
+			dst.Normal = XMFLOAT3(src.Normal);
+			dst.TangentU = XMFLOAT3(src.TangentU);
+			dst.TexC = XMFLOAT2(src.TexC);
+		}
 
-	// Fill in the right face index data
-	i[30] = 20; i[31] = 21; i[32] = 22;
-	i[33] = 20; i[34] = 22; i[35] = 23;
+		return meshData;
+	}
+}
 
-	meshData.Indices32.assign(&i[0], &i[36]);
+GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float height, float depth, uint32 numSubdivisions)
+{
+	// The unsubdivided box is a compile time table; only the scale happens here.
+	MeshData meshData = ScaledPrimitive(PrimitiveTables::UnitBox, width, height, depth);
 
 	// Put a cap on the number of subdivisions.
 	numSubdivisions = std::min<uint32>(numSubdivisions, 6u);
@@ -101,95 +53,8 @@ GeometryGenerator::MeshData GeometryGenerator::CreateBox(float width, float heig
 }
 GeometryGenerator::MeshData GeometryGenerator::CreateDoor(float width, float height, float depth, uint32 numSubdivisions)
 {
-	MeshData meshData;
-
-	//
-	// Create the vertices.
-	//
-
-	Vertex v[24];
-
-	float w2 = 0.5f * width;
-	float h2 = 0.5f * height;
-	float d2 = 0.5f * depth;
-
-	// Fill in the front face vertex data.
-	v[0] = Vertex(-w2, -h2, -d2, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-	v[1] = Vertex(-w2, +h2, -d2, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	v[2] = Vertex(+w2, +h2, -d2, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-	v[3] = Vertex(+w2, -h2, -d2, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f);
-
-	// Fill in the back face vertex data.
-	v[4] = Vertex(-w2, -h2, +d2, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f);
-	v[5] = Vertex(+w2, -h2, +d2, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-	v[6] = Vertex(+w2, +h2, +d2, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	v[7] = Vertex(-w2, +h2, +d2, 0.0f, 0.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-
-	// Fill in the top face vertex data.
-	v[8] = Vertex(-w2, +h2, -d2, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-	v[9] = Vertex(-w2, +h2, +d2, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	v[10] = Vertex(+w2, +h2, +d2, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-	v[11] = Vertex(+w2, +h2, -d2, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f);
-
-	// Fill in the bottom face vertex data.
-	v[12] = Vertex(-w2, -h2, -d2, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f);
-	v[13] = Vertex(+w2, -h2, -d2, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
-	v[14] = Vertex(+w2, -h2, +d2, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
-	v[15] = Vertex(-w2, -h2, +d2, 0.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f);
-
-	// Fill in the left face vertex data.
-	v[16] = Vertex(-w2, -h2, +d2, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f);
-	v[17] = Vertex(-w2, +h2, +d2, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f);
-	v[18] = Vertex(-w2, +h2, -d2, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f);
-	v[19] = Vertex(-w2, -h2, -d2, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f);
-
-	// Fill in the right face vertex data.
-	v[20] = Vertex(+w2, -h2, -d2, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f);
-	v[21] = Vertex(+w2, +h2, -d2, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
-	v[22] = Vertex(+w2, +h2, +d2, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f);
-	v[23] = Vertex(+w2, -h2, +d2, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
-
-	meshData.Vertices.assign(&v[0], &v[24]);
-
-	//
-	// Create the indices.
-	//
-
-	uint32 i[36];
-
-	// Fill in the front face index data
-	i[0] = 0; i[1] = 1; i[2] = 2;
-	i[3] = 0; i[4] = 2; i[5] = 3;
-
-	// Fill in the back face index data
-	i[6] = 4; i[7] = 5; i[8] = 6;
-	i[9] = 4; i[10] = 6; i[11] = 7;
-
-	// Fill in the top face index data
-	i[12] = 8; i[13] = 9; i[14] = 10;
-	i[15] = 8; i[16] = 10; i[17] = 11;
-
-	// Fill in the bottom face index data
-	i[18] = 12; i[19] = 13; i[20] = 14;
-	i[21] = 12; i[22] = 14; i[23] = 15;
-
-	// Fill in the left face index data
-	i[24] = 16; i[25] = 17; i[26] = 18;
-	i[27] = 16; i[28] = 18; i[29] = 19;
-
-	// Fill in the right face index data
-	i[30] = 20; i[31] = 21; i[32] = 22;
-	i[33] = 20; i[34] = 22; i[35] = 23;
-
-	meshData.Indices32.assign(&i[0], &i[36]);
-
-	// Put a cap on the number of subdivisions.
-	numSubdivisions = std::min<uint32>(numSubdivisions, 6u);
-
-	for (uint32 i = 0; i < numSubdivisions; ++i)
-		Subdivide(meshData);
-
-	return meshData;
+	// A door is a box; it keeps its own name so door geometry can diverge later.
+	return CreateBox(width, height, depth, numSubdivisions);
 }
 GeometryGenerator::MeshData GeometryGenerator::CreateSphere(float radius, uint32 sliceCount, uint32 stackCount)
 {
@@ -843,75 +708,11 @@ GeometryGenerator::MeshData GeometryGenerator::CreateCone(float bottomRadius, fl
 
 GeometryGenerator::MeshData GeometryGenerator::CreatePyramid(float baseWidth, float height)
 {
-	MeshData meshData;
-
-	// Define the vertices of the pyramid
-	float halfWidth = 0.5f * baseWidth;
-
-	// Base vertices (z = -1, y = -1)
-	meshData.Vertices.push_back(Vertex(-halfWidth, -0.5f * height, -halfWidth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f)); // 0
-	meshData.Vertices.push_back(Vertex(+halfWidth, -0.5f * height, -halfWidth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f)); // 1
-	meshData.Vertices.push_back(Vertex(+halfWidth, -0.5f * height, +halfWidth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f)); // 2
-	meshData.Vertices.push_back(Vertex(-halfWidth, -0.5f * height, +halfWidth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f)); // 3
-
-	// Apex vertex (y = 0.5 * height)
-	meshData.Vertices.push_back(Vertex(0.0f, 0.5f * height, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.5f)); // 4
-
-	
-	meshData.Indices32 = {
-		// Base
-		0, 1, 2,
-		0, 2, 3,
-
-		// Sides
-		0, 4, 1,
-		1, 4, 2,
-		2, 4, 3,
-		3, 4, 0
-	};
-
-	return meshData;
+	return ScaledPrimitive(PrimitiveTables::UnitPyramid, baseWidth, height, baseWidth);
 }
 GeometryGenerator::MeshData GeometryGenerator::CreateWedge(float width, float height, float depth)
 {
-	MeshData meshData;
-
-	// vertices of the wedge
-	float halfWidth = 0.5f * width;
-	float halfDepth = 0.5f * depth;
-
-	//  vertices (y = -0.5f * height)
-	meshData.Vertices.push_back(Vertex(-halfWidth, -0.5f * height, -halfDepth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f)); // 0
-	meshData.Vertices.push_back(Vertex(+halfWidth, -0.5f * height, -halfDepth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f)); // 1
-	meshData.Vertices.push_back(Vertex(+halfWidth, -0.5f * height, +halfDepth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f)); // 2
-	meshData.Vertices.push_back(Vertex(-halfWidth, -0.5f * height, +halfDepth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f)); // 3
-
-	// Top vertices (y = 0.5f * height)
-	meshData.Vertices.push_back(Vertex(-halfWidth, 0.5f * height, -halfDepth, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f)); // 4
-	meshData.Vertices.push_back(Vertex(+halfWidth, 0.5f * height, -halfDepth, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f)); // 5
-
-	//indices for the wedge (8 triangles)
-	meshData.Indices32 = {
-		// Base
-		0, 1, 2,
-		0, 2, 3,
-
-		// Front face
-		0, 4, 1,
-		1, 4, 5,
-
-		// Right face
-		1, 5, 2,
-
-		// Back face
-		2, 5, 3,
-		3, 5, 4,
-
-		// Left face
-		3, 4, 0
-	};
-
-	return meshData;
+	return ScaledPrimitive(PrimitiveTables::UnitWedge, width, height, depth);
 }
 GeometryGenerator::MeshData GeometryGenerator::CreateTorus(float radius, float tubeRadius, uint32 sliceCount, uint32 stackCount)
 {
@@ -1022,57 +823,268 @@ GeometryGenerator::MeshData GeometryGenerator::CreateDiamond(float height, float
 }
 GeometryGenerator::MeshData GeometryGenerator::CreateTriangularPrism(float baseWidth, float height, float depth)
 {
-	MeshData meshData;
+	return ScaledPrimitive(PrimitiveTables::UnitTriangularPrism, baseWidth, height, depth);
+}
 
-	// vertices of the triangular prism
-	float halfWidth = baseWidth * 0.5f;
-	float halfDepth = depth * 0.5f;
-
-	// Bottom triangle vertices
-	meshData.Vertices.push_back(Vertex(-halfWidth, -height * 0.5f, -halfDepth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f)); // Bottom-left-back
-	meshData.Vertices.push_back(Vertex(halfWidth, -height * 0.5f, -halfDepth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f));  // Bottom-right-back
-	meshData.Vertices.push_back(Vertex(0.0f, -height * 0.5f, halfDepth, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.0f));       // Bottom-center-front
-
-	// Top triangle vertices
-	meshData.Vertices.push_back(Vertex(-halfWidth, height * 0.5f, -halfDepth, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f));  // Top-left-back
-	meshData.Vertices.push_back(Vertex(halfWidth, height * 0.5f, -halfDepth, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f));   // Top-right-back
-	meshData.Vertices.push_back(Vertex(0.0f, height * 0.5f, halfDepth, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 0.0f));        // Top-center-front
-
-	// Indices for the bottom triangle
-	meshData.Indices32.push_back(0);
-	meshData.Indices32.push_back(1);
-	meshData.Indices32.push_back(2);
-
-	// Indices for the top triangle
-	meshData.Indices32.push_back(3);
-	meshData.Indices32.push_back(5);
-	meshData.Indices32.push_back(4);
-
-	// Indices for the rectangular faces
-	// Face 1: Bottom-left-back to Top-left-back to Top-right-back to Bottom-right-back
-	meshData.Indices32.push_back(0);
-	meshData.Indices32.push_back(3);
-	meshData.Indices32.push_back(4);
-	meshData.Indices32.push_back(0);
-	meshData.Indices32.push_back(4);
-	meshData.Indices32.push_back(1);
-
-	// Face 2: Bottom-right-back to Top-right-back to Top-center-front to Bottom-center-front
-	meshData.Indices32.push_back(1);
-	meshData.Indices32.push_back(4);
-	meshData.Indices32.push_back(5);
-	meshData.Indices32.push_back(1);
-	meshData.Indices32.push_back(5);
-	meshData.Indices32.push_back(2);
-
-	// Face 3: Bottom-center-front to Top-center-front to Top-left-back to Bottom-left-back
-	meshData.Indices32.push_back(2);
-	meshData.Indices32.push_back(5);
-	meshData.Indices32.push_back(3);
-	meshData.Indices32.push_back(2);
-	meshData.Indices32.push_back(3);
-	meshData.Indices32.push_back(0);
+namespace
+{
+	// Triangles and vertices are handed to the PPL workers in blocks of this many.
+	const GeometryGenerator::uint32 NormalTangentBlockSize = 4096;
 
-	return meshData;
+	template<typename T>
+	inline T& StreamElement(void* base, GeometryGenerator::uint32 stride, GeometryGenerator::uint32 i)
+	{
+		return *reinterpret_cast<T*>(static_cast<char*>(base) + (size_t)i * stride);
+	}
+
+	template<typename T>
+	inline const T& StreamElement(const void* base, GeometryGenerator::uint32 stride, GeometryGenerator::uint32 i)
+	{
+		return *reinterpret_cast<const T*>(static_cast<const char*>(base) + (size_t)i * stride);
+	}
+
+	template<typename Index>
+	void ComputeNormalsAndTangentsImpl(
+		const GeometryGenerator::VertexStreams& streams,
+		const Index* indices,
+		GeometryGenerator::uint32 indexCount)
+	{
+		using uint32 = GeometryGenerator::uint32;
+
+		const uint32 vertexCount = streams.VertexCount;
+		const uint32 triCount = indexCount / 3;
+		if(vertexCount == 0 || triCount == 0)
+			return;
+
+		const bool computeNormals = !streams.KeepNormals;
+		const bool computeTangents = streams.TexC != nullptr && streams.TangentU != nullptr;
+		if(!computeNormals && !computeTangents)
+			return;
+
+		//
+		// Gather positions and texture coordinates into SoA arrays so the triangle
+		// loop below can fill SIMD registers four triangles at a time.
+		//
+
+		std::vector<float> px(vertexCount), py(vertexCount), pz(vertexCount);
+		std::vector<float> tu(computeTangents ? vertexCount : 0), tv(computeTangents ? vertexCount : 0);
+
+		const uint32 vertexBlockCount = (vertexCount + NormalTangentBlockSize - 1) / NormalTangentBlockSize;
+		concurrency::parallel_for(0u, vertexBlockCount, [&](uint32 block)
+		{
+			uint32 first = block * NormalTangentBlockSize;
+			uint32 last = std::min<uint32>(first + NormalTangentBlockSize, vertexCount);
+			for(uint32 i = first; i < last; ++i)
+			{
+				const XMFLOAT3& p = StreamElement<XMFLOAT3>(streams.Position, streams.PositionStride, i);
+				px[i] = p.x;
+				py[i] = p.y;
+				pz[i] = p.z;
+
+				if(computeTangents)
+				{
+					const XMFLOAT2& t = StreamElement<XMFLOAT2>(streams.TexC, streams.TexCStride, i);
+					tu[i] = t.x;
+					tv[i] = t.y;
+				}
+			}
+		});
+
+		//
+		// Each worker scatter-adds face normals and tangents into its own SoA
+		// accumulator, so there is no contention on shared vertices.  The last
+		// channel counts the triangles touching each vertex, which tells the
+		// unreferenced vertices apart from ones whose sums merely cancel.
+		//
+
+		concurrency::combinable<std::vector<float>> accumulators;
+
+		const uint32 triBlockCount = (triCount + NormalTangentBlockSize - 1) / NormalTangentBlockSize;
+		concurrency::parallel_for(0u, triBlockCount, [&](uint32 block)
+		{
+			std::vector<float>& acc = accumulators.local();
+			if(acc.empty())
+				acc.assign((size_t)vertexCount * 7, 0.0f);
+
+			float* nx = acc.data();
+			float* ny = nx + vertexCount;
+			float* nz = ny + vertexCount;
+			float* tx = nz + vertexCount;
+			float* ty = tx + vertexCount;
+			float* tz = ty + vertexCount;
+			float* refs = tz + vertexCount;
+
+			const XMVECTOR epsilon = XMVectorReplicate(1e-12f);
+
+			uint32 first = block * NormalTangentBlockSize;
+			uint32 last = std::min<uint32>(first + NormalTangentBlockSize, triCount);
+			for(uint32 tri = first; tri < last; tri += 4)
+			{
+				uint32 lanes = std::min<uint32>(4u, last - tri);
+
+				uint32 i0[4], i1[4], i2[4];
+				XMFLOAT4A x0, y0, z0, x1, y1, z1, x2, y2, z2;
+				XMFLOAT4A u0, v0, u1, v1, u2, v2;
+
+				// A partial group repeats its last triangle; the extra lanes are not scattered.
+				for(uint32 lane = 0; lane < 4; ++lane)
+				{
+					uint32 t = tri + std::min<uint32>(lane, lanes - 1);
+					i0[lane] = indices[t * 3 + 0];
+					i1[lane] = indices[t * 3 + 1];
+					i2[lane] = indices[t * 3 + 2];
+
+					(&x0.x)[lane] = px[i0[lane]]; (&y0.x)[lane] = py[i0[lane]]; (&z0.x)[lane] = pz[i0[lane]];
+					(&x1.x)[lane] = px[i1[lane]]; (&y1.x)[lane] = py[i1[lane]]; (&z1.x)[lane] = pz[i1[lane]];
+					(&x2.x)[lane] = px[i2[lane]]; (&y2.x)[lane] = py[i2[lane]]; (&z2.x)[lane] = pz[i2[lane]];
+
+					if(computeTangents)
+					{
+						(&u0.x)[lane] = tu[i0[lane]]; (&v0.x)[lane] = tv[i0[lane]];
+						(&u1.x)[lane] = tu[i1[lane]]; (&v1.x)[lane] = tv[i1[lane]];
+						(&u2.x)[lane] = tu[i2[lane]]; (&v2.x)[lane] = tv[i2[lane]];
+					}
+				}
+
+				XMVECTOR vx0 = XMLoadFloat4A(&x0), vy0 = XMLoadFloat4A(&y0), vz0 = XMLoadFloat4A(&z0);
+				XMVECTOR e1x = XMVectorSubtract(XMLoadFloat4A(&x1), vx0);
+				XMVECTOR e1y = XMVectorSubtract(XMLoadFloat4A(&y1), vy0);
+				XMVECTOR e1z = XMVectorSubtract(XMLoadFloat4A(&z1), vz0);
+				XMVECTOR e2x = XMVectorSubtract(XMLoadFloat4A(&x2), vx0);
+				XMVECTOR e2y = XMVectorSubtract(XMLoadFloat4A(&y2), vy0);
+				XMVECTOR e2z = XMVectorSubtract(XMLoadFloat4A(&z2), vz0);
+
+				// e1 x e2 has length twice the triangle area, which gives the area weighting.
+				XMFLOAT4A fnx, fny, fnz;
+				XMStoreFloat4A(&fnx, XMVectorNegativeMultiplySubtract(e1z, e2y, XMVectorMultiply(e1y, e2z)));
+				XMStoreFloat4A(&fny, XMVectorNegativeMultiplySubtract(e1x, e2z, XMVectorMultiply(e1z, e2x)));
+				XMStoreFloat4A(&fnz, XMVectorNegativeMultiplySubtract(e1y, e2x, XMVectorMultiply(e1x, e2y)));
+
+				XMFLOAT4A ftx, fty, ftz;
+				if(computeTangents)
+				{
+					XMVECTOR vu0 = XMLoadFloat4A(&u0), vv0 = XMLoadFloat4A(&v0);
+					XMVECTOR du1 = XMVectorSubtract(XMLoadFloat4A(&u1), vu0);
+					XMVECTOR dv1 = XMVectorSubtract(XMLoadFloat4A(&v1), vv0);
+					XMVECTOR du2 = XMVectorSubtract(XMLoadFloat4A(&u2), vu0);
+					XMVECTOR dv2 = XMVectorSubtract(XMLoadFloat4A(&v2), vv0);
+
+					// T = (e1*dv2 - e2*dv1) / (du1*dv2 - du2*dv1); triangles with a
+					// degenerate texture mapping contribute nothing.
+					XMVECTOR det = XMVectorNegativeMultiplySubtract(du2, dv1, XMVectorMultiply(du1, dv2));
+					XMVECTOR valid = XMVectorGreater(XMVectorAbs(det), epsilon);
+					XMVECTOR r = XMVectorSelect(XMVectorZero(), XMVectorReciprocal(det), valid);
+
+					XMStoreFloat4A(&ftx, XMVectorMultiply(XMVectorNegativeMultiplySubtract(e2x, dv1, XMVectorMultiply(e1x, dv2)), r));
+					XMStoreFloat4A(&fty, XMVectorMultiply(XMVectorNegativeMultiplySubtract(e2y, dv1, XMVectorMultiply(e1y, dv2)), r));
+					XMStoreFloat4A(&ftz, XMVectorMultiply(XMVectorNegativeMultiplySubtract(e2z, dv1, XMVectorMultiply(e1z, dv2)), r));
+				}
+
+				for(uint32 lane = 0; lane < lanes; ++lane)
+				{
+					const uint32 corners[3] = { i0[lane], i1[lane], i2[lane] };
+					for(uint32 c : corners)
+					{
+						refs[c] += 1.0f;
+						nx[c] += (&fnx.x)[lane];
+						ny[c] += (&fny.x)[lane];
+						nz[c] += (&fnz.x)[lane];
+
+						if(computeTangents)
+						{
+							tx[c] += (&ftx.x)[lane];
+							ty[c] += (&fty.x)[lane];
+							tz[c] += (&ftz.x)[lane];
+						}
+					}
+				}
+			}
+		});
+
+		std::vector<const float*> partials;
+		accumulators.combine_each([&](const std::vector<float>& acc)
+		{
+			partials.push_back(acc.data());
+		});
+
+		//
+		// Reduce the per-worker sums, normalize and orthogonalize.
+		//
+
+		concurrency::parallel_for(0u, vertexBlockCount, [&](uint32 block)
+		{
+			uint32 first = block * NormalTangentBlockSize;
+			uint32 last = std::min<uint32>(first + NormalTangentBlockSize, vertexCount);
+			for(uint32 i = first; i < last; ++i)
+			{
+				float sum[7] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+				for(const float* acc : partials)
+				{
+					for(uint32 k = 0; k < 7; ++k)
+						sum[k] += acc[(size_t)k * vertexCount + i];
+				}
+
+				// No triangle uses this vertex: leave its normal and tangent alone.
+				if(sum[6] == 0.0f)
+					continue;
+
+				XMFLOAT3& normal = StreamElement<XMFLOAT3>(streams.Normal, streams.NormalStride, i);
+
+				XMVECTOR N = XMVectorSet(sum[0], sum[1], sum[2], 0.0f);
+				if(computeNormals)
+				{
+					// Vertices whose triangles are all degenerate keep the normal they had.
+					if(XMVectorGetX(XMVector3LengthSq(N)) > 1e-20f)
+						XMStoreFloat3(&normal, XMVector3Normalize(N));
+				}
+				N = XMLoadFloat3(&normal);
+
+				if(computeTangents)
+				{
+					XMFLOAT3& tangent = StreamElement<XMFLOAT3>(streams.TangentU, streams.TangentUStride, i);
+
+					XMVECTOR T = XMVectorSet(sum[3], sum[4], sum[5], 0.0f);
+					T = XMVectorSubtract(T, XMVectorMultiply(N, XMVector3Dot(N, T)));
+
+					// No usable texture mapping: any vector perpendicular to the normal will do.
+					if(XMVectorGetX(XMVector3LengthSq(T)) <= 1e-20f)
+					{
+						XMVECTOR axis = fabsf(normal.y) < 0.99f ? XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f) : XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+						T = XMVector3Cross(axis, N);
+					}
+
+					XMStoreFloat3(&tangent, XMVector3Normalize(T));
+				}
+			}
+		});
+	}
 }
 
+void GeometryGenerator::ComputeNormalsAndTangents(MeshData& meshData)
+{
+	if(meshData.Vertices.empty())
+		return;
+
+	VertexStreams streams;
+	streams.Position = &meshData.Vertices[0].Position;
+	streams.PositionStride = sizeof(Vertex);
+	streams.TexC = &meshData.Vertices[0].TexC;
+	streams.TexCStride = sizeof(Vertex);
+	streams.Normal = &meshData.Vertices[0].Normal;
+	streams.NormalStride = sizeof(Vertex);
+	streams.TangentU = &meshData.Vertices[0].TangentU;
+	streams.TangentUStride = sizeof(Vertex);
+	streams.VertexCount = (uint32)meshData.Vertices.size();
+
+	ComputeNormalsAndTangents(streams, meshData.Indices32.data(), (uint32)meshData.Indices32.size());
+}
+
+void GeometryGenerator::ComputeNormalsAndTangents(const VertexStreams& streams, const uint32* indices, uint32 indexCount)
+{
+	ComputeNormalsAndTangentsImpl(streams, indices, indexCount);
+}
+
+void GeometryGenerator::ComputeNormalsAndTangents(const VertexStreams& streams, const uint16* indices, uint32 indexCount)
+{
+	ComputeNormalsAndTangentsImpl(streams, indices, indexCount);
+}
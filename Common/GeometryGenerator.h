@@ -143,6 +143,38 @@ public:
 	
 
 	void Subdivide(MeshData& meshData);
+
+	///<summary>
+	/// Strided views of the vertex attributes read and written by
+	/// ComputeNormalsAndTangents, so it can run over MeshData as well as the
+	/// app's own vertex arrays (e.g. edited terrain or the water grid).  Strides
+	/// are in bytes.  If TexC or TangentU is null no tangents are produced.
+	///</summary>
+	struct VertexStreams
+	{
+		const void* Position = nullptr;
+		uint32 PositionStride = 0;
+		const void* TexC = nullptr;
+		uint32 TexCStride = 0;
+		void* Normal = nullptr;
+		uint32 NormalStride = 0;
+		void* TangentU = nullptr;
+		uint32 TangentUStride = 0;
+		uint32 VertexCount = 0;
+
+		// Keep the existing normals and only orthogonalize new tangents against them.
+		bool KeepNormals = false;
+	};
+
+	///<summary>
+	/// Recomputes area weighted vertex normals and tangents from the triangles.
+	/// Tangents follow the TexC u direction and are Gram-Schmidt orthogonalized
+	/// against the normal.  Vertices no triangle references are left untouched.
+	///</summary>
+	static void ComputeNormalsAndTangents(MeshData& meshData);
+
+	static void ComputeNormalsAndTangents(const VertexStreams& streams, const uint32* indices, uint32 indexCount);
+	static void ComputeNormalsAndTangents(const VertexStreams& streams, const uint16* indices, uint32 indexCount);
 private:
 	
     Vertex MidPoint(const Vertex& v0, const Vertex& v1);
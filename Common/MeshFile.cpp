@@ -0,0 +1,337 @@
+//***************************************************************************************
+// MeshFile.cpp
+//***************************************************************************************
+
+#include "MeshFile.h"
+#include <climits>
+
+using Microsoft::WRL::ComPtr;
+using namespace DirectX;
+
+namespace
+{
+	std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	UINT IndexByteSize(DXGI_FORMAT indexFormat)
+	{
+		return indexFormat == DXGI_FORMAT_R32_UINT ? 4 : 2;
+	}
+
+	// True if [offset, offset+byteSize) lies within [0, limit), without computing
+	// a sum that could wrap.
+	bool RangeFits(std::uint64_t offset, std::uint64_t byteSize, std::uint64_t limit)
+	{
+		return offset <= limit && byteSize <= limit - offset;
+	}
+
+	void WritePadding(std::ofstream& fout, std::uint64_t alignment)
+	{
+		static const char zeros[MeshFile::SectionAlignment] = {};
+		std::uint64_t pos = (std::uint64_t)fout.tellp();
+		std::uint64_t pad = AlignUp(pos, alignment) - pos;
+		fout.write(zeros, (std::streamsize)pad);
+	}
+}
+
+HRESULT MeshFileWriter::Write(
+	const std::wstring& filename,
+	const MeshFileStreamSource* streams,
+	UINT streamCount,
+	const void* indices,
+	UINT indexCount,
+	DXGI_FORMAT indexFormat,
+	const std::unordered_map<std::string, SubmeshGeometry>& drawArgs)
+{
+	if(streamCount == 0 || streamCount > MeshFile::MaxStreams || indices == nullptr)
+		return E_INVALIDARG;
+
+	if(indexFormat != DXGI_FORMAT_R16_UINT && indexFormat != DXGI_FORMAT_R32_UINT)
+		return E_INVALIDARG;
+
+	//
+	// Lay out the sections.  The leading pages hold the header and both tables.
+	//
+
+	MeshFileHeader header;
+	header.StreamCount = streamCount;
+	header.SubmeshCount = (std::uint32_t)drawArgs.size();
+	header.IndexFormat = indexFormat;
+	header.IndexCount = indexCount;
+
+	std::uint64_t tablesByteSize = sizeof(MeshFileHeader) +
+		streamCount * sizeof(MeshFileStream) +
+		drawArgs.size() * sizeof(MeshFileSubmesh);
+
+	std::uint64_t offset = AlignUp(tablesByteSize, MeshFile::SectionAlignment);
+
+	MeshFileStream streamTable[MeshFile::MaxStreams];
+	for(UINT i = 0; i < streamCount; ++i)
+	{
+		streamTable[i].ByteStride = streams[i].ByteStride;
+		streamTable[i].VertexCount = streams[i].VertexCount;
+		streamTable[i].Offset = offset;
+		streamTable[i].ByteSize = (std::uint64_t)streams[i].ByteStride * streams[i].VertexCount;
+
+		offset = AlignUp(offset + streamTable[i].ByteSize, MeshFile::SectionAlignment);
+	}
+
+	header.IndexOffset = offset;
+	header.IndexByteSize = (std::uint64_t)indexCount * IndexByteSize(indexFormat);
+	header.FileByteSize = AlignUp(offset + header.IndexByteSize, MeshFile::SectionAlignment);
+
+	//
+	// Submesh table and bounds.
+	//
+
+	std::vector<MeshFileSubmesh> submeshTable;
+	submeshTable.reserve(drawArgs.size());
+
+	BoundingBox meshBounds;
+	bool firstSubmesh = true;
+	for(const auto& e : drawArgs)
+	{
+		if(e.first.size() >= MeshFile::MaxSubmeshNameLength)
+			return E_INVALIDARG;
+
+		const SubmeshGeometry& submesh = e.second;
+
+		MeshFileSubmesh record;
+		std::copy(e.first.begin(), e.first.end(), record.Name);
+		record.IndexCount = submesh.IndexCount;
+		record.StartIndexLocation = submesh.StartIndexLocation;
+		record.BaseVertexLocation = submesh.BaseVertexLocation;
+		record.BoundsCenter = submesh.Bounds.Center;
+		record.BoundsExtents = submesh.Bounds.Extents;
+		submeshTable.push_back(record);
+
+		if(firstSubmesh)
+			meshBounds = submesh.Bounds;
+		else
+			BoundingBox::CreateMerged(meshBounds, meshBounds, submesh.Bounds);
+		firstSubmesh = false;
+	}
+
+	header.BoundsCenter = meshBounds.Center;
+	header.BoundsExtents = meshBounds.Extents;
+
+	//
+	// Write everything out.
+	//
+
+	std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+	if(!fout)
+		return HRESULT_FROM_WIN32(ERROR_OPEN_FAILED);
+
+	fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	fout.write(reinterpret_cast<const char*>(streamTable), streamCount * sizeof(MeshFileStream));
+	fout.write(reinterpret_cast<const char*>(submeshTable.data()), submeshTable.size() * sizeof(MeshFileSubmesh));
+	WritePadding(fout, MeshFile::SectionAlignment);
+
+	for(UINT i = 0; i < streamCount; ++i)
+	{
+		fout.write(static_cast<const char*>(streams[i].Data), (std::streamsize)streamTable[i].ByteSize);
+		WritePadding(fout, MeshFile::SectionAlignment);
+	}
+
+	fout.write(static_cast<const char*>(indices), (std::streamsize)header.IndexByteSize);
+	WritePadding(fout, MeshFile::SectionAlignment);
+
+	if(!fout)
+		return HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+
+	return S_OK;
+}
+
+HRESULT MeshFileWriter::Write(const std::wstring& filename, const MeshGeometry& geo)
+{
+	if(geo.VertexBufferCPU == nullptr || geo.IndexBufferCPU == nullptr || geo.VertexByteStride == 0)
+		return E_INVALIDARG;
+
+	MeshFileStreamSource streams[MeshFile::MaxStreams];
+	UINT streamCount = 1;
+
+	streams[0].Data = geo.VertexBufferCPU->GetBufferPointer();
+	streams[0].ByteStride = geo.VertexByteStride;
+	streams[0].VertexCount = geo.VertexBufferByteSize / geo.VertexByteStride;
+
+	if(geo.ColorBufferCPU != nullptr && geo.ColorByteStride != 0)
+	{
+		streams[1].Data = geo.ColorBufferCPU->GetBufferPointer();
+		streams[1].ByteStride = geo.ColorByteStride;
+		streams[1].VertexCount = geo.ColorBufferByteSize / geo.ColorByteStride;
+		streamCount = 2;
+	}
+
+	UINT indexCount = geo.IndexBufferByteSize / IndexByteSize(geo.IndexFormat);
+
+	return Write(filename, streams, streamCount, geo.IndexBufferCPU->GetBufferPointer(),
+		indexCount, geo.IndexFormat, geo.DrawArgs);
+}
+
+MappedMeshFile::~MappedMeshFile()
+{
+	Close();
+}
+
+HRESULT MappedMeshFile::Open(const std::wstring& filename)
+{
+	Close();
+
+	mFile = CreateFile2(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+	if(mFile == INVALID_HANDLE_VALUE)
+		return HRESULT_FROM_WIN32(GetLastError());
+
+	LARGE_INTEGER fileSize = {};
+	if(!GetFileSizeEx(mFile, &fileSize) || (std::uint64_t)fileSize.QuadPart < sizeof(MeshFileHeader))
+	{
+		Close();
+		return E_FAIL;
+	}
+
+	mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if(mMapping == nullptr)
+	{
+		HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+		Close();
+		return hr;
+	}
+
+	mView = static_cast<const std::uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+	if(mView == nullptr)
+	{
+		HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+		Close();
+		return hr;
+	}
+	mViewByteSize = (std::uint64_t)fileSize.QuadPart;
+
+	//
+	// Validate the header and tables.  This is the only work done on open; the
+	// sections themselves are used in place.  Every size must match its counts,
+	// since CreateGeometry and the draws trust them, and every sum is checked in a
+	// form that cannot overflow.  Sizes must also fit MeshGeometry's UINT fields.
+	//
+
+	mHeader = reinterpret_cast<const MeshFileHeader*>(mView);
+	mStreams = reinterpret_cast<const MeshFileStream*>(mView + sizeof(MeshFileHeader));
+	mSubmeshes = reinterpret_cast<const MeshFileSubmesh*>(mStreams + mHeader->StreamCount);
+
+	bool valid =
+		mHeader->Magic == MeshFile::Magic &&
+		mHeader->Version == MeshFile::Version &&
+		mHeader->HeaderByteSize == sizeof(MeshFileHeader) &&
+		mHeader->FileByteSize <= mViewByteSize &&
+		mHeader->StreamCount >= 1 && mHeader->StreamCount <= MeshFile::MaxStreams &&
+		(mHeader->IndexFormat == DXGI_FORMAT_R16_UINT || mHeader->IndexFormat == DXGI_FORMAT_R32_UINT);
+
+	if(valid)
+	{
+		valid = mHeader->IndexByteSize ==
+				(std::uint64_t)mHeader->IndexCount * IndexByteSize((DXGI_FORMAT)mHeader->IndexFormat) &&
+			mHeader->IndexByteSize <= UINT_MAX &&
+			RangeFits(mHeader->IndexOffset, mHeader->IndexByteSize, mHeader->FileByteSize);
+	}
+
+	if(valid)
+	{
+		// The tables take as many pages as they need (the writer starts the first
+		// section after them), and no section may overlap them.
+		std::uint64_t tablesByteSize = sizeof(MeshFileHeader) +
+			mHeader->StreamCount * sizeof(MeshFileStream) +
+			(std::uint64_t)mHeader->SubmeshCount * sizeof(MeshFileSubmesh);
+		std::uint64_t sectionsOffset = AlignUp(tablesByteSize, MeshFile::SectionAlignment);
+		valid = sectionsOffset <= mHeader->FileByteSize && mHeader->IndexOffset >= sectionsOffset;
+
+		for(UINT i = 0; valid && i < mHeader->StreamCount; ++i)
+		{
+			const MeshFileStream& stream = mStreams[i];
+			valid = stream.ByteSize == (std::uint64_t)stream.VertexCount * stream.ByteStride &&
+				stream.ByteSize <= UINT_MAX &&
+				stream.Offset >= sectionsOffset &&
+				RangeFits(stream.Offset, stream.ByteSize, mHeader->FileByteSize);
+		}
+
+		for(UINT i = 0; valid && i < mHeader->SubmeshCount; ++i)
+		{
+			const MeshFileSubmesh& submesh = mSubmeshes[i];
+			valid = RangeFits(submesh.StartIndexLocation, submesh.IndexCount, mHeader->IndexCount);
+		}
+	}
+
+	if(!valid)
+	{
+		Close();
+		return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+	}
+
+	return S_OK;
+}
+
+void MappedMeshFile::Close()
+{
+	if(mView != nullptr)
+		UnmapViewOfFile(mView);
+
+	if(mMapping != nullptr)
+		CloseHandle(mMapping);
+
+	if(mFile != INVALID_HANDLE_VALUE)
+		CloseHandle(mFile);
+
+	mFile = INVALID_HANDLE_VALUE;
+	mMapping = nullptr;
+	mView = nullptr;
+	mViewByteSize = 0;
+	mHeader = nullptr;
+	mStreams = nullptr;
+	mSubmeshes = nullptr;
+}
+
+std::unique_ptr<MeshGeometry> MappedMeshFile::CreateGeometry(
+	RenderDevice* device,
+	const std::string& name)const
+{
+	assert(IsOpen());
+
+	auto geo = std::make_unique<MeshGeometry>();
+	geo->Name = name;
+
+	const MeshFileStream& vertices = mStreams[0];
+	geo->VertexBufferGPU = device->CreateDefaultBuffer(
+		StreamData(0), vertices.ByteSize, geo->VertexBufferUploader);
+	geo->VertexByteStride = vertices.ByteStride;
+	geo->VertexBufferByteSize = (UINT)vertices.ByteSize;
+
+	if(mHeader->StreamCount > 1)
+	{
+		const MeshFileStream& colors = mStreams[1];
+		geo->ColorBufferGPU = device->CreateDefaultBuffer(
+			StreamData(1), colors.ByteSize, geo->ColorBufferUploader);
+		geo->ColorByteStride = colors.ByteStride;
+		geo->ColorBufferByteSize = (UINT)colors.ByteSize;
+	}
+
+	geo->IndexBufferGPU = device->CreateDefaultBuffer(
+		IndexData(), mHeader->IndexByteSize, geo->IndexBufferUploader);
+	geo->IndexFormat = (DXGI_FORMAT)mHeader->IndexFormat;
+	geo->IndexBufferByteSize = (UINT)mHeader->IndexByteSize;
+
+	for(UINT i = 0; i < mHeader->SubmeshCount; ++i)
+	{
+		const MeshFileSubmesh& record = mSubmeshes[i];
+
+		SubmeshGeometry submesh;
+		submesh.IndexCount = record.IndexCount;
+		submesh.StartIndexLocation = record.StartIndexLocation;
+		submesh.BaseVertexLocation = record.BaseVertexLocation;
+		submesh.Bounds = BoundingBox(record.BoundsCenter, record.BoundsExtents);
+
+		// Name is zero padded by the writer, but never trust a file to be terminated.
+		geo->DrawArgs[std::string(record.Name, strnlen(record.Name, MeshFile::MaxSubmeshNameLength))] = submesh;
+	}
+
+	return geo;
+}
@@ -0,0 +1,142 @@
+//***************************************************************************************
+// MeshFile.h
+//
+// Versioned binary container for cooked geometry (*.mesh).  The file is laid out so
+// it can be memory mapped and its vertex/index sections handed straight to the
+// upload heap: there is nothing to parse and no intermediate std::vector copies.
+//
+//   page 0..    : MeshFileHeader, MeshFileStream[StreamCount], MeshFileSubmesh[SubmeshCount]
+//   page aligned: vertex stream 0
+//   page aligned: vertex stream 1 (optional, e.g. MeshGeometry's color buffer)
+//   page aligned: index data
+//
+// All values are little endian.  Bump MeshFile::Version whenever a struct below
+// changes so stale cooked files are rejected instead of being misread.
+//***************************************************************************************
+
+#pragma once
+
+#include "RenderDevice.h"
+
+namespace MeshFile
+{
+	const std::uint32_t Magic = 0x4853454D; // 'MESH'
+	const std::uint32_t Version = 1;
+	const std::uint32_t SectionAlignment = 4096;
+	const std::uint32_t MaxStreams = 2;
+	const std::uint32_t MaxSubmeshNameLength = 48;
+}
+
+struct MeshFileStream
+{
+	std::uint32_t ByteStride = 0;
+	std::uint32_t VertexCount = 0;
+	std::uint64_t Offset = 0;
+	std::uint64_t ByteSize = 0;
+};
+
+struct MeshFileSubmesh
+{
+	char Name[MeshFile::MaxSubmeshNameLength] = {};
+	std::uint32_t IndexCount = 0;
+	std::uint32_t StartIndexLocation = 0;
+	std::int32_t BaseVertexLocation = 0;
+	DirectX::XMFLOAT3 BoundsCenter = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 BoundsExtents = { 0.0f, 0.0f, 0.0f };
+};
+
+struct MeshFileHeader
+{
+	std::uint32_t Magic = MeshFile::Magic;
+	std::uint32_t Version = MeshFile::Version;
+	std::uint32_t HeaderByteSize = sizeof(MeshFileHeader);
+	std::uint32_t StreamCount = 0;
+	std::uint32_t SubmeshCount = 0;
+	std::uint32_t IndexFormat = DXGI_FORMAT_R16_UINT;
+	std::uint32_t IndexCount = 0;
+	std::uint32_t Reserved = 0;
+	std::uint64_t IndexOffset = 0;
+	std::uint64_t IndexByteSize = 0;
+	std::uint64_t FileByteSize = 0;
+
+	// Bounds of the whole mesh; each submesh also stores its own.
+	DirectX::XMFLOAT3 BoundsCenter = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 BoundsExtents = { 0.0f, 0.0f, 0.0f };
+};
+
+// Source data for one vertex stream handed to MeshFileWriter.
+struct MeshFileStreamSource
+{
+	const void* Data = nullptr;
+	UINT ByteStride = 0;
+	UINT VertexCount = 0;
+};
+
+class MeshFileWriter
+{
+public:
+	///<summary>
+	/// Writes a cooked mesh.  Each submesh's Bounds is stored as given, e.g. from
+	/// d3dUtil::ComputeSubmeshBounds, and the mesh bounds are their union.
+	///</summary>
+	static HRESULT Write(
+		const std::wstring& filename,
+		const MeshFileStreamSource* streams,
+		UINT streamCount,
+		const void* indices,
+		UINT indexCount,
+		DXGI_FORMAT indexFormat,
+		const std::unordered_map<std::string, SubmeshGeometry>& drawArgs);
+
+	///<summary>
+	/// Convenience overload that cooks a MeshGeometry from its system memory copies.
+	///</summary>
+	static HRESULT Write(const std::wstring& filename, const MeshGeometry& geo);
+};
+
+// Read-only view of a cooked mesh.  Open() maps the file; the accessors return
+// pointers into the mapping, which stay valid until Close() or destruction.
+class MappedMeshFile
+{
+public:
+	MappedMeshFile() = default;
+	MappedMeshFile(const MappedMeshFile& rhs) = delete;
+	MappedMeshFile& operator=(const MappedMeshFile& rhs) = delete;
+	~MappedMeshFile();
+
+	HRESULT Open(const std::wstring& filename);
+	void Close();
+
+	bool IsOpen()const { return mView != nullptr; }
+
+	const MeshFileHeader& Header()const { return *mHeader; }
+
+	UINT StreamCount()const { return mHeader->StreamCount; }
+	const MeshFileStream& Stream(UINT i)const { return mStreams[i]; }
+	const void* StreamData(UINT i)const { return mView + mStreams[i].Offset; }
+
+	const void* IndexData()const { return mView + mHeader->IndexOffset; }
+
+	UINT SubmeshCount()const { return mHeader->SubmeshCount; }
+	const MeshFileSubmesh& Submesh(UINT i)const { return mSubmeshes[i]; }
+
+	///<summary>
+	/// Creates the GPU buffers straight from the mapped sections.  The returned
+	/// geometry has no VertexBufferCPU/IndexBufferCPU blobs.  The upload buffers
+	/// must be kept alive until the device's setup command list has executed, as
+	/// with RenderDevice::CreateDefaultBuffer.
+	///</summary>
+	std::unique_ptr<MeshGeometry> CreateGeometry(
+		RenderDevice* device,
+		const std::string& name)const;
+
+private:
+	HANDLE mFile = INVALID_HANDLE_VALUE;
+	HANDLE mMapping = nullptr;
+	const std::uint8_t* mView = nullptr;
+	std::uint64_t mViewByteSize = 0;
+
+	const MeshFileHeader* mHeader = nullptr;
+	const MeshFileStream* mStreams = nullptr;
+	const MeshFileSubmesh* mSubmeshes = nullptr;
+};
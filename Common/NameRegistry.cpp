@@ -0,0 +1,23 @@
+//***************************************************************************************
+// NameRegistry.cpp
+//***************************************************************************************
+
+#include "NameRegistry.h"
+
+UINT NameRegistry::Intern(const std::string& name)
+{
+	auto it = mHandles.find(name);
+	if(it != mHandles.end())
+		return it->second;
+
+	UINT handle = (UINT)mNames.size();
+	mHandles.emplace(name, handle);
+	mNames.push_back(name);
+	return handle;
+}
+
+UINT NameRegistry::Find(const std::string& name)const
+{
+	auto it = mHandles.find(name);
+	return it != mHandles.end() ? it->second : InvalidHandle;
+}
@@ -0,0 +1,88 @@
+//***************************************************************************************
+// NameRegistry.h
+//
+// Interns names into dense integer handles (0, 1, 2, ... in first-use order) so
+// that names are hashed once, while a scene or its resources are being built, and
+// everything after that indexes arrays with the handles instead.
+//
+// NamedTable pairs a registry with a handle-indexed vector of values, for resources
+// such as geometries, materials, textures and PSOs that are created and looked up
+// by name at build time but used every frame.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class NameRegistry
+{
+public:
+	static const UINT InvalidHandle = 0xFFFFFFFF;
+
+	///<summary>
+	/// Returns the handle of name, registering it with the next free handle if it
+	/// is new.
+	///</summary>
+	UINT Intern(const std::string& name);
+
+	///<summary>
+	/// Returns the handle of name, or InvalidHandle if it was never interned.
+	///</summary>
+	UINT Find(const std::string& name)const;
+
+	const std::string& Name(UINT handle)const { return mNames[handle]; }
+	UINT Count()const { return (UINT)mNames.size(); }
+
+private:
+	std::unordered_map<std::string, UINT> mHandles;
+	std::vector<std::string> mNames;
+};
+
+template<typename T>
+class NamedTable
+{
+public:
+	///<summary>
+	/// Returns the handle of name, adding a default constructed value for it if it
+	/// is new (e.g. for an out parameter to fill in).
+	///</summary>
+	UINT Add(const std::string& name)
+	{
+		UINT handle = mNames.Intern(name);
+		if(handle == mValues.size())
+			mValues.emplace_back();
+		return handle;
+	}
+
+	///<summary>
+	/// Stores value under name, replacing any earlier value, and returns its handle.
+	///</summary>
+	UINT Add(const std::string& name, T&& value)
+	{
+		UINT handle = Add(name);
+		mValues[handle] = std::move(value);
+		return handle;
+	}
+
+	UINT Find(const std::string& name)const { return mNames.Find(name); }
+
+	///<summary>
+	/// Build time lookup by name.  The name must have been added.
+	///</summary>
+	T& Get(const std::string& name)
+	{
+		UINT handle = Find(name);
+		assert(handle != NameRegistry::InvalidHandle);
+		return mValues[handle];
+	}
+
+	T& operator[](UINT handle) { return mValues[handle]; }
+	const T& operator[](UINT handle)const { return mValues[handle]; }
+
+	const std::string& Name(UINT handle)const { return mNames.Name(handle); }
+	UINT Count()const { return (UINT)mValues.size(); }
+
+private:
+	NameRegistry mNames;
+	std::vector<T> mValues;
+};
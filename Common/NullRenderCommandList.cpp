@@ -0,0 +1,122 @@
+//***************************************************************************************
+// NullRenderCommandList.cpp
+//***************************************************************************************
+
+#include "NullRenderCommandList.h"
+
+namespace
+{
+	template<typename T>
+	std::uint64_t Opaque(const T* p)
+	{
+		return (std::uint64_t)reinterpret_cast<std::uintptr_t>(p);
+	}
+}
+
+void NullRenderCommandList::Reset()
+{
+	mCommands.clear();
+	for(UINT& count : mCounts)
+		count = 0;
+	mIndexCount = 0;
+}
+
+void NullRenderCommandList::SetPipelineState(ID3D12PipelineState* pso)
+{
+	Record(RenderCommandType::SetPipelineState, Opaque(pso));
+}
+
+void NullRenderCommandList::SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)
+{
+	Record(RenderCommandType::SetGraphicsRootSignature, Opaque(rootSignature));
+}
+
+void NullRenderCommandList::SetDescriptorHeaps(UINT count, ID3D12DescriptorHeap* const* heaps)
+{
+	Record(RenderCommandType::SetDescriptorHeaps, count > 0 ? Opaque(heaps[0]) : 0, count);
+}
+
+void NullRenderCommandList::RSSetViewports(UINT count, const D3D12_VIEWPORT* viewports)
+{
+	UINT width = count > 0 ? (UINT)viewports[0].Width : 0;
+	UINT height = count > 0 ? (UINT)viewports[0].Height : 0;
+	Record(RenderCommandType::RSSetViewports, 0, count, width, height);
+}
+
+void NullRenderCommandList::RSSetScissorRects(UINT count, const D3D12_RECT* rects)
+{
+	UINT width = count > 0 ? (UINT)(rects[0].right - rects[0].left) : 0;
+	UINT height = count > 0 ? (UINT)(rects[0].bottom - rects[0].top) : 0;
+	Record(RenderCommandType::RSSetScissorRects, 0, count, width, height);
+}
+
+void NullRenderCommandList::OMSetRenderTargets(UINT count, const D3D12_CPU_DESCRIPTOR_HANDLE* rtvs,
+	BOOL singleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv)
+{
+	Record(RenderCommandType::OMSetRenderTargets, count > 0 ? (std::uint64_t)rtvs[0].ptr : 0,
+		count, singleHandleToDescriptorRange ? 1 : 0, dsv != nullptr ? 1 : 0);
+}
+
+void NullRenderCommandList::IASetVertexBuffers(UINT startSlot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views)
+{
+	Record(RenderCommandType::IASetVertexBuffers, count > 0 ? views[0].BufferLocation : 0,
+		startSlot, count, count > 0 ? views[0].SizeInBytes : 0, count > 0 ? views[0].StrideInBytes : 0);
+}
+
+void NullRenderCommandList::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view)
+{
+	if(view == nullptr)
+		Record(RenderCommandType::IASetIndexBuffer, 0);
+	else
+		Record(RenderCommandType::IASetIndexBuffer, view->BufferLocation, view->SizeInBytes, (UINT)view->Format);
+}
+
+void NullRenderCommandList::IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+{
+	Record(RenderCommandType::IASetPrimitiveTopology, 0, (UINT)topology);
+}
+
+void NullRenderCommandList::SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor)
+{
+	Record(RenderCommandType::SetGraphicsRootDescriptorTable, baseDescriptor.ptr, rootIndex);
+}
+
+void NullRenderCommandList::SetGraphicsRootConstantBufferView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	Record(RenderCommandType::SetGraphicsRootConstantBufferView, address, rootIndex);
+}
+
+void NullRenderCommandList::SetGraphicsRootShaderResourceView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+	Record(RenderCommandType::SetGraphicsRootShaderResourceView, address, rootIndex);
+}
+
+void NullRenderCommandList::ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers)
+{
+	Record(RenderCommandType::ResourceBarrier, 0, count, count > 0 ? (UINT)barriers[0].Type : 0);
+}
+
+void NullRenderCommandList::DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount,
+	UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)
+{
+	Record(RenderCommandType::DrawIndexedInstanced, 0, indexCountPerInstance, instanceCount,
+		startIndexLocation, (UINT)baseVertexLocation, startInstanceLocation);
+
+	mIndexCount += (std::uint64_t)indexCountPerInstance*instanceCount;
+}
+
+void NullRenderCommandList::Record(RenderCommandType type, std::uint64_t value,
+	UINT arg0, UINT arg1, UINT arg2, UINT arg3, UINT arg4)
+{
+	RenderCommand command;
+	command.Type = type;
+	command.Args[0] = arg0;
+	command.Args[1] = arg1;
+	command.Args[2] = arg2;
+	command.Args[3] = arg3;
+	command.Args[4] = arg4;
+	command.Value = value;
+	mCommands.push_back(command);
+
+	++mCounts[(int)type];
+}
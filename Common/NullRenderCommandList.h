@@ -0,0 +1,92 @@
+//***************************************************************************************
+// NullRenderCommandList.h
+//
+// RenderCommandList that talks to no GPU.  Each call is appended to a CPU-side
+// stream of fixed-size records and counted by type, so a frame's recording can be
+// run, timed and inspected without submitting anything (CPU-only benchmarks,
+// checking how much state a change of draw order saves).  With NullRenderDevice
+// the whole frame runs without a window, GPU or D3D12 device.
+//
+// Pointers and GPU addresses are stored as opaque 64-bit values and never
+// dereferenced, except for the arrays a call passes in, whose first element is kept.
+//***************************************************************************************
+
+#pragma once
+
+#include "RenderCommandList.h"
+
+enum class RenderCommandType : std::uint8_t
+{
+	SetPipelineState = 0,
+	SetGraphicsRootSignature,
+	SetDescriptorHeaps,
+	RSSetViewports,
+	RSSetScissorRects,
+	OMSetRenderTargets,
+	IASetVertexBuffers,
+	IASetIndexBuffer,
+	IASetPrimitiveTopology,
+	SetGraphicsRootDescriptorTable,
+	SetGraphicsRootConstantBufferView,
+	SetGraphicsRootShaderResourceView,
+	ResourceBarrier,
+	DrawIndexedInstanced,
+	Count
+};
+
+// One recorded call.  Args holds the call's integer arguments in declaration order
+// (for arrays: the count); Value holds its pointer, handle or address argument.
+struct RenderCommand
+{
+	RenderCommandType Type;
+	UINT Args[5];
+	std::uint64_t Value;
+};
+
+class NullRenderCommandList : public RenderCommandList
+{
+public:
+	///<summary>
+	/// Empties the stream and zeroes the counters, keeping the stream's memory.
+	///</summary>
+	void Reset();
+
+	const std::vector<RenderCommand>& Commands()const { return mCommands; }
+
+	UINT CommandCount()const { return (UINT)mCommands.size(); }
+	UINT CommandCount(RenderCommandType type)const { return mCounts[(int)type]; }
+
+	// Indices submitted by the recorded draws, over all their instances.
+	std::uint64_t IndexCount()const { return mIndexCount; }
+
+	void SetPipelineState(ID3D12PipelineState* pso)override;
+	void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)override;
+	void SetDescriptorHeaps(UINT count, ID3D12DescriptorHeap* const* heaps)override;
+
+	void RSSetViewports(UINT count, const D3D12_VIEWPORT* viewports)override;
+	void RSSetScissorRects(UINT count, const D3D12_RECT* rects)override;
+	void OMSetRenderTargets(UINT count, const D3D12_CPU_DESCRIPTOR_HANDLE* rtvs,
+		BOOL singleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv)override;
+
+	void IASetVertexBuffers(UINT startSlot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views)override;
+	void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view)override;
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)override;
+
+	void SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor)override;
+	void SetGraphicsRootConstantBufferView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address)override;
+	void SetGraphicsRootShaderResourceView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address)override;
+
+	void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers)override;
+
+	void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount,
+		UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)override;
+
+private:
+	void Record(RenderCommandType type, std::uint64_t value,
+		UINT arg0 = 0, UINT arg1 = 0, UINT arg2 = 0, UINT arg3 = 0, UINT arg4 = 0);
+
+private:
+	std::vector<RenderCommand> mCommands;
+	UINT mCounts[(int)RenderCommandType::Count] = {};
+	std::uint64_t mIndexCount = 0;
+};
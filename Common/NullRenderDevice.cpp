@@ -0,0 +1,57 @@
+//***************************************************************************************
+// NullRenderDevice.cpp
+//***************************************************************************************
+
+#include "NullRenderDevice.h"
+
+using Microsoft::WRL::ComPtr;
+
+MappedBuffer NullRenderDevice::CreateUploadBuffer(UINT64 byteSize)
+{
+	MappedBuffer buffer;
+	buffer.Storage.reset(new BYTE[static_cast<size_t>(byteSize)]);
+	buffer.Cpu = buffer.Storage.get();
+
+	// Addresses are never reused, and keep the placement alignment real buffers
+	// have, so offsets added to them by callers still look like D3D12's.
+	buffer.Gpu = mNextAddress;
+	mNextAddress += (byteSize + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1) &
+		~UINT64(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1);
+
+	mUploadByteSize += byteSize;
+
+	return buffer;
+}
+
+ComPtr<ID3D12Resource> NullRenderDevice::CreateDefaultBuffer(const void* initData, UINT64 byteSize,
+	ComPtr<ID3D12Resource>& uploadBuffer)
+{
+	uploadBuffer = nullptr;
+	return nullptr;
+}
+
+ComPtr<ID3D12CommandAllocator> NullRenderDevice::CreateCommandAllocator()
+{
+	return nullptr;
+}
+
+ComPtr<ID3D12GraphicsCommandList> NullRenderDevice::CreateCommandList(ID3D12CommandAllocator* allocator)
+{
+	return nullptr;
+}
+
+UINT64 NullRenderDevice::Signal()
+{
+	return ++mFenceValue;
+}
+
+UINT64 NullRenderDevice::CompletedFenceValue()
+{
+	return mFenceValue;
+}
+
+bool NullRenderDevice::WaitForFence(UINT64 value)
+{
+	assert(value <= mFenceValue);
+	return false;
+}
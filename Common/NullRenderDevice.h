@@ -0,0 +1,38 @@
+//***************************************************************************************
+// NullRenderDevice.h
+//
+// RenderDevice with no GPU behind it, used with NullRenderCommandList to run frames
+// headless.  Upload buffers are plain system memory with made-up GPU addresses,
+// default buffers and command lists are null, and the fence completes as soon as it
+// is signalled, so nothing ever waits.
+//***************************************************************************************
+
+#pragma once
+
+#include "RenderDevice.h"
+
+class NullRenderDevice : public RenderDevice
+{
+public:
+	ID3D12Device* NativeDevice()const override { return nullptr; }
+
+	MappedBuffer CreateUploadBuffer(UINT64 byteSize)override;
+	Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(const void* initData, UINT64 byteSize,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer)override;
+
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CreateCommandAllocator()override;
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> CreateCommandList(ID3D12CommandAllocator* allocator)override;
+
+	UINT64 Signal()override;
+	UINT64 CompletedFenceValue()override;
+	bool WaitForFence(UINT64 value)override;
+
+	// Bytes of upload buffers created so far.
+	UINT64 UploadByteSize()const { return mUploadByteSize; }
+
+private:
+	// Next made-up GPU address.  Starts past zero so no buffer looks unbound.
+	D3D12_GPU_VIRTUAL_ADDRESS mNextAddress = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+	UINT64 mUploadByteSize = 0;
+	UINT64 mFenceValue = 0;
+};
@@ -0,0 +1,649 @@
+//***************************************************************************************
+// ObjLoader.cpp
+//***************************************************************************************
+
+#include "ObjLoader.h"
+#include <ppl.h>
+#include <concurrent_unordered_map.h>
+#include <atomic>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	// Chunks are sized so every worker gets several, which evens out files where
+	// the vertex block and the face block parse at very different speeds.
+	const size_t MinChunkByteSize = 1 << 20;
+	const UINT ChunksPerWorker = 4;
+
+	// Flags stored with each triangle corner.
+	const std::uint32_t CornerRelativeV = 1 << 0;
+	const std::uint32_t CornerRelativeT = 1 << 1;
+	const std::uint32_t CornerRelativeN = 1 << 2;
+	const std::uint32_t CornerHasT = 1 << 3;
+	const std::uint32_t CornerHasN = 1 << 4;
+
+	struct ObjCorner
+	{
+		std::int32_t V;
+		std::int32_t T;
+		std::int32_t N;
+		std::uint32_t Flags;
+	};
+
+	struct ObjCornerKey
+	{
+		std::int32_t V;
+		std::int32_t T;
+		std::int32_t N;
+
+		bool operator==(const ObjCornerKey& rhs)const
+		{
+			return V == rhs.V && T == rhs.T && N == rhs.N;
+		}
+	};
+
+	struct ObjCornerKeyHash
+	{
+		size_t operator()(const ObjCornerKey& k)const
+		{
+			std::uint64_t h = (std::uint32_t)k.V * 0x9E3779B97F4A7C15ull;
+			h ^= ((std::uint32_t)k.T + 0x7F4A7C15ull) * 0xC2B2AE3D27D4EB4Full;
+			h ^= ((std::uint32_t)k.N + 0x165667B1ull) * 0x165667B19E3779F9ull;
+			return (size_t)(h ^ (h >> 29));
+		}
+	};
+
+	// One line aligned slice of the file and everything parsed out of it.  Indices
+	// are resolved to global ones once every chunk's element counts are known.
+	struct ObjChunk
+	{
+		const char* Begin = nullptr;
+		const char* End = nullptr;
+
+		std::vector<XMFLOAT3> Positions;
+		std::vector<XMFLOAT2> TexCoords;
+		std::vector<XMFLOAT3> Normals;
+		std::vector<ObjCorner> Corners; // 3 per triangle
+
+		UINT PositionBase = 0;
+		UINT TexCoordBase = 0;
+		UINT NormalBase = 0;
+		UINT CornerBase = 0;
+		UINT VertexBase = 0;
+		UINT VertexCount = 0;
+
+		bool Failed = false;
+	};
+
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile& rhs) = delete;
+		MappedFile& operator=(const MappedFile& rhs) = delete;
+		~MappedFile()
+		{
+			if(mView != nullptr)
+				UnmapViewOfFile(mView);
+			if(mMapping != nullptr)
+				CloseHandle(mMapping);
+			if(mFile != INVALID_HANDLE_VALUE)
+				CloseHandle(mFile);
+		}
+
+		HRESULT Open(const std::wstring& filename)
+		{
+			mFile = CreateFile2(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+			if(mFile == INVALID_HANDLE_VALUE)
+				return HRESULT_FROM_WIN32(GetLastError());
+
+			LARGE_INTEGER fileSize = {};
+			if(!GetFileSizeEx(mFile, &fileSize))
+				return HRESULT_FROM_WIN32(GetLastError());
+
+			// An empty file cannot be mapped, and has no geometry anyway.
+			if(fileSize.QuadPart == 0)
+				return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+			mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if(mMapping == nullptr)
+				return HRESULT_FROM_WIN32(GetLastError());
+
+			mView = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+			if(mView == nullptr)
+				return HRESULT_FROM_WIN32(GetLastError());
+
+			mByteSize = (size_t)fileSize.QuadPart;
+			return S_OK;
+		}
+
+		const char* Data()const { return mView; }
+		size_t ByteSize()const { return mByteSize; }
+
+	private:
+		HANDLE mFile = INVALID_HANDLE_VALUE;
+		HANDLE mMapping = nullptr;
+		const char* mView = nullptr;
+		size_t mByteSize = 0;
+	};
+
+	inline bool IsDigit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	inline bool IsBlank(char c)
+	{
+		return c == ' ' || c == '\t';
+	}
+
+	inline const char* SkipBlanks(const char* p, const char* end)
+	{
+		while(p < end && IsBlank(*p))
+			++p;
+		return p;
+	}
+
+	inline const char* SkipLine(const char* p, const char* end)
+	{
+		while(p < end && *p != '\n')
+			++p;
+		return p < end ? p + 1 : end;
+	}
+
+	inline const char* ParseInt(const char* p, const char* end, std::int32_t& out)
+	{
+		bool negative = false;
+		if(p < end && (*p == '-' || *p == '+'))
+		{
+			negative = *p == '-';
+			++p;
+		}
+
+		if(p == end || !IsDigit(*p))
+			return nullptr;
+
+		std::int64_t value = 0;
+		while(p < end && IsDigit(*p))
+		{
+			value = value * 10 + (*p - '0');
+			if(value > INT32_MAX)
+				return nullptr;
+			++p;
+		}
+
+		out = (std::int32_t)(negative ? -value : value);
+		return p;
+	}
+
+	// Decimal to float without going through the locale aware CRT.  Up to 19
+	// significant digits are kept, which is far more than a float can hold.
+	inline const char* ParseFloat(const char* p, const char* end, float& out)
+	{
+		static const double Pow10[] =
+		{
+			1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		bool negative = false;
+		if(p < end && (*p == '-' || *p == '+'))
+		{
+			negative = *p == '-';
+			++p;
+		}
+
+		std::uint64_t mantissa = 0;
+		int exponent = 0;
+		int digits = 0;
+		bool anyDigits = false;
+
+		while(p < end && IsDigit(*p))
+		{
+			if(digits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				if(mantissa != 0)
+					++digits;
+			}
+			else
+				++exponent;
+			anyDigits = true;
+			++p;
+		}
+
+		if(p < end && *p == '.')
+		{
+			++p;
+			while(p < end && IsDigit(*p))
+			{
+				if(digits < 19)
+				{
+					mantissa = mantissa * 10 + (*p - '0');
+					if(mantissa != 0)
+						++digits;
+					--exponent;
+				}
+				anyDigits = true;
+				++p;
+			}
+		}
+
+		if(!anyDigits)
+			return nullptr;
+
+		if(p < end && (*p == 'e' || *p == 'E'))
+		{
+			std::int32_t e = 0;
+			const char* q = ParseInt(p + 1, end, e);
+			if(q != nullptr)
+			{
+				exponent += e;
+				p = q;
+			}
+		}
+
+		double value = (double)mantissa;
+		if(exponent < 0)
+			value = exponent >= -22 ? value / Pow10[-exponent] : value * std::pow(10.0, exponent);
+		else if(exponent > 0)
+			value = exponent <= 22 ? value * Pow10[exponent] : value * std::pow(10.0, exponent);
+
+		out = (float)(negative ? -value : value);
+		return p;
+	}
+
+	// Reads up to count floats; components missing from the line are left untouched.
+	inline const char* ParseFloats(const char* p, const char* end, float* out, int count)
+	{
+		for(int i = 0; i < count; ++i)
+		{
+			p = SkipBlanks(p, end);
+			const char* q = ParseFloat(p, end, out[i]);
+			if(q == nullptr)
+				break;
+			p = q;
+		}
+		return p;
+	}
+
+	// Converts one OBJ index to 0 based.  Positive indices are absolute; negative
+	// ones count back from the current element and are only chunk relative here.
+	inline bool StoreIndex(std::int32_t objIndex, size_t localCount,
+		std::int32_t& out, std::uint32_t& flags, std::uint32_t relativeFlag)
+	{
+		if(objIndex > 0)
+		{
+			out = objIndex - 1;
+			return true;
+		}
+
+		if(objIndex < 0)
+		{
+			out = (std::int32_t)localCount + objIndex;
+			flags |= relativeFlag;
+			return true;
+		}
+
+		return false;
+	}
+
+	const char* ParseFace(const char* p, const char* end, ObjChunk& chunk,
+		std::vector<ObjCorner>& polygon, bool reverseWinding)
+	{
+		polygon.clear();
+
+		for(;;)
+		{
+			p = SkipBlanks(p, end);
+			if(p == end || *p == '\r' || *p == '\n' || *p == '#')
+				break;
+
+			ObjCorner corner = { 0, -1, -1, 0 };
+			std::int32_t v = 0;
+
+			p = ParseInt(p, end, v);
+			if(p == nullptr || !StoreIndex(v, chunk.Positions.size(), corner.V, corner.Flags, CornerRelativeV))
+				return nullptr;
+
+			if(p < end && *p == '/')
+			{
+				++p;
+				if(p < end && *p != '/')
+				{
+					p = ParseInt(p, end, v);
+					if(p == nullptr || !StoreIndex(v, chunk.TexCoords.size(), corner.T, corner.Flags, CornerRelativeT))
+						return nullptr;
+					corner.Flags |= CornerHasT;
+				}
+
+				if(p < end && *p == '/')
+				{
+					++p;
+					p = ParseInt(p, end, v);
+					if(p == nullptr || !StoreIndex(v, chunk.Normals.size(), corner.N, corner.Flags, CornerRelativeN))
+						return nullptr;
+					corner.Flags |= CornerHasN;
+				}
+			}
+
+			polygon.push_back(corner);
+		}
+
+		if(polygon.size() < 3)
+			return nullptr;
+
+		// Fan triangulate.  Fine for the convex polygons exporters write.
+		for(size_t i = 1; i + 1 < polygon.size(); ++i)
+		{
+			chunk.Corners.push_back(polygon[0]);
+			chunk.Corners.push_back(polygon[reverseWinding ? i + 1 : i]);
+			chunk.Corners.push_back(polygon[reverseWinding ? i : i + 1]);
+		}
+
+		return p;
+	}
+
+	void ParseChunk(ObjChunk& chunk, const ObjLoader::Options& options)
+	{
+		std::vector<ObjCorner> polygon;
+
+		const char* p = chunk.Begin;
+		const char* end = chunk.End;
+		while(p < end)
+		{
+			p = SkipBlanks(p, end);
+			if(p + 1 >= end)
+				break;
+
+			if(p[0] == 'v' && IsBlank(p[1]))
+			{
+				XMFLOAT3 v(0.0f, 0.0f, 0.0f);
+				p = ParseFloats(p + 2, end, &v.x, 3);
+				if(options.ConvertToLeftHanded)
+					v.z = -v.z;
+				chunk.Positions.push_back(v);
+			}
+			else if(p[0] == 'v' && p[1] == 't' && p + 2 < end && IsBlank(p[2]))
+			{
+				XMFLOAT2 t(0.0f, 0.0f);
+				p = ParseFloats(p + 3, end, &t.x, 2);
+				if(options.FlipV)
+					t.y = 1.0f - t.y;
+				chunk.TexCoords.push_back(t);
+			}
+			else if(p[0] == 'v' && p[1] == 'n' && p + 2 < end && IsBlank(p[2]))
+			{
+				XMFLOAT3 n(0.0f, 0.0f, 0.0f);
+				p = ParseFloats(p + 3, end, &n.x, 3);
+				if(options.ConvertToLeftHanded)
+					n.z = -n.z;
+				chunk.Normals.push_back(n);
+			}
+			else if(p[0] == 'f' && IsBlank(p[1]))
+			{
+				p = ParseFace(p + 2, end, chunk, polygon, options.ConvertToLeftHanded);
+				if(p == nullptr)
+				{
+					chunk.Failed = true;
+					return;
+				}
+			}
+
+			p = SkipLine(p, end);
+		}
+	}
+
+	inline bool ResolveIndex(std::int32_t& index, std::uint32_t flags, std::uint32_t relativeFlag,
+		UINT base, UINT count)
+	{
+		if(flags & relativeFlag)
+			index += (std::int32_t)base;
+		return index >= 0 && (UINT)index < count;
+	}
+}
+
+HRESULT ObjLoader::Load(const std::wstring& filename, GeometryGenerator::MeshData& mesh)
+{
+	return Load(filename, mesh, Options());
+}
+
+HRESULT ObjLoader::Load(
+	const std::wstring& filename,
+	GeometryGenerator::MeshData& mesh,
+	const Options& options)
+{
+	LARGE_INTEGER startTime, frequency;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&startTime);
+
+	MappedFile file;
+	HRESULT hr = file.Open(filename);
+	if(FAILED(hr))
+		return hr;
+
+	//
+	// Split the file into chunks that start and end on line boundaries.
+	//
+
+	const char* data = file.Data();
+	const size_t byteSize = file.ByteSize();
+
+	size_t chunkCount = (size_t)std::max<UINT>(1u, concurrency::GetProcessorCount() * ChunksPerWorker);
+	size_t chunkByteSize = std::max<size_t>(MinChunkByteSize, byteSize / chunkCount + 1);
+
+	std::vector<ObjChunk> chunks;
+	chunks.reserve(byteSize / chunkByteSize + 1);
+	for(const char* p = data; p < data + byteSize; )
+	{
+		const char* chunkEnd = p + std::min<size_t>(chunkByteSize, (size_t)(data + byteSize - p));
+		chunkEnd = SkipLine(chunkEnd - 1, data + byteSize);
+
+		ObjChunk chunk;
+		chunk.Begin = p;
+		chunk.End = chunkEnd;
+		chunks.push_back(std::move(chunk));
+
+		p = chunkEnd;
+	}
+
+	//
+	// Parse every chunk in parallel.
+	//
+
+	concurrency::parallel_for(size_t(0), chunks.size(), [&](size_t i)
+	{
+		ParseChunk(chunks[i], options);
+	});
+
+	for(const auto& chunk : chunks)
+	{
+		if(chunk.Failed)
+			return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+	}
+
+	// Prefix sums give each chunk its first global position/texcoord/normal/corner.
+	UINT positionCount = 0;
+	UINT texCoordCount = 0;
+	UINT normalCount = 0;
+	UINT cornerCount = 0;
+	for(auto& chunk : chunks)
+	{
+		chunk.PositionBase = positionCount;
+		chunk.TexCoordBase = texCoordCount;
+		chunk.NormalBase = normalCount;
+		chunk.CornerBase = cornerCount;
+
+		positionCount += (UINT)chunk.Positions.size();
+		texCoordCount += (UINT)chunk.TexCoords.size();
+		normalCount += (UINT)chunk.Normals.size();
+		cornerCount += (UINT)chunk.Corners.size();
+	}
+
+	if(cornerCount == 0)
+		return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+	std::vector<XMFLOAT3> positions(positionCount);
+	std::vector<XMFLOAT2> texCoords(texCoordCount);
+	std::vector<XMFLOAT3> normals(normalCount);
+
+	//
+	// Gather the attribute arrays, resolve relative indices and hash every
+	// corner.  The hash maps a v/vt/vn triplet to the first corner that used
+	// it, so the welded vertex order does not depend on thread scheduling.
+	//
+
+	concurrency::concurrent_unordered_map<ObjCornerKey, LONG, ObjCornerKeyHash> weldMap;
+	weldMap.rehash(cornerCount / 2);
+
+	std::vector<UINT> firstCorner(cornerCount);
+	// Set by any worker; only read once parallel_for has joined them all.
+	std::atomic<bool> badIndex(false);
+	std::atomic<bool> missingNormals(false);
+
+	concurrency::parallel_for(size_t(0), chunks.size(), [&](size_t c)
+	{
+		ObjChunk& chunk = chunks[c];
+
+		std::copy(chunk.Positions.begin(), chunk.Positions.end(), positions.begin() + chunk.PositionBase);
+		std::copy(chunk.TexCoords.begin(), chunk.TexCoords.end(), texCoords.begin() + chunk.TexCoordBase);
+		std::copy(chunk.Normals.begin(), chunk.Normals.end(), normals.begin() + chunk.NormalBase);
+
+		for(size_t i = 0; i < chunk.Corners.size(); ++i)
+		{
+			ObjCorner& corner = chunk.Corners[i];
+
+			bool valid = ResolveIndex(corner.V, corner.Flags, CornerRelativeV, chunk.PositionBase, positionCount);
+			if(corner.Flags & CornerHasT)
+				valid &= ResolveIndex(corner.T, corner.Flags, CornerRelativeT, chunk.TexCoordBase, texCoordCount);
+			if(corner.Flags & CornerHasN)
+				valid &= ResolveIndex(corner.N, corner.Flags, CornerRelativeN, chunk.NormalBase, normalCount);
+			else
+				missingNormals.store(true, std::memory_order_relaxed);
+
+			if(!valid)
+			{
+				badIndex.store(true, std::memory_order_relaxed);
+				return;
+			}
+
+			LONG cornerIndex = (LONG)(chunk.CornerBase + i);
+			ObjCornerKey key = { corner.V, corner.T, corner.N };
+			auto result = weldMap.insert(std::make_pair(key, cornerIndex));
+
+			// Another thread got there first; keep whichever corner comes earlier in the file.
+			if(!result.second)
+			{
+				volatile LONG* first = &result.first->second;
+				LONG seen = *first;
+				while(cornerIndex < seen)
+				{
+					LONG prev = InterlockedCompareExchange(first, cornerIndex, seen);
+					if(prev == seen)
+						break;
+					seen = prev;
+				}
+			}
+		}
+	});
+
+	if(badIndex.load())
+		return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+	//
+	// A corner that is the first user of its triplet becomes a vertex.  Count
+	// them per chunk, prefix sum, then number them in file order.
+	//
+
+	concurrency::parallel_for(size_t(0), chunks.size(), [&](size_t c)
+	{
+		ObjChunk& chunk = chunks[c];
+		for(size_t i = 0; i < chunk.Corners.size(); ++i)
+		{
+			const ObjCorner& corner = chunk.Corners[i];
+			ObjCornerKey key = { corner.V, corner.T, corner.N };
+
+			UINT cornerIndex = chunk.CornerBase + (UINT)i;
+			UINT first = (UINT)weldMap.find(key)->second;
+			firstCorner[cornerIndex] = first;
+			if(first == cornerIndex)
+				++chunk.VertexCount;
+		}
+	});
+
+	UINT vertexCount = 0;
+	for(auto& chunk : chunks)
+	{
+		chunk.VertexBase = vertexCount;
+		vertexCount += chunk.VertexCount;
+	}
+
+	mesh = GeometryGenerator::MeshData();
+	mesh.Vertices.resize(vertexCount);
+	mesh.Indices32.resize(cornerCount);
+
+	// vertexOfCorner is only meaningful for corners that became vertices.
+	std::vector<UINT> vertexOfCorner(cornerCount);
+
+	concurrency::parallel_for(size_t(0), chunks.size(), [&](size_t c)
+	{
+		const ObjChunk& chunk = chunks[c];
+
+		UINT vertex = chunk.VertexBase;
+		for(size_t i = 0; i < chunk.Corners.size(); ++i)
+		{
+			UINT cornerIndex = chunk.CornerBase + (UINT)i;
+			if(firstCorner[cornerIndex] != cornerIndex)
+				continue;
+
+			const ObjCorner& corner = chunk.Corners[i];
+
+			GeometryGenerator::Vertex& v = mesh.Vertices[vertex];
+			v.Position = positions[corner.V];
+			v.Normal = (corner.Flags & CornerHasN) ? normals[corner.N] : XMFLOAT3(0.0f, 0.0f, 0.0f);
+			v.TangentU = XMFLOAT3(0.0f, 0.0f, 0.0f);
+			v.TexC = (corner.Flags & CornerHasT) ? texCoords[corner.T] : XMFLOAT2(0.0f, 0.0f);
+
+			vertexOfCorner[cornerIndex] = vertex++;
+		}
+	});
+
+	concurrency::parallel_for(UINT(0), cornerCount, [&](UINT i)
+	{
+		mesh.Indices32[i] = vertexOfCorner[firstCorner[i]];
+	});
+
+	// OBJ has no tangents.  Normals are only generated when the file is missing some,
+	// so authored hard edges and smoothing survive the import.
+	GeometryGenerator::VertexStreams streams;
+	streams.Position = &mesh.Vertices[0].Position;
+	streams.PositionStride = sizeof(GeometryGenerator::Vertex);
+	streams.TexC = &mesh.Vertices[0].TexC;
+	streams.TexCStride = sizeof(GeometryGenerator::Vertex);
+	streams.Normal = &mesh.Vertices[0].Normal;
+	streams.NormalStride = sizeof(GeometryGenerator::Vertex);
+	streams.TangentU = &mesh.Vertices[0].TangentU;
+	streams.TangentUStride = sizeof(GeometryGenerator::Vertex);
+	streams.VertexCount = vertexCount;
+	streams.KeepNormals = !missingNormals.load();
+
+	GeometryGenerator::ComputeNormalsAndTangents(streams, mesh.Indices32.data(), cornerCount);
+
+	if(options.Benchmark)
+	{
+		LARGE_INTEGER endTime;
+		QueryPerformanceCounter(&endTime);
+
+		double seconds = (double)(endTime.QuadPart - startTime.QuadPart) / (double)frequency.QuadPart;
+		double megabytes = (double)byteSize / (1024.0 * 1024.0);
+
+		char text[256];
+		sprintf_s(text, "ObjLoader: %.1f MB in %.3f s (%.1f MB/s), %zu chunks, %u vertices, %u triangles\n",
+			megabytes, seconds, megabytes / std::max<double>(seconds, 1e-9), chunks.size(), vertexCount, cornerCount / 3);
+		OutputDebugStringA(text);
+	}
+
+	return S_OK;
+}
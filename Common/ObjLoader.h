@@ -0,0 +1,45 @@
+//***************************************************************************************
+// ObjLoader.h
+//
+// Wavefront OBJ importer producing GeometryGenerator::MeshData.  The file is memory
+// mapped and split into line aligned chunks that are parsed in parallel.  Polygons
+// are fan triangulated and identical v/vt/vn triplets are welded into one vertex.
+//
+// Only geometry is imported: v, vt, vn and f records.  Groups, objects, smoothing
+// groups and materials are skipped.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include "GeometryGenerator.h"
+
+class ObjLoader
+{
+public:
+	struct Options
+	{
+		// OBJ is right handed.  Negate z and reverse the winding so the mesh renders
+		// the same way round in our left handed world.
+		bool ConvertToLeftHanded = true;
+
+		// OBJ puts v = 0 at the bottom of the image; Direct3D puts it at the top.
+		bool FlipV = true;
+
+		// Print file size, parse time and throughput (MB/s) to the debugger output.
+		// The app's -importobj=<path> switch loads a file with this set.
+		bool Benchmark = false;
+	};
+
+	///<summary>
+	/// Loads an OBJ file into mesh, replacing its contents.  If any face corner has
+	/// no normal, normals are recomputed for the whole mesh; tangents always are.
+	/// Returns an HRESULT_FROM_WIN32(ERROR_INVALID_DATA) failure on malformed faces.
+	///</summary>
+	static HRESULT Load(
+		const std::wstring& filename,
+		GeometryGenerator::MeshData& mesh,
+		const Options& options);
+
+	static HRESULT Load(const std::wstring& filename, GeometryGenerator::MeshData& mesh);
+};
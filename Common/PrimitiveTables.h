@@ -0,0 +1,303 @@
+//***************************************************************************************
+// PrimitiveTables.h
+//
+// Unit space vertex and index tables for the fixed topology primitives built by
+// GeometryGenerator (box, pyramid, wedge, triangular prism).  The tables are built
+// by constexpr functions, so they live in the executable's read-only data and the
+// Create* functions only have to scale the positions at runtime.
+//
+// Unit space means every position component is in [-0.5, +0.5]; scaling by the
+// primitive's dimensions gives exactly the positions the old code computed.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace PrimitiveTables
+{
+	// Same layout as GeometryGenerator::Vertex, but a literal type so it can be
+	// built at compile time.
+	struct Vertex
+	{
+		float Position[3];
+		float Normal[3];
+		float TangentU[3];
+		float TexC[2];
+	};
+
+	template<std::size_t VertexCount, std::size_t IndexCount>
+	struct Table
+	{
+		static const std::size_t NumVertices = VertexCount;
+		static const std::size_t NumIndices = IndexCount;
+
+		Vertex Vertices[VertexCount];
+		std::uint32_t Indices[IndexCount];
+	};
+
+	namespace Detail
+	{
+		struct Float3
+		{
+			float x, y, z;
+		};
+
+		constexpr void Set(float* dst, Float3 v)
+		{
+			dst[0] = v.x;
+			dst[1] = v.y;
+			dst[2] = v.z;
+		}
+
+		constexpr Vertex MakeVertex(Float3 p, Float3 n, Float3 t, float u, float v)
+		{
+			Vertex vertex{};
+			Set(vertex.Position, p);
+			Set(vertex.Normal, n);
+			Set(vertex.TangentU, t);
+			vertex.TexC[0] = u;
+			vertex.TexC[1] = v;
+			return vertex;
+		}
+
+		template<std::size_t N, std::size_t M>
+		constexpr void CopyIndices(std::uint32_t (&dst)[N], const std::uint32_t (&src)[M])
+		{
+			static_assert(N == M, "index table size mismatch");
+			for(std::size_t i = 0; i < N; ++i)
+				dst[i] = src[i];
+		}
+
+		// A box face: outward normal, tangent (the u direction), the direction v
+		// decreases in, and which corner the face's first vertex is.
+		struct BoxFace
+		{
+			Float3 Normal;
+			Float3 Tangent;
+			Float3 Up;
+			bool StartAtBottomRight;
+		};
+	}
+
+	///<summary>
+	/// 24 vertex / 36 index unit box, four vertices per face so each face has
+	/// its own normal and texture coordinates.
+	///</summary>
+	constexpr Table<24, 36> MakeUnitBox()
+	{
+		using Detail::Float3;
+
+		const Detail::BoxFace faces[6] =
+		{
+			{ {  0.0f,  0.0f, -1.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f, 0.0f }, false }, // front
+			{ {  0.0f,  0.0f,  1.0f }, { -1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f, 0.0f }, true  }, // back
+			{ {  0.0f,  1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f, 1.0f }, false }, // top
+			{ {  0.0f, -1.0f,  0.0f }, { -1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f, 1.0f }, true  }, // bottom
+			{ { -1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }, false }, // left
+			{ {  1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f,  1.0f }, { 0.0f, 1.0f, 0.0f }, false }, // right
+		};
+
+		// Texture coordinates of the four corners, walking the face's winding.
+		const float cornerUV[5][2] = { { 1.0f, 1.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f } };
+
+		Table<24, 36> box{};
+		for(std::size_t f = 0; f < 6; ++f)
+		{
+			const Detail::BoxFace& face = faces[f];
+			const std::size_t first = face.StartAtBottomRight ? 0 : 1;
+
+			for(std::size_t c = 0; c < 4; ++c)
+			{
+				float u = cornerUV[first + c][0];
+				float v = cornerUV[first + c][1];
+
+				// Corner = 0.5*normal + (u - 0.5)*tangent + (0.5 - v)*up.
+				Float3 p =
+				{
+					0.5f * face.Normal.x + (u - 0.5f) * face.Tangent.x + (0.5f - v) * face.Up.x,
+					0.5f * face.Normal.y + (u - 0.5f) * face.Tangent.y + (0.5f - v) * face.Up.y,
+					0.5f * face.Normal.z + (u - 0.5f) * face.Tangent.z + (0.5f - v) * face.Up.z
+				};
+
+				box.Vertices[f * 4 + c] = Detail::MakeVertex(p, face.Normal, face.Tangent, u, v);
+			}
+
+			const std::uint32_t base = (std::uint32_t)(f * 4);
+			box.Indices[f * 6 + 0] = base + 0;
+			box.Indices[f * 6 + 1] = base + 1;
+			box.Indices[f * 6 + 2] = base + 2;
+			box.Indices[f * 6 + 3] = base + 0;
+			box.Indices[f * 6 + 4] = base + 2;
+			box.Indices[f * 6 + 5] = base + 3;
+		}
+
+		return box;
+	}
+
+	///<summary>
+	/// Square based unit pyramid: four base corners and one apex.
+	///</summary>
+	constexpr Table<5, 18> MakeUnitPyramid()
+	{
+		using Detail::Float3;
+
+		const float baseCorners[4][4] =
+		{
+			// x, z, u, v
+			{ -0.5f, -0.5f, 0.0f, 1.0f },
+			{ +0.5f, -0.5f, 1.0f, 1.0f },
+			{ +0.5f, +0.5f, 1.0f, 0.0f },
+			{ -0.5f, +0.5f, 0.0f, 0.0f },
+		};
+
+		Table<5, 18> pyramid{};
+		for(std::size_t i = 0; i < 4; ++i)
+		{
+			pyramid.Vertices[i] = Detail::MakeVertex(
+				Float3{ baseCorners[i][0], -0.5f, baseCorners[i][1] },
+				Float3{ 0.0f, -1.0f, 0.0f }, Float3{ 1.0f, 0.0f, 0.0f },
+				baseCorners[i][2], baseCorners[i][3]);
+		}
+
+		pyramid.Vertices[4] = Detail::MakeVertex(
+			Float3{ 0.0f, 0.5f, 0.0f }, Float3{ 0.0f, 1.0f, 0.0f }, Float3{ 1.0f, 0.0f, 0.0f }, 0.5f, 0.5f);
+
+		const std::uint32_t indices[18] =
+		{
+			// Base
+			0, 1, 2,
+			0, 2, 3,
+
+			// Sides
+			0, 4, 1,
+			1, 4, 2,
+			2, 4, 3,
+			3, 4, 0
+		};
+		Detail::CopyIndices(pyramid.Indices, indices);
+
+		return pyramid;
+	}
+
+	///<summary>
+	/// Unit wedge: a box base whose top edge is only along the front (-z) side.
+	///</summary>
+	constexpr Table<6, 24> MakeUnitWedge()
+	{
+		using Detail::Float3;
+
+		const float corners[6][5] =
+		{
+			// x, y, z, u, v
+			{ -0.5f, -0.5f, -0.5f, 0.0f, 1.0f },
+			{ +0.5f, -0.5f, -0.5f, 1.0f, 1.0f },
+			{ +0.5f, -0.5f, +0.5f, 1.0f, 0.0f },
+			{ -0.5f, -0.5f, +0.5f, 0.0f, 0.0f },
+			{ -0.5f, +0.5f, -0.5f, 0.0f, 1.0f },
+			{ +0.5f, +0.5f, -0.5f, 1.0f, 1.0f },
+		};
+
+		Table<6, 24> wedge{};
+		for(std::size_t i = 0; i < 6; ++i)
+		{
+			float ny = corners[i][1] < 0.0f ? -1.0f : 1.0f;
+			wedge.Vertices[i] = Detail::MakeVertex(
+				Float3{ corners[i][0], corners[i][1], corners[i][2] },
+				Float3{ 0.0f, ny, 0.0f }, Float3{ 1.0f, 0.0f, 0.0f },
+				corners[i][3], corners[i][4]);
+		}
+
+		const std::uint32_t indices[24] =
+		{
+			// Base
+			0, 1, 2,
+			0, 2, 3,
+
+			// Front face
+			0, 4, 1,
+			1, 4, 5,
+
+			// Right face
+			1, 5, 2,
+
+			// Back face
+			2, 5, 3,
+			3, 5, 4,
+
+			// Left face
+			3, 4, 0
+		};
+		Detail::CopyIndices(wedge.Indices, indices);
+
+		return wedge;
+	}
+
+	///<summary>
+	/// Unit triangular prism: the same triangle at the bottom and top caps.
+	///</summary>
+	constexpr Table<6, 24> MakeUnitTriangularPrism()
+	{
+		using Detail::Float3;
+
+		const float triangle[3][4] =
+		{
+			// x, z, u, v
+			{ -0.5f, -0.5f, 0.0f, 1.0f }, // left-back
+			{ +0.5f, -0.5f, 1.0f, 1.0f }, // right-back
+			{  0.0f, +0.5f, 0.5f, 0.0f }, // center-front
+		};
+
+		Table<6, 24> prism{};
+		for(std::size_t cap = 0; cap < 2; ++cap)
+		{
+			float y = cap == 0 ? -0.5f : 0.5f;
+			float ny = cap == 0 ? -1.0f : 1.0f;
+
+			for(std::size_t i = 0; i < 3; ++i)
+			{
+				prism.Vertices[cap * 3 + i] = Detail::MakeVertex(
+					Float3{ triangle[i][0], y, triangle[i][1] },
+					Float3{ 0.0f, ny, 0.0f }, Float3{ 1.0f, 0.0f, 0.0f },
+					triangle[i][2], triangle[i][3]);
+			}
+		}
+
+		const std::uint32_t indices[24] =
+		{
+			// Bottom and top caps
+			0, 1, 2,
+			3, 5, 4,
+
+			// Back face
+			0, 3, 4,
+			0, 4, 1,
+
+			// Right face
+			1, 4, 5,
+			1, 5, 2,
+
+			// Left face
+			2, 5, 3,
+			2, 3, 0
+		};
+		Detail::CopyIndices(prism.Indices, indices);
+
+		return prism;
+	}
+
+	constexpr Table<24, 36> UnitBox = MakeUnitBox();
+	constexpr Table<5, 18> UnitPyramid = MakeUnitPyramid();
+	constexpr Table<6, 24> UnitWedge = MakeUnitWedge();
+	constexpr Table<6, 24> UnitTriangularPrism = MakeUnitTriangularPrism();
+
+	// Spot checks that the generators reproduce the hand written tables.
+	static_assert(UnitBox.Vertices[0].Position[0] == -0.5f && UnitBox.Vertices[0].TexC[1] == 1.0f, "box front face");
+	static_assert(UnitBox.Vertices[4].TexC[0] == 1.0f && UnitBox.Vertices[5].Position[0] == 0.5f, "box back face");
+	static_assert(UnitBox.Vertices[14].Position[2] == 0.5f && UnitBox.Vertices[14].TexC[1] == 0.0f, "box bottom face");
+	static_assert(UnitBox.Vertices[18].Position[2] == -0.5f && UnitBox.Vertices[18].TexC[0] == 1.0f, "box left face");
+	static_assert(UnitBox.Indices[35] == 23, "box indices");
+	static_assert(UnitPyramid.Vertices[4].TexC[0] == 0.5f, "pyramid apex");
+	static_assert(UnitTriangularPrism.Vertices[5].Position[1] == 0.5f, "prism top cap");
+}
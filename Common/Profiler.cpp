@@ -0,0 +1,164 @@
+//***************************************************************************************
+// Profiler.cpp
+//***************************************************************************************
+
+#include "Profiler.h"
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_USE_RDTSC
+#endif
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <iomanip>
+
+namespace
+{
+	struct Event
+	{
+		const char* Name;
+		std::uint64_t Begin;
+		std::uint64_t End;
+	};
+
+	// Written only by its thread; read by WriteChromeTrace between frames.
+	struct ThreadRing
+	{
+		DWORD ThreadId = 0;
+		std::vector<Event> Events;
+		std::atomic<std::uint64_t> Written{ 0 };
+	};
+
+	// Every thread's ring, kept after the thread exits so its scopes can still be
+	// written out.
+	std::mutex gRingsMutex;
+	std::vector<std::unique_ptr<ThreadRing>> gRings;
+
+	ThreadRing& LocalRing()
+	{
+		thread_local ThreadRing* ring = nullptr;
+		if(ring == nullptr)
+		{
+			auto newRing = std::make_unique<ThreadRing>();
+			newRing->ThreadId = GetCurrentThreadId();
+			newRing->Events.resize(Profiler::EventsPerThread);
+
+			std::lock_guard<std::mutex> lock(gRingsMutex);
+			ring = newRing.get();
+			gRings.push_back(std::move(newRing));
+		}
+		return *ring;
+	}
+
+	// A simultaneous reading of Profiler::Ticks and the steady clock.  The tick rate
+	// is measured between two of these, so it needs no invariant TSC frequency query.
+	struct ClockSample
+	{
+		std::uint64_t Ticks;
+		std::chrono::steady_clock::time_point Time;
+	};
+
+	ClockSample SampleClocks()
+	{
+		ClockSample sample;
+		sample.Time = std::chrono::steady_clock::now();
+		sample.Ticks = Profiler::Ticks();
+		return sample;
+	}
+
+	// Writes s as a JSON string, quotes included.  Scope names are usually plain
+	// identifiers, but nothing stops one from holding a quote or a backslash.
+	void WriteJsonString(std::ostream& out, const char* s)
+	{
+		out << '"';
+		for(; *s != '\0'; ++s)
+		{
+			unsigned char c = (unsigned char)*s;
+			if(c == '"' || c == '\\')
+				out << '\\' << (char)c;
+			else if(c < 0x20)
+			{
+				const char* hex = "0123456789abcdef";
+				out << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+			}
+			else
+				out << (char)c;
+		}
+		out << '"';
+	}
+
+	const ClockSample gStartClocks = SampleClocks();
+}
+
+std::uint64_t Profiler::Ticks()
+{
+#if defined(PROFILER_USE_RDTSC)
+	return __rdtsc();
+#else
+	return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void Profiler::Record(const char* name, std::uint64_t beginTicks, std::uint64_t endTicks)
+{
+	ThreadRing& ring = LocalRing();
+
+	std::uint64_t written = ring.Written.load(std::memory_order_relaxed);
+
+	Event& e = ring.Events[written % EventsPerThread];
+	e.Name = name;
+	e.Begin = beginTicks;
+	e.End = endTicks;
+
+	ring.Written.store(written + 1, std::memory_order_release);
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path)
+{
+	std::ofstream file(path);
+	if(!file)
+		return false;
+
+	ClockSample now = SampleClocks();
+
+	double seconds = std::chrono::duration<double>(now.Time - gStartClocks.Time).count();
+	double ticksPerMicrosecond = seconds > 0.0 ? (double)(now.Ticks - gStartClocks.Ticks) / (seconds * 1e6) : 1.0;
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+
+	std::lock_guard<std::mutex> lock(gRingsMutex);
+	for(const auto& ring : gRings)
+	{
+		std::uint64_t written = ring->Written.load(std::memory_order_acquire);
+		std::uint64_t begin = written > EventsPerThread ? written - EventsPerThread : 0;
+
+		for(std::uint64_t i = begin; i < written; ++i)
+		{
+			const Event& e = ring->Events[i % EventsPerThread];
+
+			double ts = (double)(e.Begin - gStartClocks.Ticks) / ticksPerMicrosecond;
+			double dur = (double)(e.End - e.Begin) / ticksPerMicrosecond;
+
+			file << (first ? "\n" : ",\n");
+			file << "{\"name\":";
+			WriteJsonString(file, e.Name);
+			file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->ThreadId
+				<< ",\"ts\":" << ts << ",\"dur\":" << dur << "}";
+			first = false;
+		}
+	}
+
+	file << "\n]}\n";
+	return (bool)file;
+}
+
+void Profiler::Clear()
+{
+	std::lock_guard<std::mutex> lock(gRingsMutex);
+	for(auto& ring : gRings)
+		ring->Written.store(0, std::memory_order_release);
+}
@@ -0,0 +1,79 @@
+//***************************************************************************************
+// Profiler.h
+//
+// Low-overhead scoped CPU timing.  PROFILE_SCOPE("Name") records Profiler::Ticks
+// at the start and end of the enclosing scope into a ring buffer owned by the
+// calling thread.  The first scope a thread records allocates its ring (about
+// 768 KB for EventsPerThread scopes); after that, recording takes no lock and
+// never allocates.  Each thread keeps its last EventsPerThread scopes.
+//
+// WriteChromeTrace converts what the rings hold into the Chrome trace event format
+// (load it in chrome://tracing or Perfetto); nested scopes show up as a hierarchy.
+// Call it between frames, while no other thread is inside a profiled scope.
+//
+// Scope names must outlive the profiler (string literals).  Define DISABLE_PROFILER
+// to compile the markers out.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class Profiler
+{
+public:
+	static const UINT EventsPerThread = 1 << 15;
+
+	///<summary>
+	/// Stores one finished scope in the calling thread's ring.
+	///</summary>
+	static void Record(const char* name, std::uint64_t beginTicks, std::uint64_t endTicks);
+
+	///<summary>
+	/// Writes every recorded scope of every thread to path as Chrome trace JSON.
+	/// Returns false if the file cannot be written.
+	///</summary>
+	static bool WriteChromeTrace(const std::string& path);
+
+	///<summary>
+	/// Drops everything recorded so far, e.g. to trace only the frames that follow.
+	///</summary>
+	static void Clear();
+
+	///<summary>
+	/// The time stamp counter where __rdtsc is available (MSVC on x86/x64),
+	/// otherwise std::chrono::steady_clock in nanoseconds.
+	///</summary>
+	static std::uint64_t Ticks();
+};
+
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* name) :
+		mName(name),
+		mBegin(Profiler::Ticks())
+	{
+	}
+
+	ProfileScope(const ProfileScope& rhs) = delete;
+	ProfileScope& operator=(const ProfileScope& rhs) = delete;
+
+	~ProfileScope()
+	{
+		Profiler::Record(mName, mBegin, Profiler::Ticks());
+	}
+
+private:
+	const char* mName;
+	std::uint64_t mBegin;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if defined(DISABLE_PROFILER)
+#define PROFILE_SCOPE(name)
+#else
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#endif
@@ -0,0 +1,85 @@
+//***************************************************************************************
+// RadixSort.cpp
+//***************************************************************************************
+
+#include "RadixSort.h"
+#include <cstring>
+#include <utility>
+
+namespace
+{
+	template<typename Key>
+	void SortPairsImpl(Key* keys, std::uint32_t* values, Key* scratchKeys, std::uint32_t* scratchValues, std::size_t count)
+	{
+		const int ByteCount = sizeof(Key);
+
+		if(count < 2)
+			return;
+
+		// Histogram of every byte position in a single pass over the keys.
+		std::size_t histograms[ByteCount][256];
+		std::memset(histograms, 0, sizeof(histograms));
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			Key key = keys[i];
+			for(int b = 0; b < ByteCount; ++b)
+				++histograms[b][(key >> (b * 8)) & 0xFF];
+		}
+
+		Key* srcKeys = keys;
+		std::uint32_t* srcValues = values;
+		Key* dstKeys = scratchKeys;
+		std::uint32_t* dstValues = scratchValues;
+
+		for(int b = 0; b < ByteCount; ++b)
+		{
+			std::size_t* histogram = histograms[b];
+
+			// Every key has the same byte here: this pass would not move anything.
+			if(histogram[(srcKeys[0] >> (b * 8)) & 0xFF] == count)
+				continue;
+
+			// Exclusive prefix sum gives each bucket's first output slot.
+			std::size_t offset = 0;
+			for(int d = 0; d < 256; ++d)
+			{
+				std::size_t n = histogram[d];
+				histogram[d] = offset;
+				offset += n;
+			}
+
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				std::size_t slot = histogram[(srcKeys[i] >> (b * 8)) & 0xFF]++;
+				dstKeys[slot] = srcKeys[i];
+				dstValues[slot] = srcValues[i];
+			}
+
+			std::swap(srcKeys, dstKeys);
+			std::swap(srcValues, dstValues);
+		}
+
+		// An odd number of passes leaves the result in the scratch arrays.
+		if(srcKeys != keys)
+		{
+			std::memcpy(keys, srcKeys, count * sizeof(Key));
+			std::memcpy(values, srcValues, count * sizeof(std::uint32_t));
+		}
+	}
+}
+
+void RadixSort::SortPairs(
+	std::uint64_t* keys, std::uint32_t* values,
+	std::uint64_t* scratchKeys, std::uint32_t* scratchValues,
+	std::size_t count)
+{
+	SortPairsImpl(keys, values, scratchKeys, scratchValues, count);
+}
+
+void RadixSort::SortPairs(
+	std::uint32_t* keys, std::uint32_t* values,
+	std::uint32_t* scratchKeys, std::uint32_t* scratchValues,
+	std::size_t count)
+{
+	SortPairsImpl(keys, values, scratchKeys, scratchValues, count);
+}
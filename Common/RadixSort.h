@@ -0,0 +1,31 @@
+//***************************************************************************************
+// RadixSort.h
+//
+// Stable least significant digit radix sort of (key, value) pairs, eight bits per
+// pass.  All byte histograms are built in one read of the keys, and passes whose
+// byte is the same for every key are skipped, so keys that only use their low bits
+// (or share their high bits) cost fewer passes.
+//***************************************************************************************
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace RadixSort
+{
+	///<summary>
+	/// Sorts keys ascending and applies the same permutation to values.  Equal keys
+	/// keep their input order.  The scratch arrays must hold count elements; the
+	/// result always ends up back in keys/values.
+	///</summary>
+	void SortPairs(
+		std::uint64_t* keys, std::uint32_t* values,
+		std::uint64_t* scratchKeys, std::uint32_t* scratchValues,
+		std::size_t count);
+
+	void SortPairs(
+		std::uint32_t* keys, std::uint32_t* values,
+		std::uint32_t* scratchKeys, std::uint32_t* scratchValues,
+		std::size_t count);
+}
@@ -0,0 +1,134 @@
+//***************************************************************************************
+// RenderCommandList.h
+//
+// Thin interface over the part of ID3D12GraphicsCommandList the draw loop records
+// (state, root arguments, barriers and indexed draws), so the same recording code
+// can target a real command list or the CPU-side NullRenderCommandList.  The
+// methods mirror their ID3D12GraphicsCommandList counterparts one to one.
+//
+// D3D12RenderCommandList forwards to an ID3D12GraphicsCommandList it does not own.
+//
+// Only command recording is behind this interface; buffer creation and the fence
+// are behind RenderDevice.  Together with NullRenderDevice, the null list lets a
+// frame run with no window or GPU, though the code still builds against the
+// Windows SDK.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class RenderCommandList
+{
+public:
+	virtual ~RenderCommandList() = default;
+
+	virtual void SetPipelineState(ID3D12PipelineState* pso) = 0;
+	virtual void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature) = 0;
+	virtual void SetDescriptorHeaps(UINT count, ID3D12DescriptorHeap* const* heaps) = 0;
+
+	virtual void RSSetViewports(UINT count, const D3D12_VIEWPORT* viewports) = 0;
+	virtual void RSSetScissorRects(UINT count, const D3D12_RECT* rects) = 0;
+	virtual void OMSetRenderTargets(UINT count, const D3D12_CPU_DESCRIPTOR_HANDLE* rtvs,
+		BOOL singleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv) = 0;
+
+	virtual void IASetVertexBuffers(UINT startSlot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views) = 0;
+	virtual void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view) = 0;
+	virtual void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology) = 0;
+
+	virtual void SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor) = 0;
+	virtual void SetGraphicsRootConstantBufferView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) = 0;
+	virtual void SetGraphicsRootShaderResourceView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address) = 0;
+
+	virtual void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers) = 0;
+
+	virtual void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount,
+		UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) = 0;
+};
+
+class D3D12RenderCommandList : public RenderCommandList
+{
+public:
+	explicit D3D12RenderCommandList(ID3D12GraphicsCommandList* cmdList) :
+		mCmdList(cmdList)
+	{
+	}
+
+	ID3D12GraphicsCommandList* Get()const { return mCmdList; }
+
+	void SetPipelineState(ID3D12PipelineState* pso)override
+	{
+		mCmdList->SetPipelineState(pso);
+	}
+
+	void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)override
+	{
+		mCmdList->SetGraphicsRootSignature(rootSignature);
+	}
+
+	void SetDescriptorHeaps(UINT count, ID3D12DescriptorHeap* const* heaps)override
+	{
+		mCmdList->SetDescriptorHeaps(count, heaps);
+	}
+
+	void RSSetViewports(UINT count, const D3D12_VIEWPORT* viewports)override
+	{
+		mCmdList->RSSetViewports(count, viewports);
+	}
+
+	void RSSetScissorRects(UINT count, const D3D12_RECT* rects)override
+	{
+		mCmdList->RSSetScissorRects(count, rects);
+	}
+
+	void OMSetRenderTargets(UINT count, const D3D12_CPU_DESCRIPTOR_HANDLE* rtvs,
+		BOOL singleHandleToDescriptorRange, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv)override
+	{
+		mCmdList->OMSetRenderTargets(count, rtvs, singleHandleToDescriptorRange, dsv);
+	}
+
+	void IASetVertexBuffers(UINT startSlot, UINT count, const D3D12_VERTEX_BUFFER_VIEW* views)override
+	{
+		mCmdList->IASetVertexBuffers(startSlot, count, views);
+	}
+
+	void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view)override
+	{
+		mCmdList->IASetIndexBuffer(view);
+	}
+
+	void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)override
+	{
+		mCmdList->IASetPrimitiveTopology(topology);
+	}
+
+	void SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor)override
+	{
+		mCmdList->SetGraphicsRootDescriptorTable(rootIndex, baseDescriptor);
+	}
+
+	void SetGraphicsRootConstantBufferView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address)override
+	{
+		mCmdList->SetGraphicsRootConstantBufferView(rootIndex, address);
+	}
+
+	void SetGraphicsRootShaderResourceView(UINT rootIndex, D3D12_GPU_VIRTUAL_ADDRESS address)override
+	{
+		mCmdList->SetGraphicsRootShaderResourceView(rootIndex, address);
+	}
+
+	void ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers)override
+	{
+		mCmdList->ResourceBarrier(count, barriers);
+	}
+
+	void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount,
+		UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation)override
+	{
+		mCmdList->DrawIndexedInstanced(indexCountPerInstance, instanceCount,
+			startIndexLocation, baseVertexLocation, startInstanceLocation);
+	}
+
+private:
+	ID3D12GraphicsCommandList* mCmdList = nullptr;
+};
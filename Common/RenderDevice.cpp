@@ -0,0 +1,95 @@
+//***************************************************************************************
+// RenderDevice.cpp
+//***************************************************************************************
+
+#include "RenderDevice.h"
+#include "FenceWaiter.h"
+
+using Microsoft::WRL::ComPtr;
+
+D3D12RenderDevice::D3D12RenderDevice(ID3D12Device* device, ID3D12CommandQueue* queue, ID3D12Fence* fence,
+	ID3D12GraphicsCommandList* setupCmdList, UINT64& currentFence, FenceWaiter& waiter) :
+	mDevice(device),
+	mQueue(queue),
+	mFence(fence),
+	mSetupCmdList(setupCmdList),
+	mCurrentFence(currentFence),
+	mWaiter(waiter)
+{
+}
+
+MappedBuffer D3D12RenderDevice::CreateUploadBuffer(ID3D12Device* device, UINT64 byteSize)
+{
+	MappedBuffer buffer;
+
+	auto upload = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+	auto desc = CD3DX12_RESOURCE_DESC::Buffer(byteSize);
+	ThrowIfFailed(device->CreateCommittedResource(
+		&upload,
+		D3D12_HEAP_FLAG_NONE,
+		&desc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&buffer.Resource)));
+
+	// The CPU must not write what the GPU may still be reading; that is up to the
+	// caller's fencing, so the buffer can stay mapped.
+	ThrowIfFailed(buffer.Resource->Map(0, nullptr, reinterpret_cast<void**>(&buffer.Cpu)));
+	buffer.Gpu = buffer.Resource->GetGPUVirtualAddress();
+
+	return buffer;
+}
+
+MappedBuffer D3D12RenderDevice::CreateUploadBuffer(UINT64 byteSize)
+{
+	return CreateUploadBuffer(mDevice, byteSize);
+}
+
+ComPtr<ID3D12Resource> D3D12RenderDevice::CreateDefaultBuffer(const void* initData, UINT64 byteSize,
+	ComPtr<ID3D12Resource>& uploadBuffer)
+{
+	return d3dUtil::CreateDefaultBuffer(mDevice, mSetupCmdList, initData, byteSize, uploadBuffer);
+}
+
+ComPtr<ID3D12CommandAllocator> D3D12RenderDevice::CreateCommandAllocator()
+{
+	ComPtr<ID3D12CommandAllocator> allocator;
+	ThrowIfFailed(mDevice->CreateCommandAllocator(
+		D3D12_COMMAND_LIST_TYPE_DIRECT,
+		IID_PPV_ARGS(allocator.GetAddressOf())));
+
+	return allocator;
+}
+
+ComPtr<ID3D12GraphicsCommandList> D3D12RenderDevice::CreateCommandList(ID3D12CommandAllocator* allocator)
+{
+	ComPtr<ID3D12GraphicsCommandList> list;
+	ThrowIfFailed(mDevice->CreateCommandList(
+		0,
+		D3D12_COMMAND_LIST_TYPE_DIRECT,
+		allocator,
+		nullptr,
+		IID_PPV_ARGS(list.GetAddressOf())));
+
+	// Lists are reset before recording, which requires them closed.
+	ThrowIfFailed(list->Close());
+
+	return list;
+}
+
+UINT64 D3D12RenderDevice::Signal()
+{
+	// The fence is set once the GPU has processed everything queued before it.
+	ThrowIfFailed(mQueue->Signal(mFence, ++mCurrentFence));
+	return mCurrentFence;
+}
+
+UINT64 D3D12RenderDevice::CompletedFenceValue()
+{
+	return mFence->GetCompletedValue();
+}
+
+bool D3D12RenderDevice::WaitForFence(UINT64 value)
+{
+	return mWaiter.Wait(mFence, value);
+}
@@ -0,0 +1,105 @@
+//***************************************************************************************
+// RenderDevice.h
+//
+// Thin interface over the device and queue work the app does outside command
+// recording: creating upload and default heap buffers and command lists, and
+// signalling and waiting on the frame fence.  With RenderCommandList it covers
+// everything Update and Draw touch, so a frame can run on NullRenderDevice with no
+// window, no GPU and no D3D12 device.
+//
+// D3D12RenderDevice forwards to a device, queue and fence it does not own.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class FenceWaiter;
+
+// Upload heap buffer returned by RenderDevice::CreateUploadBuffer, mapped for its
+// whole lifetime (releasing the resource unmaps it).  On a device with no GPU,
+// Resource is null, Cpu points into Storage and Gpu is an address made up for the
+// buffer, unique among the device's buffers.
+struct MappedBuffer
+{
+	Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+	std::unique_ptr<BYTE[]> Storage;
+	BYTE* Cpu = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS Gpu = 0;
+};
+
+class RenderDevice
+{
+public:
+	virtual ~RenderDevice() = default;
+
+	///<summary>
+	/// The D3D12 device, or null when there is no GPU.  Only for objects that have
+	/// nothing to do on a null device (root signatures, PSOs, descriptor heaps,
+	/// textures); callers skip creating those when it is null.
+	///</summary>
+	virtual ID3D12Device* NativeDevice()const = 0;
+
+	virtual MappedBuffer CreateUploadBuffer(UINT64 byteSize) = 0;
+
+	///<summary>
+	/// Same as d3dUtil::CreateDefaultBuffer, recording the copy into the device's
+	/// setup command list.  Both buffers are null when there is no GPU.
+	///</summary>
+	virtual Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(const void* initData, UINT64 byteSize,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer) = 0;
+
+	// A direct command allocator, and a direct command list on it created closed.
+	// Null when there is no GPU.
+	virtual Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CreateCommandAllocator() = 0;
+	virtual Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> CreateCommandList(ID3D12CommandAllocator* allocator) = 0;
+
+	///<summary>
+	/// Queues a signal of the next fence value behind everything submitted so far,
+	/// and returns that value.
+	///</summary>
+	virtual UINT64 Signal() = 0;
+
+	virtual UINT64 CompletedFenceValue() = 0;
+
+	///<summary>
+	/// Returns once the fence has reached value.  Returns true if that meant waiting.
+	///</summary>
+	virtual bool WaitForFence(UINT64 value) = 0;
+};
+
+class D3D12RenderDevice : public RenderDevice
+{
+public:
+	///<summary>
+	/// setupCmdList receives CreateDefaultBuffer's copies; the caller resets, closes
+	/// and executes it.  currentFence is the last value signalled on fence, shared
+	/// with code that still signals the queue itself.  Waits go through waiter.
+	///</summary>
+	D3D12RenderDevice(ID3D12Device* device, ID3D12CommandQueue* queue, ID3D12Fence* fence,
+		ID3D12GraphicsCommandList* setupCmdList, UINT64& currentFence, FenceWaiter& waiter);
+
+	// Upload heap buffer on device, for code that has no RenderDevice.
+	static MappedBuffer CreateUploadBuffer(ID3D12Device* device, UINT64 byteSize);
+
+	ID3D12Device* NativeDevice()const override { return mDevice; }
+
+	MappedBuffer CreateUploadBuffer(UINT64 byteSize)override;
+	Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(const void* initData, UINT64 byteSize,
+		Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer)override;
+
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CreateCommandAllocator()override;
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> CreateCommandList(ID3D12CommandAllocator* allocator)override;
+
+	UINT64 Signal()override;
+	UINT64 CompletedFenceValue()override;
+	bool WaitForFence(UINT64 value)override;
+
+private:
+	ID3D12Device* mDevice = nullptr;
+	ID3D12CommandQueue* mQueue = nullptr;
+	ID3D12Fence* mFence = nullptr;
+	ID3D12GraphicsCommandList* mSetupCmdList = nullptr;
+	UINT64& mCurrentFence;
+	FenceWaiter& mWaiter;
+};
@@ -0,0 +1,77 @@
+//***************************************************************************************
+// RenderQueue.cpp
+//***************************************************************************************
+
+#include "RenderQueue.h"
+#include "RadixSort.h"
+
+std::uint64_t RenderQueue::MakeKey(UINT layer, UINT pso, UINT material, UINT geometry, UINT depth)
+{
+	assert(layer < (1u << LayerBits));
+	assert(pso < (1u << PsoBits));
+	assert(material < (1u << MaterialBits));
+	assert(geometry < (1u << GeometryBits));
+	assert(depth < (1u << DepthBits));
+
+	std::uint64_t key = layer;
+	key = (key << PsoBits) | pso;
+	key = (key << MaterialBits) | material;
+	key = (key << GeometryBits) | geometry;
+	key = (key << DepthBits) | depth;
+	return key;
+}
+
+std::uint64_t RenderQueue::MakeBackToFrontKey(UINT layer, UINT pso, UINT material, UINT geometry, UINT depth)
+{
+	assert(layer < (1u << LayerBits));
+	assert(pso < (1u << PsoBits));
+	assert(material < (1u << MaterialBits));
+	assert(geometry < (1u << GeometryBits));
+	assert(depth < (1u << DepthBits));
+
+	const UINT farthest = (1u << DepthBits) - 1;
+
+	std::uint64_t key = layer;
+	key = (key << DepthBits) | (farthest - depth);
+	key = (key << PsoBits) | pso;
+	key = (key << MaterialBits) | material;
+	key = (key << GeometryBits) | geometry;
+	return key;
+}
+
+UINT RenderQueue::QuantizeDepth(float viewDepth, float nearZ, float farZ)
+{
+	const UINT maxDepth = (1u << DepthBits) - 1;
+
+	float t = MathHelper::Clamp((viewDepth - nearZ) / (farZ - nearZ), 0.0f, 1.0f);
+	return std::min<UINT>((UINT)(t * (float)maxDepth), maxDepth);
+}
+
+void RenderQueue::Clear()
+{
+	mKeys.clear();
+	mItems.clear();
+}
+
+void RenderQueue::Reserve(UINT count)
+{
+	mKeys.reserve(count);
+	mItems.reserve(count);
+}
+
+void RenderQueue::Add(std::uint64_t key, UINT item)
+{
+	mKeys.push_back(key);
+	mItems.push_back(item);
+}
+
+void RenderQueue::Sort()
+{
+	if(mScratchKeys.size() < mKeys.size())
+	{
+		mScratchKeys.resize(mKeys.size());
+		mScratchItems.resize(mKeys.size());
+	}
+
+	RadixSort::SortPairs(mKeys.data(), mItems.data(), mScratchKeys.data(), mScratchItems.data(), mKeys.size());
+}
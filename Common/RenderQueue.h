@@ -0,0 +1,74 @@
+//***************************************************************************************
+// RenderQueue.h
+//
+// Per-frame list of draws ordered by a 64-bit sort key.  The key packs, from the
+// most significant bits down, the layer (draw pass), the pipeline state, the
+// material, the geometry and a quantised view depth, so sorting the keys groups
+// draws that share state and the draw loop only has to rebind what changed since
+// the previous draw.  Blended layers use a second layout with the depth, inverted,
+// right below the layer, so they are drawn back to front whatever their state.
+// The keys are sorted with a radix sort together with a 32-bit index into the
+// caller's own draw list.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include <cstdint>
+
+class RenderQueue
+{
+public:
+	// Field widths of the sort key, most significant first.  They add up to 64.
+	static const UINT LayerBits = 4;
+	static const UINT PsoBits = 6;
+	static const UINT MaterialBits = 12;
+	static const UINT GeometryBits = 12;
+	static const UINT DepthBits = 30;
+
+	///<summary>
+	/// Packs the fields into a sort key.  Each value must fit in its field.
+	///</summary>
+	static std::uint64_t MakeKey(UINT layer, UINT pso, UINT material, UINT geometry, UINT depth);
+
+	///<summary>
+	/// Like MakeKey, but orders draws within the layer far to near first and by
+	/// state only among draws at the same quantised depth.
+	///</summary>
+	static std::uint64_t MakeBackToFrontKey(UINT layer, UINT pso, UINT material, UINT geometry, UINT depth);
+
+	///<summary>
+	/// Maps a view space depth to [0, 2^DepthBits), linearly between nearZ and farZ.
+	/// Depths outside that range are clamped.
+	///</summary>
+	static UINT QuantizeDepth(float viewDepth, float nearZ, float farZ);
+
+	// The layer field of a key made by either layout.
+	static UINT KeyLayer(std::uint64_t key) { return (UINT)(key >> (64 - LayerBits)); }
+
+	void Clear();
+	void Reserve(UINT count);
+
+	///<summary>
+	/// Queues the draw with index item in the caller's draw list under key.
+	///</summary>
+	void Add(std::uint64_t key, UINT item);
+
+	///<summary>
+	/// Sorts the queued draws by key.  Draws with equal keys keep the order they
+	/// were added in.
+	///</summary>
+	void Sort();
+
+	UINT Count()const { return (UINT)mKeys.size(); }
+	std::uint64_t Key(UINT i)const { return mKeys[i]; }
+	UINT Item(UINT i)const { return mItems[i]; }
+
+private:
+	std::vector<std::uint64_t> mKeys;
+	std::vector<std::uint32_t> mItems;
+
+	// Ping-pong buffers for the radix sort, kept to avoid reallocating every frame.
+	std::vector<std::uint64_t> mScratchKeys;
+	std::vector<std::uint32_t> mScratchItems;
+};
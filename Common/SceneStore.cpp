@@ -0,0 +1,120 @@
+//***************************************************************************************
+// SceneStore.cpp
+//***************************************************************************************
+
+#include "SceneStore.h"
+
+using namespace DirectX;
+
+void SceneStore::Reserve(UINT count)
+{
+	mWorld.reserve(count);
+	mTexTransform.reserve(count);
+	mBounds.Reserve(count);
+	mGeometry.reserve(count);
+	mMaterial.reserve(count);
+	mLayer.reserve(count);
+	mDraw.reserve(count);
+	mLocalBounds.reserve(count);
+	mHandleOfSlot.reserve(count);
+	mSlotOfHandle.reserve(count);
+	mDirtyBits.reserve((count + 31) / 32);
+}
+
+UINT SceneStore::Create(const SceneItemDesc& desc)
+{
+	UINT handle;
+	if(!mFreeHandles.empty())
+	{
+		handle = mFreeHandles.back();
+		mFreeHandles.pop_back();
+	}
+	else
+	{
+		handle = (UINT)mSlotOfHandle.size();
+		mSlotOfHandle.push_back(InvalidHandle);
+		if(mDirtyBits.size() * 32 < mSlotOfHandle.size())
+			mDirtyBits.push_back(0);
+	}
+
+	UINT slot = Count();
+	mSlotOfHandle[handle] = slot;
+	mHandleOfSlot.push_back(handle);
+
+	BoundingBox worldBounds;
+	desc.LocalBounds.Transform(worldBounds, XMLoadFloat4x4(&desc.World));
+
+	mWorld.push_back(desc.World);
+	mTexTransform.push_back(desc.TexTransform);
+	mBounds.Add(worldBounds);
+	mGeometry.push_back(desc.Geometry);
+	mMaterial.push_back(desc.Material);
+	mLayer.push_back(desc.Layer);
+	mDraw.push_back(desc.Draw);
+	mLocalBounds.push_back(desc.LocalBounds);
+
+	MarkDirty(handle);
+	return handle;
+}
+
+void SceneStore::Destroy(UINT handle)
+{
+	UINT slot = mSlotOfHandle[handle];
+	assert(slot != InvalidHandle);
+
+	// Keep the slots dense: the last item takes over the freed slot.
+	UINT last = Count() - 1;
+	if(slot != last)
+	{
+		UINT movedHandle = mHandleOfSlot[last];
+
+		mWorld[slot] = mWorld[last];
+		mTexTransform[slot] = mTexTransform[last];
+		mBounds.Set(slot, mBounds.Get(last));
+		mGeometry[slot] = mGeometry[last];
+		mMaterial[slot] = mMaterial[last];
+		mLayer[slot] = mLayer[last];
+		mDraw[slot] = mDraw[last];
+		mLocalBounds[slot] = mLocalBounds[last];
+
+		mHandleOfSlot[slot] = movedHandle;
+		mSlotOfHandle[movedHandle] = slot;
+	}
+
+	mWorld.pop_back();
+	mTexTransform.pop_back();
+	mBounds.RemoveLast();
+	mGeometry.pop_back();
+	mMaterial.pop_back();
+	mLayer.pop_back();
+	mDraw.pop_back();
+	mLocalBounds.pop_back();
+	mHandleOfSlot.pop_back();
+
+	mSlotOfHandle[handle] = InvalidHandle;
+	mDirtyBits[handle / 32] &= ~(1u << (handle % 32));
+	mFreeHandles.push_back(handle);
+}
+
+void SceneStore::SetWorld(UINT handle, const XMFLOAT4X4& world)
+{
+	UINT slot = mSlotOfHandle[handle];
+
+	BoundingBox worldBounds;
+	mLocalBounds[slot].Transform(worldBounds, XMLoadFloat4x4(&world));
+
+	mWorld[slot] = world;
+	mBounds.Set(slot, worldBounds);
+	MarkDirty(handle);
+}
+
+void SceneStore::SetTexTransform(UINT handle, const XMFLOAT4X4& texTransform)
+{
+	mTexTransform[mSlotOfHandle[handle]] = texTransform;
+	MarkDirty(handle);
+}
+
+void SceneStore::MarkDirty(UINT handle)
+{
+	mDirtyBits[handle / 32] |= 1u << (handle % 32);
+}
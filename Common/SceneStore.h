@@ -0,0 +1,145 @@
+//***************************************************************************************
+// SceneStore.h
+//
+// Structure-of-arrays storage for the scene's render items.  Each field (world and
+// texture transforms, world bounds, geometry, material, layer, draw arguments) is
+// its own contiguous array, so a pass that needs one or two fields (culling reads
+// the bounds, sorting the ids, constant buffer upload the transforms) streams only
+// those.
+//
+// Items live in dense slots [0, Count()); destroying one moves the last item into
+// its slot.  Callers hold handles instead, which stay valid until the item is
+// destroyed and are small enough to index per-item GPU buffers.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include "FrustumCulling.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit of a non-zero value.
+inline UINT CountTrailingZeros(std::uint32_t value)
+{
+	assert(value != 0);
+#if defined(_MSC_VER)
+	unsigned long bit;
+	_BitScanForward(&bit, value);
+	return (UINT)bit;
+#else
+	return (UINT)__builtin_ctz(value);
+#endif
+}
+
+// Arguments of an item's DrawIndexedInstanced call.
+struct DrawArgs
+{
+	D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+	UINT IndexCount = 0;
+	UINT StartIndexLocation = 0;
+	int BaseVertexLocation = 0;
+};
+
+struct SceneItemDesc
+{
+	DirectX::XMFLOAT4X4 World = MathHelper::Identity4x4();
+	DirectX::XMFLOAT4X4 TexTransform = MathHelper::Identity4x4();
+
+	// Bounds in the item's local space; the store keeps them in world space.
+	DirectX::BoundingBox LocalBounds;
+
+	// Caller defined ids, e.g. handles into geometry and material tables.
+	UINT Geometry = 0;
+	UINT Material = 0;
+	UINT Layer = 0;
+
+	DrawArgs Draw;
+};
+
+class SceneStore
+{
+public:
+	static const UINT InvalidHandle = 0xFFFFFFFF;
+
+	void Reserve(UINT count);
+
+	///<summary>
+	/// Adds an item and returns its handle.  New items start dirty.
+	///</summary>
+	UINT Create(const SceneItemDesc& desc);
+
+	void Destroy(UINT handle);
+
+	///<summary>
+	/// Moves an item, updating its world bounds, and marks it dirty.
+	///</summary>
+	void SetWorld(UINT handle, const DirectX::XMFLOAT4X4& world);
+
+	void SetTexTransform(UINT handle, const DirectX::XMFLOAT4X4& texTransform);
+
+	// Number of live items, which occupy slots [0, Count()).
+	UINT Count()const { return (UINT)mHandleOfSlot.size(); }
+
+	// Every handle ever returned by Create is below this.
+	UINT HandleCapacity()const { return (UINT)mSlotOfHandle.size(); }
+
+	UINT Slot(UINT handle)const { return mSlotOfHandle[handle]; }
+	UINT Handle(UINT slot)const { return mHandleOfSlot[slot]; }
+
+	// Per-slot fields, Count() long.
+	const DirectX::XMFLOAT4X4* Worlds()const { return mWorld.data(); }
+	const DirectX::XMFLOAT4X4* TexTransforms()const { return mTexTransform.data(); }
+	const AabbList& Bounds()const { return mBounds; }
+	const UINT* Geometries()const { return mGeometry.data(); }
+	const UINT* Materials()const { return mMaterial.data(); }
+	const UINT* Layers()const { return mLayer.data(); }
+	const DrawArgs* Draws()const { return mDraw.data(); }
+
+	///<summary>
+	/// Calls changed(handle) for every item created or modified since the last
+	/// call, and clears their dirty bits.
+	///</summary>
+	template<typename F>
+	void FlushDirty(F changed)
+	{
+		for(UINT word = 0; word < (UINT)mDirtyBits.size(); ++word)
+		{
+			std::uint32_t bits = mDirtyBits[word];
+			mDirtyBits[word] = 0;
+
+			while(bits != 0)
+			{
+				UINT bit = CountTrailingZeros(bits);
+				bits &= bits - 1;
+
+				changed(word * 32 + bit);
+			}
+		}
+	}
+
+private:
+	void MarkDirty(UINT handle);
+
+private:
+	// Hot per-slot fields.
+	std::vector<DirectX::XMFLOAT4X4> mWorld;
+	std::vector<DirectX::XMFLOAT4X4> mTexTransform;
+	AabbList mBounds;
+	std::vector<UINT> mGeometry;
+	std::vector<UINT> mMaterial;
+	std::vector<UINT> mLayer;
+	std::vector<DrawArgs> mDraw;
+
+	// Only read when an item moves.
+	std::vector<DirectX::BoundingBox> mLocalBounds;
+
+	// Handle <-> slot indirection.  Destroyed handles are reused.
+	std::vector<UINT> mHandleOfSlot;
+	std::vector<UINT> mSlotOfHandle;
+	std::vector<UINT> mFreeHandles;
+
+	// One bit per handle, in 32-bit words so the bit scan also works in x86 builds.
+	std::vector<std::uint32_t> mDirtyBits;
+};
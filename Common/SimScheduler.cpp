@@ -0,0 +1,54 @@
+//***************************************************************************************
+// SimScheduler.cpp
+//***************************************************************************************
+
+#include "SimScheduler.h"
+
+UINT SimScheduler::AddSystem(const std::string& name, float hz, StepFunction step, UINT maxStepsPerFrame)
+{
+	assert(hz > 0.0f && maxStepsPerFrame > 0);
+
+	System system;
+	system.Name = name;
+	system.StepSeconds = 1.0f / hz;
+	system.MaxStepsPerFrame = maxStepsPerFrame;
+	system.Step = std::move(step);
+
+	mSystems.push_back(std::move(system));
+	return (UINT)mSystems.size() - 1;
+}
+
+void SimScheduler::Advance(float frameSeconds)
+{
+	for(System& system : mSystems)
+	{
+		// Accumulate in double so long runs do not lose the fraction of a step.
+		system.Accumulator += std::max<float>(frameSeconds, 0.0f);
+
+		UINT steps = 0;
+		while(system.Accumulator >= system.StepSeconds && steps < system.MaxStepsPerFrame)
+		{
+			system.Step(system.StepSeconds);
+			system.Accumulator -= system.StepSeconds;
+			++steps;
+		}
+
+		// Over budget: drop the whole steps still owed and keep the partial one, so
+		// the simulation slows down rather than falling further behind.
+		if(system.Accumulator >= system.StepSeconds)
+		{
+			std::uint64_t dropped = (std::uint64_t)(system.Accumulator / system.StepSeconds);
+			system.Accumulator -= dropped * (double)system.StepSeconds;
+			system.DroppedSteps += dropped;
+		}
+
+		system.StepsLastFrame = steps;
+		system.TotalSteps += steps;
+	}
+}
+
+float SimScheduler::Alpha(UINT system)const
+{
+	const System& s = mSystems[system];
+	return std::min<float>((float)(s.Accumulator / s.StepSeconds), 0.999999f);
+}
@@ -0,0 +1,68 @@
+//***************************************************************************************
+// SimScheduler.h
+//
+// Runs simulation systems at fixed rates, independent of the frame rate.  Each frame
+// the scheduler is advanced by the frame's duration and every system runs as many
+// whole steps of its own length as the accumulated time allows, so a system always
+// sees the same dt and behaves the same at 30 or 300 fps.
+//
+// After a long frame a system runs at most its MaxStepsPerFrame steps and the rest of
+// the time is dropped, which bounds simulation cost per frame instead of letting it
+// spiral.  Alpha tells the renderer how far the leftover time is into the next step,
+// for interpolating between the last two simulated states.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+#include <functional>
+
+class SimScheduler
+{
+public:
+	typedef std::function<void(float stepSeconds)> StepFunction;
+
+	///<summary>
+	/// Registers a system stepped hz times per simulated second and returns its id.
+	/// Systems step in the order they were added.
+	///</summary>
+	UINT AddSystem(const std::string& name, float hz, StepFunction step, UINT maxStepsPerFrame = 4);
+
+	///<summary>
+	/// Advances simulated time by frameSeconds, running the systems' due steps.
+	///</summary>
+	void Advance(float frameSeconds);
+
+	///<summary>
+	/// Fraction of system's next step already elapsed, in [0, 1).
+	///</summary>
+	float Alpha(UINT system)const;
+
+	float StepSeconds(UINT system)const { return mSystems[system].StepSeconds; }
+	UINT StepsLastFrame(UINT system)const { return mSystems[system].StepsLastFrame; }
+	std::uint64_t TotalSteps(UINT system)const { return mSystems[system].TotalSteps; }
+
+	// Steps skipped because a frame needed more than MaxStepsPerFrame.
+	std::uint64_t DroppedSteps(UINT system)const { return mSystems[system].DroppedSteps; }
+
+	const std::string& Name(UINT system)const { return mSystems[system].Name; }
+	UINT SystemCount()const { return (UINT)mSystems.size(); }
+
+private:
+	struct System
+	{
+		std::string Name;
+		float StepSeconds = 0.0f;
+		UINT MaxStepsPerFrame = 0;
+		StepFunction Step;
+
+		// Simulated time not yet consumed by a step.
+		double Accumulator = 0.0;
+
+		UINT StepsLastFrame = 0;
+		std::uint64_t TotalSteps = 0;
+		std::uint64_t DroppedSteps = 0;
+	};
+
+	std::vector<System> mSystems;
+};
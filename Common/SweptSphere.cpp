@@ -0,0 +1,197 @@
+//***************************************************************************************
+// SweptSphere.cpp
+//***************************************************************************************
+
+#include "SweptSphere.h"
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+	// Smallest root of a*t^2 + b*t + c = 0, if the quadratic has real roots and
+	// a is not degenerate.
+	bool SmallestRoot(float a, float b, float c, float& t)
+	{
+		if(a < 1e-12f)
+			return false;
+
+		float disc = b*b - 4.0f*a*c;
+		if(disc < 0.0f)
+			return false;
+
+		t = (-b - std::sqrt(disc)) / (2.0f*a);
+		return true;
+	}
+}
+
+bool SweptSphere::IntersectAabb(
+	const BoundingBox& box,
+	const XMFLOAT3& center,
+	float radius,
+	const XMFLOAT3& displacement,
+	float maxT,
+	Hit& hit)
+{
+	const float c[3] = { center.x, center.y, center.z };
+	const float d[3] = { displacement.x, displacement.y, displacement.z };
+	const float bmin[3] = { box.Center.x - box.Extents.x, box.Center.y - box.Extents.y, box.Center.z - box.Extents.z };
+	const float bmax[3] = { box.Center.x + box.Extents.x, box.Center.y + box.Extents.y, box.Center.z + box.Extents.z };
+
+	//
+	// Already touching: report a hit at T = 0.
+	//
+
+	float closest[3];
+	float dist2 = 0.0f;
+	for(int a = 0; a < 3; ++a)
+	{
+		closest[a] = MathHelper::Clamp(c[a], bmin[a], bmax[a]);
+		dist2 += (c[a] - closest[a]) * (c[a] - closest[a]);
+	}
+
+	if(dist2 <= radius*radius)
+	{
+		float n[3] = { 0.0f, 0.0f, 0.0f };
+		if(dist2 > 1e-12f)
+		{
+			float invDist = 1.0f / std::sqrt(dist2);
+			for(int a = 0; a < 3; ++a)
+				n[a] = (c[a] - closest[a]) * invDist;
+		}
+		else
+		{
+			// Center inside the box: leave through the nearest face.
+			float best = MathHelper::Infinity;
+			for(int a = 0; a < 3; ++a)
+			{
+				if(c[a] - bmin[a] < best) { best = c[a] - bmin[a]; n[0] = n[1] = n[2] = 0.0f; n[a] = -1.0f; }
+				if(bmax[a] - c[a] < best) { best = bmax[a] - c[a]; n[0] = n[1] = n[2] = 0.0f; n[a] = +1.0f; }
+			}
+		}
+
+		hit.T = 0.0f;
+		hit.Normal = XMFLOAT3(n[0], n[1], n[2]);
+		return true;
+	}
+
+	//
+	// Otherwise find the earliest entry into the box grown by the radius.
+	//
+
+	float tBest = maxT;
+	bool found = false;
+
+	auto consider = [&](float t)
+	{
+		if(t >= 0.0f && t <= tBest)
+		{
+			tBest = t;
+			found = true;
+		}
+	};
+
+	// Faces: the planes bmin - r and bmax + r, hit inside the face rectangle.
+	for(int a = 0; a < 3; ++a)
+	{
+		if(d[a] == 0.0f)
+			continue;
+
+		float plane = d[a] > 0.0f ? bmin[a] - radius : bmax[a] + radius;
+		float t = (plane - c[a]) / d[a];
+
+		int b = (a + 1) % 3;
+		int e = (a + 2) % 3;
+		float pb = c[b] + t*d[b];
+		float pe = c[e] + t*d[e];
+		if(pb >= bmin[b] && pb <= bmax[b] && pe >= bmin[e] && pe <= bmax[e])
+			consider(t);
+	}
+
+	// Edges: cylinders of the given radius around the twelve box edges.  An edge
+	// along axis a sits at one of the four (min/max, min/max) corners of the other
+	// two axes, and only counts where the hit lies within the edge's length.
+	for(int a = 0; a < 3; ++a)
+	{
+		int b = (a + 1) % 3;
+		int e = (a + 2) % 3;
+
+		for(int corner = 0; corner < 4; ++corner)
+		{
+			float ub = (corner & 1) ? bmax[b] : bmin[b];
+			float ue = (corner & 2) ? bmax[e] : bmin[e];
+
+			float qb = c[b] - ub;
+			float qe = c[e] - ue;
+
+			float t;
+			if(!SmallestRoot(d[b]*d[b] + d[e]*d[e], 2.0f*(qb*d[b] + qe*d[e]), qb*qb + qe*qe - radius*radius, t))
+				continue;
+
+			float pa = c[a] + t*d[a];
+			if(pa >= bmin[a] && pa <= bmax[a])
+				consider(t);
+		}
+	}
+
+	// Corners: spheres of the given radius around the eight box corners.
+	for(int corner = 0; corner < 8; ++corner)
+	{
+		float q[3];
+		for(int a = 0; a < 3; ++a)
+			q[a] = c[a] - ((corner >> a) & 1 ? bmax[a] : bmin[a]);
+
+		float t;
+		if(SmallestRoot(
+			d[0]*d[0] + d[1]*d[1] + d[2]*d[2],
+			2.0f*(q[0]*d[0] + q[1]*d[1] + q[2]*d[2]),
+			q[0]*q[0] + q[1]*q[1] + q[2]*q[2] - radius*radius, t))
+		{
+			consider(t);
+		}
+	}
+
+	if(!found)
+		return false;
+
+	// The normal at contact points from the nearest point on the box to the center.
+	float n[3];
+	float len2 = 0.0f;
+	for(int a = 0; a < 3; ++a)
+	{
+		float p = c[a] + tBest*d[a];
+		n[a] = p - MathHelper::Clamp(p, bmin[a], bmax[a]);
+		len2 += n[a]*n[a];
+	}
+
+	float invLen = len2 > 1e-12f ? 1.0f / std::sqrt(len2) : 0.0f;
+	hit.T = tBest;
+	hit.Normal = XMFLOAT3(n[0]*invLen, n[1]*invLen, n[2]*invLen);
+	return true;
+}
+
+bool SweptSphere::IntersectObb(
+	const BoundingOrientedBox& box,
+	const XMFLOAT3& center,
+	float radius,
+	const XMFLOAT3& displacement,
+	float maxT,
+	Hit& hit)
+{
+	// World -> box space is the inverse rotation about the box center.
+	XMVECTOR orientation = XMLoadFloat4(&box.Orientation);
+	XMVECTOR inverse = XMQuaternionInverse(orientation);
+	XMVECTOR boxCenter = XMLoadFloat3(&box.Center);
+
+	XMFLOAT3 localCenter;
+	XMFLOAT3 localDisplacement;
+	XMStoreFloat3(&localCenter, XMVector3Rotate(XMVectorSubtract(XMLoadFloat3(&center), boxCenter), inverse));
+	XMStoreFloat3(&localDisplacement, XMVector3Rotate(XMLoadFloat3(&displacement), inverse));
+
+	BoundingBox localBox(XMFLOAT3(0.0f, 0.0f, 0.0f), box.Extents);
+	if(!IntersectAabb(localBox, localCenter, radius, localDisplacement, maxT, hit))
+		return false;
+
+	XMStoreFloat3(&hit.Normal, XMVector3Rotate(XMLoadFloat3(&hit.Normal), orientation));
+	return true;
+}
@@ -0,0 +1,51 @@
+//***************************************************************************************
+// SweptSphere.h
+//
+// Continuous (swept) sphere tests.  A sphere moving along a segment first touches
+// a box when its center first enters the box grown by the radius: the Minkowski
+// sum of the box and the sphere, whose surface is made of six face rectangles,
+// twelve edge cylinders and eight corner spheres (Ericson, Real-Time Collision
+// Detection, 5.5.7).  The earliest hit over those features is the time of impact.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+namespace SweptSphere
+{
+	struct Hit
+	{
+		// Fraction of the displacement travelled before first contact, in [0, 1].
+		float T = 1.0f;
+
+		// Unit contact normal, pointing from the box towards the sphere.
+		DirectX::XMFLOAT3 Normal = { 0.0f, 0.0f, 0.0f };
+	};
+
+	///<summary>
+	/// Sweeps the sphere (center, radius) along displacement against an axis aligned
+	/// box.  Returns true and fills hit if they touch at some T in [0, maxT].  A
+	/// sphere that already overlaps the box hits at T = 0, with the normal pushing
+	/// it out the shortest way.
+	///</summary>
+	bool IntersectAabb(
+		const DirectX::BoundingBox& box,
+		const DirectX::XMFLOAT3& center,
+		float radius,
+		const DirectX::XMFLOAT3& displacement,
+		float maxT,
+		Hit& hit);
+
+	///<summary>
+	/// Oriented box version: the sweep is moved into the box's frame, tested as an
+	/// axis aligned box there, and the normal is rotated back.
+	///</summary>
+	bool IntersectObb(
+		const DirectX::BoundingOrientedBox& box,
+		const DirectX::XMFLOAT3& center,
+		float radius,
+		const DirectX::XMFLOAT3& displacement,
+		float maxT,
+		Hit& hit);
+}
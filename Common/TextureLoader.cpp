@@ -0,0 +1,105 @@
+//***************************************************************************************
+// TextureLoader.cpp
+//***************************************************************************************
+
+#include "TextureLoader.h"
+#include "Profiler.h"
+#include <ppltasks.h>
+
+namespace
+{
+	// Written by the file's task, read by the calling thread once the task is done.
+	struct TextureFile
+	{
+		HRESULT Result = E_PENDING;
+		DirectX::DDSTextureData12 Data;
+	};
+
+	// Waits for every task when it goes out of scope, so however Load exits (a
+	// failed file, or an exception rethrown by wait()), no read is left running
+	// into the buffers it was given.
+	class TaskJoin
+	{
+	public:
+		explicit TaskJoin(std::vector<concurrency::task<void>>& tasks) :
+			mTasks(tasks)
+		{
+		}
+
+		TaskJoin(const TaskJoin& rhs) = delete;
+		TaskJoin& operator=(const TaskJoin& rhs) = delete;
+
+		~TaskJoin()
+		{
+			for(auto& task : mTasks)
+			{
+				// A task's own exception has either been reported already or is
+				// lost to the one Load is unwinding with.
+				try
+				{
+					task.wait();
+				}
+				catch(...)
+				{
+				}
+			}
+		}
+
+	private:
+		std::vector<concurrency::task<void>>& mTasks;
+	};
+}
+
+void TextureLoader::Add(const std::string& name, const std::wstring& filename)
+{
+	auto tex = std::make_unique<Texture>();
+	tex->Name = name;
+	tex->Filename = filename;
+	mPending.push_back(std::move(tex));
+}
+
+std::vector<std::unique_ptr<Texture>> TextureLoader::Load(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList)
+{
+	PROFILE_SCOPE("Load textures");
+
+	std::vector<std::unique_ptr<Texture>> textures = std::move(mPending);
+	mPending.clear();
+
+	// Sized up front: the tasks hold pointers into it.
+	std::vector<TextureFile> files(textures.size());
+
+	std::vector<concurrency::task<void>> reads;
+	reads.reserve(textures.size());
+	TaskJoin joinReads(reads);
+	for(size_t i = 0; i < textures.size(); ++i)
+	{
+		TextureFile* file = &files[i];
+		const wchar_t* filename = textures[i]->Filename.c_str();
+
+		reads.push_back(concurrency::create_task([file, filename]()
+		{
+			PROFILE_SCOPE("Read texture");
+			file->Result = DirectX::LoadDDSTextureData12(filename, file->Data);
+		}));
+	}
+
+	HRESULT hr = S_OK;
+	for(size_t i = 0; i < textures.size() && SUCCEEDED(hr); ++i)
+	{
+		reads[i].wait();
+
+		hr = files[i].Result;
+		if(SUCCEEDED(hr))
+		{
+			hr = DirectX::CreateDDSTextureFromData12(device, cmdList, files[i].Data,
+				textures[i]->Resource, textures[i]->UploadHeap);
+		}
+
+		// The texels are in the upload heap now.
+		files[i].Data = DirectX::DDSTextureData12();
+	}
+
+	ThrowIfFailed(hr);
+
+	return textures;
+}
@@ -0,0 +1,32 @@
+//***************************************************************************************
+// TextureLoader.h
+//
+// Loads a batch of DDS textures with the file reads spread over worker threads.
+// Each file is mapped, paged in and parsed by its own task on the concurrency
+// runtime's thread pool; only resource creation and upload recording, which need
+// the command list, stay on the calling thread.  Textures are created in the order they were
+// added, each as soon as its file is ready, so creation overlaps the reads still in
+// flight and the batch takes about as long as the disk needs for the files.
+//***************************************************************************************
+
+#pragma once
+
+#include "d3dUtil.h"
+
+class TextureLoader
+{
+public:
+	void Add(const std::string& name, const std::wstring& filename);
+
+	UINT Count()const { return (UINT)mPending.size(); }
+
+	///<summary>
+	/// Loads every added texture, recording the uploads on cmdList, and empties the
+	/// batch.  The upload heaps must be kept alive until cmdList has executed.
+	/// Throws DxException if any file cannot be loaded.
+	///</summary>
+	std::vector<std::unique_ptr<Texture>> Load(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList);
+
+private:
+	std::vector<std::unique_ptr<Texture>> mPending;
+};
@@ -1,37 +1,23 @@
 #pragma once
 
-#include "d3dUtil.h"
+#include "RenderDevice.h"
 
 template<typename T>
 class UploadBuffer
 {
 public:
-    UploadBuffer(ID3D12Device* device, UINT elementCount, bool isConstantBuffer) : 
+    UploadBuffer(RenderDevice* device, UINT elementCount, bool isConstantBuffer) : 
         mIsConstantBuffer(isConstantBuffer)
     {
-        mElementByteSize = sizeof(T);
-
-        // Constant buffer elements need to be multiples of 256 bytes.
-        // This is because the hardware can only view constant data 
-        // at m*256 byte offsets and of n*256 byte lengths. 
-        // typedef struct D3D12_CONSTANT_BUFFER_VIEW_DESC {
-        // UINT64 OffsetInBytes; // multiple of 256
-        // UINT   SizeInBytes;   // multiple of 256
-        // } D3D12_CONSTANT_BUFFER_VIEW_DESC;
-        if(isConstantBuffer)
-            mElementByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(T));
-
-        auto upload = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-        auto buffer = CD3DX12_RESOURCE_DESC::Buffer(mElementByteSize * elementCount);
-        ThrowIfFailed(device->CreateCommittedResource(
-            &upload,
-            D3D12_HEAP_FLAG_NONE,
-            &buffer,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(&mUploadBuffer)));
+        mElementByteSize = ElementByteSize(isConstantBuffer);
+        mUploadBuffer = device->CreateUploadBuffer(UINT64(mElementByteSize) * elementCount);
+    }
 
-        ThrowIfFailed(mUploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mMappedData)));
+    UploadBuffer(ID3D12Device* device, UINT elementCount, bool isConstantBuffer) : 
+        mIsConstantBuffer(isConstantBuffer)
+    {
+        mElementByteSize = ElementByteSize(isConstantBuffer);
+        mUploadBuffer = D3D12RenderDevice::CreateUploadBuffer(device, UINT64(mElementByteSize) * elementCount);
 
         // We do not need to unmap until we are done with the resource.  However, we must not write to
         // the resource while it is in use by the GPU (so we must use synchronization techniques).
@@ -39,27 +25,43 @@ public:
 
     UploadBuffer(const UploadBuffer& rhs) = delete;
     UploadBuffer& operator=(const UploadBuffer& rhs) = delete;
-    ~UploadBuffer()
-    {
-        if(mUploadBuffer != nullptr)
-            mUploadBuffer->Unmap(0, nullptr);
+    ~UploadBuffer() = default;
 
-        mMappedData = nullptr;
+    // Null when the buffer lives in system memory (NullRenderDevice).
+    ID3D12Resource* Resource()const
+    {
+        return mUploadBuffer.Resource.Get();
     }
 
-    ID3D12Resource* Resource()const
+    D3D12_GPU_VIRTUAL_ADDRESS GpuAddress()const
     {
-        return mUploadBuffer.Get();
+        return mUploadBuffer.Gpu;
     }
 
     void CopyData(int elementIndex, const T& data)
     {
-        memcpy(&mMappedData[elementIndex*mElementByteSize], &data, sizeof(T));
+        memcpy(&mUploadBuffer.Cpu[elementIndex*mElementByteSize], &data, sizeof(T));
+    }
+
+private:
+    static UINT ElementByteSize(bool isConstantBuffer)
+    {
+        // Constant buffer elements need to be multiples of 256 bytes.
+        // This is because the hardware can only view constant data 
+        // at m*256 byte offsets and of n*256 byte lengths. 
+        // typedef struct D3D12_CONSTANT_BUFFER_VIEW_DESC {
+        // UINT64 OffsetInBytes; // multiple of 256
+        // UINT   SizeInBytes;   // multiple of 256
+        // } D3D12_CONSTANT_BUFFER_VIEW_DESC;
+        if(isConstantBuffer)
+            return d3dUtil::CalcConstantBufferByteSize(sizeof(T));
+
+        return sizeof(T);
     }
 
 private:
-    Microsoft::WRL::ComPtr<ID3D12Resource> mUploadBuffer;
-    BYTE* mMappedData = nullptr;
+    // Released (and so unmapped) with the buffer.
+    MappedBuffer mUploadBuffer;
 
     UINT mElementByteSize = 0;
     bool mIsConstantBuffer = false;
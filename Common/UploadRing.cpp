@@ -0,0 +1,110 @@
+//***************************************************************************************
+// UploadRing.cpp
+//***************************************************************************************
+
+#include "UploadRing.h"
+
+namespace
+{
+	// Buffers are sized in whole 64KB resource pages, which also keeps every
+	// supported alignment intact across the wrap back to offset 0.
+	const UINT64 PageSize = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+	UINT64 AlignUp(UINT64 value, UINT64 alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+}
+
+UploadRing::UploadRing(RenderDevice* device, UINT64 byteSize) :
+	mDevice(device)
+{
+	CreateBuffer(byteSize);
+}
+
+UploadRing::Allocation UploadRing::Allocate(UINT64 byteSize, UINT64 alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && alignment <= PageSize);
+
+	for(;;)
+	{
+		UINT64 offset = AlignUp(mHead, alignment);
+
+		// An allocation never straddles the end of the buffer: skip the rest of it
+		// and start again at the beginning.
+		UINT64 position = offset % mSize;
+		if(position + byteSize > mSize)
+		{
+			offset += mSize - position;
+			position = 0;
+		}
+
+		if(offset + byteSize - mTail <= mSize)
+		{
+			mFrameBytes += offset + byteSize - mHead;
+			mHead = offset + byteSize;
+			mHighWaterMark = std::max<UINT64>(mHighWaterMark, mHead - mTail);
+
+			Allocation allocation;
+			allocation.Cpu = mBuffer.Cpu + position;
+			allocation.Gpu = mBuffer.Gpu + position;
+			return allocation;
+		}
+
+		Grow(byteSize + alignment);
+	}
+}
+
+void UploadRing::EndFrame(UINT64 fenceValue)
+{
+	mFrames.push_back({ fenceValue, mHead });
+
+	for(auto& retired : mRetired)
+	{
+		if(retired.Fence == 0)
+			retired.Fence = fenceValue;
+	}
+
+	mLastFrameBytes = mFrameBytes;
+	mFrameBytes = 0;
+}
+
+void UploadRing::Reclaim(UINT64 completedFenceValue)
+{
+	while(!mFrames.empty() && mFrames.front().Fence <= completedFenceValue)
+	{
+		mTail = mFrames.front().End;
+		mFrames.pop_front();
+	}
+
+	mRetired.erase(std::remove_if(mRetired.begin(), mRetired.end(),
+		[&](const RetiredBuffer& retired)
+		{
+			return retired.Fence != 0 && retired.Fence <= completedFenceValue;
+		}),
+		mRetired.end());
+}
+
+void UploadRing::CreateBuffer(UINT64 byteSize)
+{
+	mSize = AlignUp(std::max<UINT64>(byteSize, PageSize), PageSize);
+
+	// Upload heaps may stay mapped for their whole lifetime.
+	mBuffer = mDevice->CreateUploadBuffer(mSize);
+}
+
+void UploadRing::Grow(UINT64 minByteSize)
+{
+	// Frames still in flight keep reading the old buffer, so it is released only
+	// once the frame that is open now (the last one to use it) has completed.
+	RetiredBuffer retired;
+	retired.Fence = 0;
+	retired.Buffer = std::move(mBuffer);
+	mRetired.push_back(std::move(retired));
+
+	CreateBuffer(std::max<UINT64>(2 * mSize, 2 * minByteSize));
+
+	mHead = 0;
+	mTail = 0;
+	mFrames.clear();
+}
@@ -0,0 +1,107 @@
+//***************************************************************************************
+// UploadRing.h
+//
+// Linear ring allocator over one persistently mapped upload heap buffer, for data
+// the CPU rewrites every frame (pass and per-draw constants, instance data).  An
+// allocation is a pointer bump; the CPU writes through the returned pointer and
+// binds the returned GPU address directly as a root CBV/SRV.
+//
+// Each frame's allocations are tagged with that frame's fence value by EndFrame and
+// reclaimed by Reclaim once the GPU has passed it.  When the live allocations do not
+// fit, the ring moves to a larger buffer; the old one is kept alive until the frames
+// that used it have completed, so callers never have to wait or rebuild anything.
+//***************************************************************************************
+
+#pragma once
+
+#include "RenderDevice.h"
+#include <deque>
+
+class UploadRing
+{
+public:
+	struct Allocation
+	{
+		void* Cpu = nullptr;
+		D3D12_GPU_VIRTUAL_ADDRESS Gpu = 0;
+	};
+
+	UploadRing(RenderDevice* device, UINT64 byteSize);
+	UploadRing(const UploadRing& rhs) = delete;
+	UploadRing& operator=(const UploadRing& rhs) = delete;
+
+	///<summary>
+	/// Returns byteSize bytes aligned to alignment (a power of two; the default
+	/// suits constant buffer views), growing the ring if needed.
+	///</summary>
+	Allocation Allocate(UINT64 byteSize, UINT64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	///<summary>
+	/// Copies data into a new constant buffer sized allocation and returns its GPU
+	/// address.
+	///</summary>
+	template<typename T>
+	D3D12_GPU_VIRTUAL_ADDRESS AllocateConstants(const T& data)
+	{
+		Allocation a = Allocate(sizeof(T));
+		memcpy(a.Cpu, &data, sizeof(T));
+		return a.Gpu;
+	}
+
+	///<summary>
+	/// Closes the current frame: everything allocated since the last call is freed
+	/// once the GPU reaches fenceValue.
+	///</summary>
+	void EndFrame(UINT64 fenceValue);
+
+	///<summary>
+	/// Frees the frames (and retired buffers) the GPU has finished with.
+	///</summary>
+	void Reclaim(UINT64 completedFenceValue);
+
+	UINT64 Capacity()const { return mSize; }
+
+	// Bytes allocated by the last frame closed with EndFrame.
+	UINT64 LastFrameBytes()const { return mLastFrameBytes; }
+
+	// Most bytes in use at once (over all frames in flight) since creation.
+	UINT64 HighWaterMark()const { return mHighWaterMark; }
+
+private:
+	void CreateBuffer(UINT64 byteSize);
+	void Grow(UINT64 minByteSize);
+
+private:
+	struct FrameMark
+	{
+		UINT64 Fence;
+		UINT64 End;
+	};
+
+	struct RetiredBuffer
+	{
+		UINT64 Fence;
+		MappedBuffer Buffer;
+	};
+
+	RenderDevice* mDevice = nullptr;
+
+	MappedBuffer mBuffer;
+	UINT64 mSize = 0;
+
+	// Monotonic byte counters; the offset into the buffer is the counter modulo
+	// mSize.  [mTail, mHead) is in use by the CPU or GPU.
+	UINT64 mHead = 0;
+	UINT64 mTail = 0;
+
+	// Bytes allocated (including alignment padding) since the last EndFrame.
+	UINT64 mFrameBytes = 0;
+
+	std::deque<FrameMark> mFrames;
+
+	// Buffers replaced by Grow.  A Fence of 0 means "used by the open frame".
+	std::vector<RetiredBuffer> mRetired;
+
+	UINT64 mLastFrameBytes = 0;
+	UINT64 mHighWaterMark = 0;
+};
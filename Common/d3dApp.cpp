@@ -3,6 +3,8 @@
 //***************************************************************************************
 
 #include "d3dApp.h"
+#include "Profiler.h"
+#include "NullRenderDevice.h"
 #include <WindowsX.h>
 
 using Microsoft::WRL::ComPtr;
@@ -33,7 +35,7 @@ D3DApp::D3DApp(HINSTANCE hInstance)
 
 D3DApp::~D3DApp()
 {
-	if(md3dDevice != nullptr)
+	if(mRenderDevice != nullptr)
 		FlushCommandQueue();
 }
 
@@ -69,11 +71,35 @@ void D3DApp::Set4xMsaaState(bool value)
     }
 }
 
+void D3DApp::SetHeadless(bool headless)
+{
+	assert(mRenderDevice == nullptr && "SetHeadless must be called before Initialize.");
+	mHeadless = headless;
+}
+
+void D3DApp::Quit()
+{
+	if(mHeadless)
+		mQuitRequested = true;
+	else
+		PostQuitMessage(0);
+}
+
 int D3DApp::Run()
 {
 	MSG msg = {0};
  
 	mTimer.Reset();
+	mWallTimer.Reset();
+
+	// No window, so no messages: frames run back to back until Quit.
+	if(mHeadless)
+	{
+		while(!mQuitRequested)
+			RunFrame();
+
+		return 0;
+	}
 
 	while(msg.message != WM_QUIT)
 	{
@@ -86,26 +112,43 @@ int D3DApp::Run()
 		// Otherwise, do animation/game stuff.
 		else
         {	
-			mTimer.Tick();
-
-			if( !mAppPaused )
-			{
-				CalculateFrameStats();
-				Update(mTimer);	
-                Draw(mTimer);
-			}
-			else
-			{
-				Sleep(100);
-			}
+			RunFrame();
         }
     }
 
 	return (int)msg.wParam;
 }
 
+void D3DApp::RunFrame()
+{
+	TickTimer();
+	mWallTimer.Tick();
+
+	if( !mAppPaused )
+	{
+		PROFILE_SCOPE("Frame");
+
+		CalculateFrameStats();
+		Update(mTimer);	
+		Draw(mTimer);
+		mFenceWaiter.EndFrame();
+	}
+	else
+	{
+		Sleep(100);
+	}
+}
+
 bool D3DApp::Initialize()
 {
+	// Headless: no window, swap chain or D3D12 device, only the null device.
+	if(mHeadless)
+	{
+		mRenderDevice = std::make_unique<NullRenderDevice>();
+		OnResize();
+		return true;
+	}
+
 	if(!InitMainWindow())
 		return false;
 
@@ -140,6 +183,20 @@ void D3DApp::CreateRtvAndDsvDescriptorHeaps()
 
 void D3DApp::OnResize()
 {
+	//! Update the viewport transform to cover the client area.
+	mScreenViewport.TopLeftX = 0;
+	mScreenViewport.TopLeftY = 0;
+	mScreenViewport.Width    = static_cast<float>(mClientWidth);
+	mScreenViewport.Height   = static_cast<float>(mClientHeight);
+	mScreenViewport.MinDepth = 0.0f;
+	mScreenViewport.MaxDepth = 1.0f;
+
+    mScissorRect = { 0, 0, mClientWidth, mClientHeight };
+
+	//! Headless, there is no swap chain or depth buffer to resize.
+	if(mHeadless)
+		return;
+
 	assert(md3dDevice);
 	assert(mSwapChain);
     assert(mDirectCmdListAlloc);
@@ -226,16 +283,6 @@ void D3DApp::OnResize()
 
 	//! Wait until resize is complete.
 	FlushCommandQueue();
-
-	//! Update the viewport transform to cover the client area.
-	mScreenViewport.TopLeftX = 0;
-	mScreenViewport.TopLeftY = 0;
-	mScreenViewport.Width    = static_cast<float>(mClientWidth);
-	mScreenViewport.Height   = static_cast<float>(mClientHeight);
-	mScreenViewport.MinDepth = 0.0f;
-	mScreenViewport.MaxDepth = 1.0f;
-
-    mScissorRect = { 0, 0, mClientWidth, mClientHeight };
 }
  
 LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
@@ -250,11 +297,13 @@ LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		{
 			mAppPaused = true;
 			mTimer.Stop();
+			mWallTimer.Stop();
 		}
 		else
 		{
 			mAppPaused = false;
 			mTimer.Start();
+			mWallTimer.Start();
 		}
 		return 0;
 
@@ -320,6 +369,7 @@ LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		mAppPaused = true;
 		mResizing  = true;
 		mTimer.Stop();
+		mWallTimer.Stop();
 		return 0;
 
 	//! WM_EXITSIZEMOVE is sent when the user releases the resize bars.
@@ -328,6 +378,7 @@ LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		mAppPaused = false;
 		mResizing  = false;
 		mTimer.Start();
+		mWallTimer.Start();
 		OnResize();
 		return 0;
  
@@ -368,6 +419,19 @@ LRESULT D3DApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
         }
         else if((int)wParam == VK_F2)
             Set4xMsaaState(!m4xMsaaState);
+        else if((int)wParam == VK_F8)
+        {
+            if(mFrameStats.CsvActive())
+                mFrameStats.StopCsv();
+            else if(mFrameStats.StartCsv("frame_times.csv"))
+                OutputDebugString(L"Logging frame times to frame_times.csv\n");
+        }
+        else if((int)wParam == VK_F9)
+        {
+            // Dump the recent CPU scopes of every thread for chrome://tracing.
+            if(Profiler::WriteChromeTrace("cpu_trace.json"))
+                OutputDebugString(L"Wrote cpu_trace.json\n");
+        }
 
         return 0;
 	}
@@ -495,6 +559,8 @@ bool D3DApp::InitDirect3D()
 #endif
 
 	CreateCommandObjects();
+	mRenderDevice = std::make_unique<D3D12RenderDevice>(md3dDevice.Get(), mCommandQueue.Get(),
+		mFence.Get(), mCommandList.Get(), mCurrentFence, mFenceWaiter);
     CreateSwapChain();
     CreateRtvAndDsvDescriptorHeaps();
 
@@ -558,26 +624,13 @@ void D3DApp::CreateSwapChain()
 
 void D3DApp::FlushCommandQueue()
 {
-	//! Advance the fence value to mark commands up to this fence point.
-    mCurrentFence++;
-
     //! Add an instruction to the command queue to set a new fence point.  Because we 
 	//! are on the GPU timeline, the new fence point won't be set until the GPU finishes
 	//! processing all the commands prior to this Signal().
-    ThrowIfFailed(mCommandQueue->Signal(mFence.Get(), mCurrentFence));
+	UINT64 fenceValue = mRenderDevice->Signal();
 
 	//! Wait until the GPU has completed commands up to this fence point.
-    if(mFence->GetCompletedValue() < mCurrentFence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, nullptr, false, EVENT_ALL_ACCESS);
-
-        //! Fire event when GPU hits current fence.  
-        ThrowIfFailed(mFence->SetEventOnCompletion(mCurrentFence, eventHandle));
-
-        //! Wait until the GPU hits current fence event is fired.
-		WaitForSingleObject(eventHandle, INFINITE);
-        CloseHandle(eventHandle);
-	}
+	mRenderDevice->WaitForFence(fenceValue);
 }
 
 
@@ -589,6 +642,10 @@ ID3D12Resource* D3DApp::CurrentBackBuffer()const
 
 D3D12_CPU_DESCRIPTOR_HANDLE D3DApp::CurrentBackBufferView()const
 {
+	// Headless there are no views; the null command list ignores the handle.
+	if(mRtvHeap == nullptr)
+		return D3D12_CPU_DESCRIPTOR_HANDLE{};
+
 	return CD3DX12_CPU_DESCRIPTOR_HANDLE(
 		mRtvHeap->GetCPUDescriptorHandleForHeapStart(),
 		mCurrBackBuffer,
@@ -597,39 +654,34 @@ D3D12_CPU_DESCRIPTOR_HANDLE D3DApp::CurrentBackBufferView()const
 
 D3D12_CPU_DESCRIPTOR_HANDLE D3DApp::DepthStencilView()const
 {
+	if(mDsvHeap == nullptr)
+		return D3D12_CPU_DESCRIPTOR_HANDLE{};
+
 	return mDsvHeap->GetCPUDescriptorHandleForHeapStart();
 }
 
 void D3DApp::CalculateFrameStats()
 {
-	// Code computes the average frames per second, and also the 
-	// average time it takes to render one frame.  These stats 
-	// are appended to the window caption bar.
-    
-	static int frameCnt = 0;
-	static float timeElapsed = 0.0f;
-
-	frameCnt++;
-
-	// Compute averages over one second period.
-	if( (mTimer.TotalTime() - timeElapsed) >= 1.0f )
-	{
-		float fps = (float)frameCnt; // fps = frameCnt / 1
-		float mspf = 1000.0f / fps;
-
-        wstring fpsStr = to_wstring(fps);
-        wstring mspfStr = to_wstring(mspf);
-
-        wstring windowText = mMainWndCaption +
-            L"    fps: " + fpsStr +
-            L"   mspf: " + mspfStr;
-
-        SetWindowText(mhMainWnd, windowText.c_str());
-		
-		// Reset for next average.
-		frameCnt = 0;
-		timeElapsed += 1.0f;
-	}
+	// Frame times go into a rolling histogram; several times per reporting window
+	// the caption shows the frame rate and the median, tail and worst frame times
+	// of the last window.
+	// They are real times, even when mTimer replays recorded ones.
+	if(!mFrameStats.AddFrame(mWallTimer.TotalTime(), mWallTimer.DeltaTime()))
+		return;
+
+	const FrameStatsReport& report = mFrameStats.LastReport();
+
+	wstring windowText = mMainWndCaption +
+		L"    fps: " + to_wstring(report.Fps) +
+		L"   ms p50: " + to_wstring(report.P50Ms) +
+		L"  p90: " + to_wstring(report.P90Ms) +
+		L"  p99: " + to_wstring(report.P99Ms) +
+		L"  p99.9: " + to_wstring(report.P999Ms) +
+		L"  max: " + to_wstring(report.MaxMs) +
+		L"   gpu wait ms: " + to_wstring(mFenceWaiter.LastFrameStallMs());
+
+	if(mhMainWnd != nullptr)
+		SetWindowText(mhMainWnd, windowText.c_str());
 }
 
 //! Display adapters implement graphical functionality. Usually, the display adapter
@@ -9,6 +9,9 @@
 
 #include "d3dUtil.h"
 #include "GameTimer.h"
+#include "FrameStats.h"
+#include "FenceWaiter.h"
+#include "RenderDevice.h"
 
 // Link necessary d3d12 libraries.
 #pragma comment(lib,"d3dcompiler.lib")
@@ -36,6 +39,14 @@ public:
     void Set4xMsaaState(bool value);
 
 	int Run();
+
+	///<summary>
+	/// Headless apps create no window, swap chain or D3D12 device: Initialize sets
+	/// up a NullRenderDevice, and Run draws frames back to back, without waiting on
+	/// messages, until Quit.  Call before Initialize.
+	///</summary>
+	void SetHeadless(bool headless);
+	bool Headless()const { return mHeadless; }
  
     virtual bool Initialize();
     virtual LRESULT MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -44,6 +55,9 @@ protected:
     virtual void CreateRtvAndDsvDescriptorHeaps();
 	virtual void OnResize(); 
 	virtual void Update(const GameTimer& gt)=0;
+
+	// Advances mTimer once per frame.  Override to drive it from recorded times.
+	virtual void TickTimer() { mTimer.Tick(); }
     virtual void Draw(const GameTimer& gt)=0;
 
 	// Convenience overrides for handling mouse input.
@@ -60,6 +74,12 @@ protected:
 
 	void FlushCommandQueue();
 
+	// Ends Run after the current frame.
+	void Quit();
+
+	// One pass of Run's loop: ticks the timers and, unless paused, updates and draws.
+	void RunFrame();
+
 	ID3D12Resource* CurrentBackBuffer()const;
 	D3D12_CPU_DESCRIPTOR_HANDLE CurrentBackBufferView()const;
 	D3D12_CPU_DESCRIPTOR_HANDLE DepthStencilView()const;
@@ -88,6 +108,12 @@ protected:
 
 	// Used to keep track of the delta-time and game time.
 	GameTimer mTimer;
+
+	// Always follows the real clock; frame statistics are measured with it.
+	GameTimer mWallTimer;
+
+	// Frame time percentiles shown in the caption; F8 toggles per-frame CSV logging.
+	FrameStats mFrameStats;
 	
     Microsoft::WRL::ComPtr<IDXGIFactory4> mdxgiFactory;
     Microsoft::WRL::ComPtr<IDXGISwapChain> mSwapChain;
@@ -95,6 +121,16 @@ protected:
 
     Microsoft::WRL::ComPtr<ID3D12Fence> mFence;
     UINT64 mCurrentFence = 0;
+
+	// Every CPU wait on mFence goes through this, so stalls are timed per frame.
+	FenceWaiter mFenceWaiter;
+
+	// Buffer, command list and fence creation, and queue signalling.  Wraps md3dDevice,
+	// mCommandQueue, mFence and mCommandList, or is a NullRenderDevice when headless.
+	std::unique_ptr<RenderDevice> mRenderDevice;
+
+	bool mHeadless = false;
+	bool mQuitRequested = false;
 	
     Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCommandQueue;
     Microsoft::WRL::ComPtr<ID3D12CommandAllocator> mDirectCmdListAlloc;
@@ -93,6 +93,56 @@ Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
     return defaultBuffer;
 }
 
+DirectX::BoundingBox d3dUtil::ComputeSubmeshBounds(
+	const void* vertices,
+	UINT vertexByteStride,
+	const void* indices,
+	DXGI_FORMAT indexFormat,
+	UINT startIndex,
+	UINT indexCount,
+	INT baseVertex)
+{
+	using namespace DirectX;
+
+	XMVECTOR vMin = XMVectorReplicate(+MathHelper::Infinity);
+	XMVECTOR vMax = XMVectorReplicate(-MathHelper::Infinity);
+
+	const BYTE* base = static_cast<const BYTE*>(vertices);
+	for(UINT i = startIndex; i < startIndex + indexCount; ++i)
+	{
+		UINT index = indexFormat == DXGI_FORMAT_R32_UINT ?
+			static_cast<const std::uint32_t*>(indices)[i] :
+			static_cast<const std::uint16_t*>(indices)[i];
+
+		INT v = baseVertex + (INT)index;
+		XMVECTOR p = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(base + (size_t)v * vertexByteStride));
+		vMin = XMVectorMin(vMin, p);
+		vMax = XMVectorMax(vMax, p);
+	}
+
+	BoundingBox bounds;
+	if(indexCount > 0)
+		BoundingBox::CreateFromPoints(bounds, vMin, vMax);
+	else
+		bounds.Extents = XMFLOAT3(0.0f, 0.0f, 0.0f);
+
+	return bounds;
+}
+
+void d3dUtil::ComputeSubmeshBounds(MeshGeometry& geo)
+{
+	assert(geo.VertexBufferCPU != nullptr && geo.IndexBufferCPU != nullptr);
+
+	for(auto& e : geo.DrawArgs)
+	{
+		SubmeshGeometry& submesh = e.second;
+		submesh.Bounds = ComputeSubmeshBounds(
+			geo.VertexBufferCPU->GetBufferPointer(), geo.VertexByteStride,
+			geo.IndexBufferCPU->GetBufferPointer(), geo.IndexFormat,
+			submesh.StartIndexLocation, submesh.IndexCount, submesh.BaseVertexLocation);
+	}
+}
+
 ComPtr<ID3DBlob> d3dUtil::CompileShader(
 	const std::wstring& filename,
 	const D3D_SHADER_MACRO* defines,
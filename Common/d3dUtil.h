@@ -84,6 +84,8 @@ inline std::wstring AnsiToWString(const std::string& str)
 #endif
 	*/
 
+struct MeshGeometry;
+
 class d3dUtil
 {
 public:
@@ -117,6 +119,26 @@ public:
 		UINT64 byteSize,
 		Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer);
 
+	///<summary>
+	/// Bounds of the positions referenced by indices [startIndex, startIndex+indexCount),
+	/// offset by baseVertex.  Each vertex must start with a float3 position.  A
+	/// submesh with no indices gets empty bounds.
+	///</summary>
+	static DirectX::BoundingBox ComputeSubmeshBounds(
+		const void* vertices,
+		UINT vertexByteStride,
+		const void* indices,
+		DXGI_FORMAT indexFormat,
+		UINT startIndex,
+		UINT indexCount,
+		INT baseVertex);
+
+	///<summary>
+	/// Sets the Bounds of every submesh in geo.DrawArgs from the VertexBufferCPU and
+	/// IndexBufferCPU copies.  Call when the geometry is built.
+	///</summary>
+	static void ComputeSubmeshBounds(MeshGeometry& geo);
+
 	static Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(
 		const std::wstring& filename,
 		const D3D_SHADER_MACRO* defines,
@@ -193,11 +215,12 @@ struct MeshGeometry
 
 	std::unordered_map<std::string, SubmeshGeometry> DrawArgs;
 
+	// The views have a null address when there is no GPU buffer (NullRenderDevice).
 	D3D12_VERTEX_BUFFER_VIEW VertexBufferView()const
 
 	{
 		D3D12_VERTEX_BUFFER_VIEW vbv;
-		vbv.BufferLocation = VertexBufferGPU->GetGPUVirtualAddress();
+		vbv.BufferLocation = VertexBufferGPU != nullptr ? VertexBufferGPU->GetGPUVirtualAddress() : 0;
 		vbv.StrideInBytes = VertexByteStride;
 		vbv.SizeInBytes = VertexBufferByteSize;
 
@@ -208,7 +231,7 @@ struct MeshGeometry
 
 	{
 		D3D12_INDEX_BUFFER_VIEW ibv;
-		ibv.BufferLocation = IndexBufferGPU->GetGPUVirtualAddress();
+		ibv.BufferLocation = IndexBufferGPU != nullptr ? IndexBufferGPU->GetGPUVirtualAddress() : 0;
 		ibv.Format = IndexFormat;
 		ibv.SizeInBytes = IndexBufferByteSize;
 
@@ -219,7 +242,7 @@ struct MeshGeometry
 
 	{
 		D3D12_VERTEX_BUFFER_VIEW cbv;
-		cbv.BufferLocation = ColorBufferGPU->GetGPUVirtualAddress();
+		cbv.BufferLocation = ColorBufferGPU != nullptr ? ColorBufferGPU->GetGPUVirtualAddress() : 0;
 		cbv.StrideInBytes = ColorByteStride;
 		cbv.SizeInBytes = ColorBufferByteSize;
 
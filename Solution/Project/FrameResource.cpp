@@ -1,19 +1,52 @@
 #include "FrameResource.h"
 
-FrameResource::FrameResource(ID3D12Device* device, UINT passCount, UINT objectCount, UINT materialCount, UINT waveVertCount)
+namespace
 {
-    ThrowIfFailed(device->CreateCommandAllocator(
-        D3D12_COMMAND_LIST_TYPE_DIRECT,
-		IID_PPV_ARGS(CmdListAlloc.GetAddressOf())));
+	void CreateWorkerCommandLists(
+		RenderDevice* device,
+		UINT workerCount,
+		std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>>& allocs,
+		std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>>& lists)
+	{
+		allocs.resize(workerCount);
+		lists.resize(workerCount);
+
+		for(UINT i = 0; i < workerCount; ++i)
+		{
+			allocs[i] = device->CreateCommandAllocator();
+
+			// Created closed, as Draw resets a list before recording into it.
+			lists[i] = device->CreateCommandList(allocs[i].Get());
+		}
+	}
+}
+
+FrameResource::FrameResource(RenderDevice* device, UINT passCount, UINT objectCount, UINT materialCount, UINT waveVertCount, UINT workerCount)
+{
+    CmdListAlloc = device->CreateCommandAllocator();
+
+    CreateWorkerCommandLists(device, workerCount, WorkerCmdListAllocs, WorkerCmdLists);
 
   //  FrameCB = std::make_unique<UploadBuffer<FrameConstants>>(device, 1, true);
-    PassCB = std::make_unique<UploadBuffer<PassConstants>>(device, passCount, true);
+    if(passCount > 0)
+        PassCB = std::make_unique<UploadBuffer<PassConstants>>(device, passCount, true);
     MaterialCB = std::make_unique<UploadBuffer<MaterialConstants>>(device, materialCount, true);
-    ObjectCB = std::make_unique<UploadBuffer<ObjectConstants>>(device, objectCount, true);
+    if(objectCount > 0)
+        ObjectCB = std::make_unique<UploadBuffer<ObjectConstants>>(device, objectCount, true);
+    ObjectCBCapacity = objectCount;
+
+    DirtyObjects.Reset(objectCount);
+    DirtyMaterials.Reset(materialCount);
 
     WavesVB = std::make_unique<UploadBuffer<Vertex>>(device, waveVertCount, false);
 }
 
+FrameResource::FrameResource(ID3D12Device* device, UINT passCount, UINT objectCount, UINT materialCount, UINT waveVertCount) :
+	FrameResource(device, passCount, objectCount, materialCount)
+{
+	WavesVB = std::make_unique<UploadBuffer<Vertex>>(device, waveVertCount, false);
+}
+
 FrameResource::FrameResource(ID3D12Device* device, UINT passCount, UINT objectCount, UINT materialCount)
 {
 	ThrowIfFailed(device->CreateCommandAllocator(
@@ -24,7 +57,10 @@ FrameResource::FrameResource(ID3D12Device* device, UINT passCount, UINT objectCo
 	PassCB = std::make_unique<UploadBuffer<PassConstants>>(device, passCount, true);
 	MaterialCB = std::make_unique<UploadBuffer<MaterialConstants>>(device, materialCount, true);
 	ObjectCB = std::make_unique<UploadBuffer<ObjectConstants>>(device, objectCount, true);
+	ObjectCBCapacity = objectCount;
 
+	DirtyObjects.Reset(objectCount);
+	DirtyMaterials.Reset(materialCount);
 }
 
 FrameResource::~FrameResource()
@@ -0,0 +1,312 @@
+//***************************************************************************************
+// SceneFile.cpp
+//***************************************************************************************
+
+#include "SceneFile.h"
+
+using namespace DirectX;
+
+namespace
+{
+	bool GetWriteTime(const std::wstring& filename, ULARGE_INTEGER& time)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if(!GetFileAttributesExW(filename.c_str(), GetFileExInfoStandard, &data))
+			return false;
+
+		time.LowPart = data.ftLastWriteTime.dwLowDateTime;
+		time.HighPart = data.ftLastWriteTime.dwHighDateTime;
+		return true;
+	}
+
+	bool ReadWholeFile(const std::wstring& filename, std::vector<char>& contents)
+	{
+		std::ifstream fin(filename, std::ios::binary | std::ios::ate);
+		if(!fin)
+			return false;
+
+		std::streamoff size = fin.tellg();
+		contents.resize((size_t)size);
+		fin.seekg(0, std::ios::beg);
+		return size == 0 || (bool)fin.read(contents.data(), size);
+	}
+
+	void ReportError(const std::wstring& filename, UINT line, const std::string& message)
+	{
+		std::wstring text = filename + L"(" + std::to_wstring(line) + L"): " + AnsiToWString(message) + L"\n";
+		OutputDebugStringW(text.c_str());
+	}
+
+	// Splits one line into whitespace separated tokens, stopping at a '#' comment.
+	void Tokenize(const char* first, const char* last, std::vector<std::string>& tokens)
+	{
+		tokens.clear();
+		while(first != last)
+		{
+			while(first != last && (*first == ' ' || *first == '\t' || *first == '\r'))
+				++first;
+
+			if(first == last || *first == '#')
+				break;
+
+			const char* start = first;
+			while(first != last && *first != ' ' && *first != '\t' && *first != '\r')
+				++first;
+
+			tokens.emplace_back(start, first);
+		}
+	}
+
+	bool ParseFloat(const std::string& token, float& value)
+	{
+		char* end = nullptr;
+		value = strtof(token.c_str(), &end);
+		return end != token.c_str() && *end == '\0';
+	}
+
+	// Parses tokens[i+1..i+3] into v and advances i past them.
+	bool ParseFloat3(const std::vector<std::string>& tokens, size_t& i, XMFLOAT3& v)
+	{
+		if(i + 3 >= tokens.size())
+			return false;
+
+		if(!ParseFloat(tokens[i + 1], v.x) || !ParseFloat(tokens[i + 2], v.y) || !ParseFloat(tokens[i + 3], v.z))
+			return false;
+
+		i += 3;
+		return true;
+	}
+}
+
+HRESULT Scene::Load(const std::wstring& textFilename, const std::wstring& cookedFilename)
+{
+	ULARGE_INTEGER textTime;
+	ULARGE_INTEGER cookedTime;
+	bool haveText = GetWriteTime(textFilename, textTime);
+	bool haveCooked = GetWriteTime(cookedFilename, cookedTime);
+
+	if(haveCooked && (!haveText || cookedTime.QuadPart >= textTime.QuadPart))
+	{
+		if(SUCCEEDED(LoadCooked(cookedFilename)))
+			return S_OK;
+	}
+
+	HRESULT hr = LoadText(textFilename);
+	if(FAILED(hr))
+		return hr;
+
+	// The cooked file is only a cache, so failing to write it is not an error.
+	if(FAILED(WriteCooked(cookedFilename)))
+		OutputDebugStringW((L"Failed to cook " + cookedFilename + L"\n").c_str());
+
+	return S_OK;
+}
+
+HRESULT Scene::LoadText(const std::wstring& filename)
+{
+	Clear();
+
+	std::vector<char> text;
+	if(!ReadWholeFile(filename, text))
+		return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+
+	std::vector<std::string> tokens;
+	const char* cursor = text.data();
+	const char* end = text.data() + text.size();
+	UINT line = 0;
+
+	while(cursor != end)
+	{
+		const char* eol = std::find(cursor, end, '\n');
+		Tokenize(cursor, eol, tokens);
+		cursor = eol == end ? end : eol + 1;
+		++line;
+
+		if(tokens.empty())
+			continue;
+
+		if(tokens[0] != "instance")
+		{
+			ReportError(filename, line, "unknown record '" + tokens[0] + "'");
+			return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+		}
+
+		if(tokens.size() < 5)
+		{
+			ReportError(filename, line, "expected: instance <geometry> <submesh> <material> <layer> [options]");
+			return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+		}
+
+		SceneInstance instance;
+		instance.Geometry = Intern(tokens[1]);
+		instance.Submesh = Intern(tokens[2]);
+		instance.Material = Intern(tokens[3]);
+		instance.Layer = Intern(tokens[4]);
+
+		for(size_t i = 5; i < tokens.size(); ++i)
+		{
+			const std::string& option = tokens[i];
+
+			bool ok = true;
+			if(option == "scale")
+				ok = ParseFloat3(tokens, i, instance.Scale);
+			else if(option == "rotate")
+				ok = ParseFloat3(tokens, i, instance.RotationDegrees);
+			else if(option == "translate")
+				ok = ParseFloat3(tokens, i, instance.Translation);
+			else if(option == "tex_scale")
+				ok = ParseFloat3(tokens, i, instance.TexScale);
+			else if(option == "points")
+				instance.PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_POINTLIST;
+			else if(option == "collider")
+			{
+				if(i + 1 < tokens.size() && tokens[i + 1] == "auto")
+				{
+					instance.Collider = SceneCollider::Auto;
+					++i;
+				}
+				else
+				{
+					instance.Collider = SceneCollider::Box;
+					ok = ParseFloat3(tokens, i, instance.ColliderCenter) &&
+						ParseFloat3(tokens, i, instance.ColliderExtents);
+				}
+			}
+			else
+			{
+				ReportError(filename, line, "unknown option '" + option + "'");
+				return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+			}
+
+			if(!ok)
+			{
+				ReportError(filename, line, "bad or missing numbers after '" + option + "'");
+				return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+			}
+		}
+
+		mInstances.push_back(instance);
+	}
+
+	return S_OK;
+}
+
+HRESULT Scene::LoadCooked(const std::wstring& filename)
+{
+	Clear();
+
+	std::vector<char> file;
+	if(!ReadWholeFile(filename, file))
+		return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+
+	if(file.size() < sizeof(SceneFileHeader))
+		return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+	SceneFileHeader header;
+	memcpy(&header, file.data(), sizeof(header));
+
+	if(header.Magic != SceneFile::Magic || header.Version != SceneFile::Version ||
+		header.InstanceByteSize != sizeof(SceneInstance))
+		return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+	const std::uint64_t offsetsByteSize = ((std::uint64_t)header.StringCount + 1) * sizeof(std::uint32_t);
+	const std::uint64_t instancesByteSize = (std::uint64_t)header.InstanceCount * sizeof(SceneInstance);
+	const std::uint64_t expectedSize = sizeof(SceneFileHeader) + offsetsByteSize + header.StringByteSize + instancesByteSize;
+	if(file.size() != expectedSize)
+		return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+	const char* cursor = file.data() + sizeof(SceneFileHeader);
+	const std::uint32_t* offsets = reinterpret_cast<const std::uint32_t*>(cursor);
+	const char* chars = cursor + offsetsByteSize;
+
+	mStrings.reserve(header.StringCount);
+	for(std::uint32_t i = 0; i < header.StringCount; ++i)
+	{
+		if(offsets[i] > offsets[i + 1] || offsets[i + 1] > header.StringByteSize)
+		{
+			Clear();
+			return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+		}
+
+		mStrings.emplace_back(chars + offsets[i], chars + offsets[i + 1]);
+		mStringIds.emplace(mStrings.back(), i);
+	}
+
+	mInstances.resize(header.InstanceCount);
+	if(header.InstanceCount > 0)
+		memcpy(mInstances.data(), chars + header.StringByteSize, (size_t)instancesByteSize);
+
+	for(const SceneInstance& instance : mInstances)
+	{
+		if(instance.Geometry >= header.StringCount || instance.Submesh >= header.StringCount ||
+			instance.Material >= header.StringCount || instance.Layer >= header.StringCount)
+		{
+			Clear();
+			return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+		}
+	}
+
+	return S_OK;
+}
+
+HRESULT Scene::WriteCooked(const std::wstring& filename)const
+{
+	SceneFileHeader header;
+	header.StringCount = (std::uint32_t)mStrings.size();
+	header.InstanceCount = (std::uint32_t)mInstances.size();
+
+	std::vector<std::uint32_t> offsets;
+	offsets.reserve(mStrings.size() + 1);
+	offsets.push_back(0);
+	for(const std::string& s : mStrings)
+		offsets.push_back(offsets.back() + (std::uint32_t)s.size());
+	header.StringByteSize = offsets.back();
+
+	std::ofstream fout(filename, std::ios::binary | std::ios::trunc);
+	if(!fout)
+		return HRESULT_FROM_WIN32(ERROR_CANNOT_MAKE);
+
+	fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	fout.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint32_t));
+	for(const std::string& s : mStrings)
+		fout.write(s.data(), s.size());
+	fout.write(reinterpret_cast<const char*>(mInstances.data()), mInstances.size() * sizeof(SceneInstance));
+
+	return fout ? S_OK : HRESULT_FROM_WIN32(ERROR_WRITE_FAULT);
+}
+
+XMMATRIX Scene::World(const SceneInstance& instance)
+{
+	XMMATRIX S = XMMatrixScaling(instance.Scale.x, instance.Scale.y, instance.Scale.z);
+	XMMATRIX R =
+		XMMatrixRotationX(XMConvertToRadians(instance.RotationDegrees.x)) *
+		XMMatrixRotationY(XMConvertToRadians(instance.RotationDegrees.y)) *
+		XMMatrixRotationZ(XMConvertToRadians(instance.RotationDegrees.z));
+	XMMATRIX T = XMMatrixTranslation(instance.Translation.x, instance.Translation.y, instance.Translation.z);
+
+	return S * R * T;
+}
+
+XMMATRIX Scene::TexTransform(const SceneInstance& instance)
+{
+	return XMMatrixScaling(instance.TexScale.x, instance.TexScale.y, instance.TexScale.z);
+}
+
+void Scene::Clear()
+{
+	mInstances.clear();
+	mStrings.clear();
+	mStringIds.clear();
+}
+
+std::uint32_t Scene::Intern(const std::string& s)
+{
+	auto it = mStringIds.find(s);
+	if(it != mStringIds.end())
+		return it->second;
+
+	std::uint32_t id = (std::uint32_t)mStrings.size();
+	mStrings.push_back(s);
+	mStringIds.emplace(s, id);
+	return id;
+}
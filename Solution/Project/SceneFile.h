@@ -0,0 +1,105 @@
+//***************************************************************************************
+// SceneFile.h
+//
+// Scene description: the list of mesh instances that make up a level.  Scenes are
+// authored as text (*.scene, see Scenes/maze.scene for the syntax) and cooked to a
+// binary form (*.scenebin) that loads with a single read and no parsing:
+//
+//   SceneFileHeader
+//   std::uint32_t  string offsets[StringCount + 1]  (into the character block)
+//   char           characters[StringByteSize]       (not null terminated)
+//   SceneInstance  instances[InstanceCount]
+//
+// Geometry, submesh, material and layer names are interned into one string table
+// and instances refer to them by index, so the app can resolve every name once no
+// matter how many instances share it.
+//***************************************************************************************
+
+#pragma once
+
+#include "../../Common/d3dUtil.h"
+
+namespace SceneFile
+{
+	const std::uint32_t Magic = 0x454E4353; // 'SCNE'
+	const std::uint32_t Version = 1;
+}
+
+enum class SceneCollider : std::uint32_t
+{
+	None = 0,
+
+	// Axis aligned box given by ColliderCenter/ColliderExtents.
+	Box,
+
+	// Axis aligned box around the submesh bounds transformed by the world matrix.
+	Auto
+};
+
+struct SceneInstance
+{
+	// Indices into the scene's string table.
+	std::uint32_t Geometry = 0;
+	std::uint32_t Submesh = 0;
+	std::uint32_t Material = 0;
+	std::uint32_t Layer = 0;
+
+	std::uint32_t PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+	SceneCollider Collider = SceneCollider::None;
+
+	DirectX::XMFLOAT3 Scale = { 1.0f, 1.0f, 1.0f };
+	DirectX::XMFLOAT3 RotationDegrees = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 Translation = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 TexScale = { 1.0f, 1.0f, 1.0f };
+
+	DirectX::XMFLOAT3 ColliderCenter = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 ColliderExtents = { 0.0f, 0.0f, 0.0f };
+};
+
+struct SceneFileHeader
+{
+	std::uint32_t Magic = SceneFile::Magic;
+	std::uint32_t Version = SceneFile::Version;
+	std::uint32_t StringCount = 0;
+	std::uint32_t StringByteSize = 0;
+	std::uint32_t InstanceCount = 0;
+	std::uint32_t InstanceByteSize = sizeof(SceneInstance);
+};
+
+class Scene
+{
+public:
+	///<summary>
+	/// Loads the cooked scene if it is at least as new as the text file, otherwise
+	/// parses the text file and re-cooks it.  Either file may be missing as long as
+	/// the other one loads.  Parse errors are reported to the debugger output with
+	/// their line number and return HRESULT_FROM_WIN32(ERROR_INVALID_DATA).
+	///</summary>
+	HRESULT Load(const std::wstring& textFilename, const std::wstring& cookedFilename);
+
+	HRESULT LoadText(const std::wstring& filename);
+	HRESULT LoadCooked(const std::wstring& filename);
+	HRESULT WriteCooked(const std::wstring& filename)const;
+
+	UINT InstanceCount()const { return (UINT)mInstances.size(); }
+	const SceneInstance& Instance(UINT i)const { return mInstances[i]; }
+
+	UINT StringCount()const { return (UINT)mStrings.size(); }
+	const std::string& String(UINT i)const { return mStrings[i]; }
+
+	///<summary>
+	/// World = scale * rotate X * rotate Y * rotate Z * translate.
+	///</summary>
+	static DirectX::XMMATRIX World(const SceneInstance& instance);
+
+	static DirectX::XMMATRIX TexTransform(const SceneInstance& instance);
+
+private:
+	void Clear();
+	std::uint32_t Intern(const std::string& s);
+
+private:
+	std::vector<SceneInstance> mInstances;
+	std::vector<std::string> mStrings;
+	std::unordered_map<std::string, std::uint32_t> mStringIds;
+};
@@ -22,6 +22,16 @@
 
 Texture2D    gDiffuseMap : register(t0);
 
+struct InstanceData
+{
+	float4x4 World;
+	float4x4 TexTransform;
+};
+
+// Per-instance transforms for VSInstanced.  The app offsets the root SRV to the
+// first instance of each batch, so SV_InstanceID indexes straight into it.
+StructuredBuffer<InstanceData> gInstanceData : register(t1);
+
 
 SamplerState gsamPointWrap        : register(s0);
 SamplerState gsamPointClamp       : register(s1);
@@ -91,27 +101,38 @@ struct VertexOut
 	float2 TexC    : TEXCOORD;
 };
 
-VertexOut VS(VertexIn vin)
+VertexOut TransformVertex(VertexIn vin, float4x4 world, float4x4 texTransform)
 {
 	VertexOut vout = (VertexOut)0.0f;
 	
     // Transform to world space.
-    float4 posW = mul(float4(vin.PosL, 1.0f), gWorld);
+    float4 posW = mul(float4(vin.PosL, 1.0f), world);
     vout.PosW = posW.xyz;
 
     // Assumes nonuniform scaling; otherwise, need to use inverse-transpose of world matrix.
-    vout.NormalW = mul(vin.NormalL, (float3x3)gWorld);
+    vout.NormalW = mul(vin.NormalL, (float3x3)world);
 
     // Transform to homogeneous clip space.
     vout.PosH = mul(posW, gViewProj);
 	
 	// Output vertex attributes for interpolation across triangle.
-	float4 texC = mul(float4(vin.TexC, 0.0f, 1.0f), gTexTransform);
+	float4 texC = mul(float4(vin.TexC, 0.0f, 1.0f), texTransform);
 	vout.TexC = mul(texC, gMatTransform).xy;
 
     return vout;
 }
 
+VertexOut VS(VertexIn vin)
+{
+	return TransformVertex(vin, gWorld, gTexTransform);
+}
+
+VertexOut VSInstanced(VertexIn vin, uint instanceID : SV_InstanceID)
+{
+	InstanceData instData = gInstanceData[instanceID];
+	return TransformVertex(vin, instData.World, instData.TexTransform);
+}
+
 float4 PS(VertexOut pin) : SV_Target
 {
     float4 diffuseAlbedo = gDiffuseMap.Sample(gsamAnisotropicWrap, pin.TexC) * gDiffuseAlbedo;
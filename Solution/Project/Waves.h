@@ -27,6 +27,9 @@ public:
 	float Width()const;
 	float Depth()const;
 
+	// Simulated seconds per solver step; Update steps once this much time has passed.
+	float TimeStep()const { return mTimeStep; }
+
 	// Returns the solution at the ith grid point.
     const DirectX::XMFLOAT3& Position(int i)const { return mCurrSolution[i]; }
 
@@ -37,6 +40,10 @@ public:
     const DirectX::XMFLOAT3& TangentX(int i)const { return mTangentX[i]; }
 
 	void Update(float dt);
+
+	// Advances the solver by exactly one TimeStep(), for callers that keep their own
+	// fixed-rate clock.
+	void Step();
 	void Disturb(int i, int j, float magnitude);
 
 private:
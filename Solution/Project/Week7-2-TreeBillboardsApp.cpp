@@ -15,9 +15,33 @@
 #include "../../Common/UploadBuffer.h"
 #include "../../Common/GeometryGenerator.h"
 #include "../../Common/Camera.h"
+#include "../../Common/MeshFile.h"
+#include "../../Common/FrustumCulling.h"
+#include "../../Common/ColliderGrid.h"
+#include "../../Common/CharacterController.h"
+#include "../../Common/RenderQueue.h"
+#include "../../Common/RadixSort.h"
+#include "../../Common/NameRegistry.h"
+#include "../../Common/SceneStore.h"
+#include "../../Common/UploadRing.h"
+#include "../../Common/NullRenderCommandList.h"
+#include "../../Common/Profiler.h"
+#include "../../Common/SimScheduler.h"
+#include "../../Common/FrameRecording.h"
+#include "../../Common/CameraPath.h"
+#include "../../Common/TextureLoader.h"
+#include "../../Common/ObjLoader.h"
 #include "FrameResource.h"
+#include "SceneFile.h"
 #include "Waves.h"
 #include <vector>
+#include <map>
+#include <tuple>
+#include <thread>
+#include <iomanip>
+#include <cerrno>
+#include <climits>
+#include <ppl.h>
 
 using Microsoft::WRL::ComPtr;
 using namespace DirectX;
@@ -26,54 +50,74 @@ using namespace DirectX::PackedVector;
 #pragma comment(lib, "d3dcompiler.lib")
 #pragma comment(lib, "D3D12.lib")
 
-const int gNumFrameResources = 3;
+// Frames the CPU may record ahead of the GPU, unless set with -frames=N or changed
+// at run time with F6/F7.  More frames in flight hide GPU hitches better but add
+// input latency.
+const UINT gDefaultFramesInFlight = 3;
+const UINT gMaxFramesInFlight = 8;
 
-// Lightweight structure stores parameters to draw a shape.  This will
-// vary from app-to-app.
-struct RenderItem
-{
-	RenderItem() = default;
-
-	BoundingBox wallCollider;
+// Fewest draws worth giving their own command list when recording in parallel.
+const UINT gMinDrawsPerCommandList = 64;
 
-	
-    // World matrix of the shape that describes the object's local space
-    // relative to the world space, which defines the position, orientation,
-    // and scale of the object in the world.
-    XMFLOAT4X4 World = MathHelper::Identity4x4();
+// Starting size of the upload ring; it grows if a frame needs more.
+const UINT64 gUploadRingByteSize = 256 * 1024;
 
-	XMFLOAT4X4 TexTransform = MathHelper::Identity4x4();
+enum class RenderLayer : int
+{
+	Opaque = 0,
+	Transparent,
+	AlphaTested,
+	AlphaTestedTreeSprites,
+	Count
+};
 
-	// Dirty flag indicating the object data has changed and we need to update the constant buffer.
-	// Because we have an object cbuffer for each FrameResource, we have to apply the
-	// update to each FrameResource.  Thus, when we modify obect data we should set 
-	// NumFramesDirty = gNumFrameResources so that each frame resource gets the update.
-	int NumFramesDirty = gNumFrameResources;
+// Render items of one layer that share geometry, submesh, material and topology,
+// drawn with a single DrawIndexedInstanced call.  Their transforms are packed into
+// an upload ring allocation each frame, at InstanceAddress.
+struct InstanceBatch
+{
+	MeshGeometry* Geo = nullptr;
+	Material* Mat = nullptr;
 
-	// Index into GPU constant buffer corresponding to the ObjectCB for this render item.
-	UINT ObjCBIndex = -1;
+	// Handles of Geo and Mat, used in render queue sort keys.
+	UINT GeoId = 0;
+	UINT MatId = 0;
 
-	Material* Mat = nullptr;
-	MeshGeometry* Geo = nullptr;
+	DrawArgs Draw;
 
-    // Primitive topology.
-    D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+	D3D12_GPU_VIRTUAL_ADDRESS InstanceAddress = 0;
 
-    // DrawIndexedInstanced parameters.
-    UINT IndexCount = 0;
-    UINT StartIndexLocation = 0;
-    int BaseVertexLocation = 0;
+	// Number of instances written this frame, nearest first, and the quantised view
+	// depth of the nearest one.
+	UINT InstanceCount = 0;
+	UINT NearestDepth = 0;
 
+	// Scene store handles of the batched items.
+	std::vector<UINT> Items;
 };
 
+// A layer in the order the layers are drawn, with the PSO it is drawn with.
+// Instanced layers are drawn from their InstanceBatches, the others item by item.
+// Blended layers are drawn back to front; the rest are sorted by state and then
+// front to back so nearer surfaces fill the depth buffer first.
+struct LayerPass
+{
+	RenderLayer Layer = RenderLayer::Opaque;
+	ID3D12PipelineState* Pso = nullptr;
+	bool Instanced = false;
+	bool BackToFront = false;
 
-enum class RenderLayer : int
+	// Label of the pass's draws in profiler traces.
+	const char* Name = "";
+};
+
+// One draw of the frame's render queue: either an instanced batch or a single
+// render item (by scene store slot), drawn with Pso.
+struct DrawPacket
 {
-	Opaque = 0,
-	Transparent,
-	AlphaTested,
-	AlphaTestedTreeSprites,
-	Count
+	ID3D12PipelineState* Pso = nullptr;
+	const InstanceBatch* Batch = nullptr;
+	UINT ItemSlot = 0;
 };
 
 class TreeBillboardsApp : public D3DApp
@@ -86,8 +130,41 @@ public:
 
     virtual bool Initialize()override;
 
+    ///<summary>
+    /// F6 and F7 take one frame in flight away or add one; other messages go to
+    /// D3DApp.
+    ///</summary>
+    virtual LRESULT MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)override;
+
+    ///<summary>
+    /// Sets how many frames the CPU may record ahead of the GPU (clamped to
+    /// [1, gMaxFramesInFlight]).  Once initialized, this waits for the GPU and
+    /// rebuilds the frame resources.
+    ///</summary>
+    void SetFramesInFlight(UINT count);
+
+    ///<summary>
+    /// Logs every frame's delta time, input and RNG seed to path.
+    ///</summary>
+    bool StartRecording(const std::string& path);
+
+    ///<summary>
+    /// Drives the run from a recording made by StartRecording, as fast as frames can
+    /// be produced, and quits when it ends.  Live input is ignored.
+    ///</summary>
+    bool StartReplay(const std::string& path);
+
+    ///<summary>
+    /// Flies the camera along a fixed path through the scene for frameCount frames
+    /// of 1/60 s each, then writes per-segment timings and draw and cull counts,
+    /// and the upload ring's high-water mark, to path as JSON and quits.  Live input, recording and replay are ignored.
+    /// Returns false, and does not start, if frameCount is zero.
+    ///</summary>
+    bool StartBenchmark(UINT frameCount, const std::string& path);
+
 private:
     virtual void OnResize()override;
+    virtual void TickTimer()override;
     virtual void Update(const GameTimer& gt)override;
     virtual void Draw(const GameTimer& gt)override;
 
@@ -95,13 +172,24 @@ private:
     virtual void OnMouseUp(WPARAM btnState, int x, int y)override;
     virtual void OnMouseMove(WPARAM btnState, int x, int y)override;
 
+    void PollFrameInput(const GameTimer& gt);
+	void UpdateBenchmarkCamera();
+	void EndBenchmarkFrame();
+	void WriteBenchmark();
     void OnKeyboardInput(const GameTimer& gt);
 	void UpdateCamera(const GameTimer& gt);
+	void BuildSimulation();
+	void StepLightning(float dt);
 	void AnimateMaterials(const GameTimer& gt);
+	void CullRenderItems();
+	void MarkObjectDirty(UINT objCBIndex);
+	void MarkMaterialDirty(UINT matCBIndex);
 	void UpdateObjectCBs(const GameTimer& gt);
+	void UpdateInstanceData(const GameTimer& gt);
 	void UpdateMaterialCBs(const GameTimer& gt);
 	void UpdateMainPassCB(const GameTimer& gt);
 	void UpdateWaves(const GameTimer& gt); 
+	void BuildRenderQueue();
 
 	void LoadTextures();
     void BuildRootSignature();
@@ -120,11 +208,17 @@ private:
 	void BuildDiamondGeometry();
 	void BuildTriangularPrismGeometry();
 	void BuildWallGeometry();
+	bool LoadCookedGeometry(const std::string& name);
+	void CookGeometry(MeshGeometry& geo);
     void BuildPSOs();
     void BuildFrameResources();
     void BuildMaterials();
     void BuildRenderItems();
-    void DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<RenderItem*>& ritems);
+	void BuildInstanceBatches();
+	void BuildLayerPasses();
+	void DrawNull();
+	void SetFrameState(RenderCommandList* cmdList);
+	void DrawRenderQueue(RenderCommandList* cmdList, UINT first, UINT last);
 
 	std::array<const CD3DX12_STATIC_SAMPLER_DESC, 6> GetStaticSamplers();
 
@@ -136,6 +230,24 @@ private:
     std::vector<std::unique_ptr<FrameResource>> mFrameResources;
     FrameResource* mCurrFrameResource = nullptr;
     int mCurrFrameResourceIndex = 0;
+    UINT mFramesInFlight = gDefaultFramesInFlight;
+
+    // Threads recording the frame's draws, i.e. command lists per frame resource.
+    UINT mRecordWorkerCount = 1;
+
+    // Headless, the frame is recorded into these, one per worker, and the commands
+    // and indices recorded are counted.
+    std::vector<NullRenderCommandList> mNullCmdLists;
+    std::uint64_t mNullFrameCommands = 0;
+    std::uint64_t mNullFrameIndices = 0;
+    std::uint64_t mNullTotalCommands = 0;
+    std::uint64_t mNullTotalIndices = 0;
+
+    // Pass constants and instance data written this frame.  Allocations are freed
+    // once the GPU passes the frame's fence.  Object constants live in each frame
+    // resource's ObjectCB instead, so static items are not rewritten every frame.
+    std::unique_ptr<UploadRing> mUploadRing;
+    D3D12_GPU_VIRTUAL_ADDRESS mPassCBAddress = 0;
 
     UINT mCbvSrvDescriptorSize = 0;
 
@@ -143,25 +255,68 @@ private:
 
 	ComPtr<ID3D12DescriptorHeap> mSrvDescriptorHeap = nullptr;
 
-	std::unordered_map<std::string, std::unique_ptr<MeshGeometry>> mGeometries;
-	std::unordered_map<std::string, std::unique_ptr<Material>> mMaterials;
-	std::unordered_map<std::string, std::unique_ptr<Texture>> mTextures;
+	// Named at build time; indexed by handle afterwards.
+	NamedTable<std::unique_ptr<MeshGeometry>> mGeometries;
+	NamedTable<std::unique_ptr<Material>> mMaterials;
+	std::vector<Material*> mMaterialsByCBIndex;
+	NamedTable<std::unique_ptr<Texture>> mTextures;
 	std::unordered_map<std::string, ComPtr<ID3DBlob>> mShaders;
-	std::unordered_map<std::string, ComPtr<ID3D12PipelineState>> mPSOs;
+	NamedTable<ComPtr<ID3D12PipelineState>> mPSOs;
 
     std::vector<D3D12_INPUT_ELEMENT_DESC> mStdInputLayout;
 	std::vector<D3D12_INPUT_ELEMENT_DESC> mTreeSpriteInputLayout;
 
-    RenderItem* mWavesRitem = nullptr;
+	// Shared by every water instance; its vertex buffer is swapped each frame.
+	MeshGeometry* mWavesGeo = nullptr;
+
+	// Material whose texture transform is animated every frame.
+	UINT mWaterMat = NameRegistry::InvalidHandle;
 
-	// List of all the render items.
-	std::vector<std::unique_ptr<RenderItem>> mAllRitems;
+	// All the render items.  Their handles double as ObjectCB indices, and the
+	// layer field holds a RenderLayer.
+	SceneStore mScene;
 
-	// Render items divided by PSO.
-	std::vector<RenderItem*> mRitemLayer[(int)RenderLayer::Count];
+	// Instanced batches of the opaque and alpha tested layers.
+	std::vector<InstanceBatch> mInstanceBatches[(int)RenderLayer::Count];
+
+	// Results of this frame's frustum culling, by scene store slot: the visible
+	// slots of each layer, and a visibility flag and quantised view depth per slot
+	// (the depth is only updated for visible slots).
+	std::vector<UINT> mVisibleSlots;
+	std::vector<UINT> mVisibleItems[(int)RenderLayer::Count];
+	std::vector<std::uint8_t> mItemVisible;
+	std::vector<UINT> mItemDepths;
+
+	// Scratch arrays for sorting each batch's instances by depth.
+	std::vector<std::uint32_t> mInstanceDepths;
+	std::vector<std::uint32_t> mInstanceItems;
+	std::vector<std::uint32_t> mInstanceScratchDepths;
+	std::vector<std::uint32_t> mInstanceScratchItems;
+
+	// Every layer in draw order; filled in once the PSOs exist.
+	LayerPass mLayerPasses[(int)RenderLayer::Count];
+
+	// This frame's draws, and the queue that orders them by state.
+	std::vector<DrawPacket> mDrawPackets;
+	RenderQueue mRenderQueue;
 
 	std::unique_ptr<Waves> mWaves;
 
+	// Fixed rate simulation: the wave solver and its random disturbances, the water
+	// texture scroll and the lightning timer.
+	SimScheduler mSimulation;
+	UINT mWaterScrollSystem = 0;
+
+	// Water texture offset after the last two scroll steps, blended by the
+	// scheduler's alpha when drawn.
+	XMFLOAT2 mWaterScrollPrev = { 0.0f, 0.0f };
+	XMFLOAT2 mWaterScroll = { 0.0f, 0.0f };
+
+	float mLightningTimer = 0.0f;
+	bool mLightningActive = false;
+	float mLightningDuration = 0.1f; // Duration of each lightning 
+	float mLightningCooldown = 3.0f; // lightning flashes
+
     PassConstants mMainPassCB;
 
 	//XMFLOAT3 mEyePos = { 0.0f, 0.0f, 0.0f };
@@ -180,8 +335,54 @@ private:
 	BoundingBox wallcollider;
 	std::vector<BoundingBox> mColliders;
 
+	// Broadphase over mColliders, built once the scene is loaded.
+	ColliderGrid mColliderGrid;
+
+	// Sweeps the camera's moves against mColliderGrid (radius 0.5 units).
+	CharacterController mCameraController;
+
     POINT mLastMousePos;
 
+	// This frame's input, timing and seed: polled live (and written to mRecorder
+	// when recording) or read from mReplay.
+	RecordedFrame mFrameInput;
+	FrameRecorder mRecorder;
+	FrameReplay mReplay;
+	bool mReplayFinished = false;
+
+	// Mouse rotation since the last frame, in radians.
+	float mMousePitch = 0.0f;
+	float mMouseYaw = 0.0f;
+
+	// Source of the per-frame RNG seeds.
+	std::uint32_t mSeedState = 1;
+
+	// Per-segment totals of a benchmark run.  CPU time runs from the start of Update
+	// to the end of Draw, less the time spent waiting on the GPU.
+	struct BenchmarkSegment
+	{
+		UINT Frames = 0;
+		double CpuMs = 0.0;
+		double MaxCpuMs = 0.0;
+		double GpuWaitMs = 0.0;
+		std::uint64_t Draws = 0;
+		std::uint64_t Visible = 0;
+		std::uint64_t Culled = 0;
+
+		// Recorded into the null command lists; headless runs only.
+		std::uint64_t Commands = 0;
+		std::uint64_t Indices = 0;
+	};
+
+	CameraPath mBenchmarkPath;
+	std::string mBenchmarkOutput;
+	UINT mBenchmarkFrames = 0;
+	UINT mBenchmarkFrame = 0;
+	UINT mBenchmarkSegment = 0;
+	std::vector<BenchmarkSegment> mBenchmarkSegments;
+	std::int64_t mBenchmarkFrameStart = 0;
+	double mBenchmarkStallStart = 0.0;
+
 
 private:
 	// Camera movement
@@ -192,6 +393,59 @@ private:
 	bool mStrafeRight = false;
 };
 
+namespace
+{
+	// Value of a "-name=value" command line option, or an empty string.
+	std::string CommandLineValue(const char* cmdLine, const char* name)
+	{
+		const char* option = strstr(cmdLine, name);
+		if(option == nullptr)
+			return std::string();
+
+		const char* value = option + strlen(name);
+		const char* end = value;
+		while(*end != '\0' && *end != ' ')
+			++end;
+
+		return std::string(value, end);
+	}
+
+	// Last write time of path, or zero if it cannot be read.
+	ULONGLONG LastWriteTime(const wchar_t* path)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if(!GetFileAttributesExW(path, GetFileExInfoStandard, &attributes))
+			return 0;
+
+		return ((ULONGLONG)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+	}
+
+	// The procedural geometry is generated by code in this executable, so a cooked
+	// mesh older than the executable may come from different generator code or
+	// parameters.
+	ULONGLONG ExecutableWriteTime()
+	{
+		wchar_t path[MAX_PATH] = {};
+		GetModuleFileNameW(nullptr, path, MAX_PATH);
+		return LastWriteTime(path);
+	}
+
+	// Parses a whole decimal frame count; zero for anything else, including
+	// negative or out of range values.
+	UINT ParseFrameCount(const std::string& text)
+	{
+		if(text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+			return 0;
+
+		errno = 0;
+		unsigned long value = strtoul(text.c_str(), nullptr, 10);
+		if(errno == ERANGE || value > UINT_MAX)
+			return 0;
+
+		return (UINT)value;
+	}
+}
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,
     PSTR cmdLine, int showCmd)
 {
@@ -202,10 +456,65 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE prevInstance,
 
     try
     {
+        // Import benchmark: parses an OBJ file, writes the throughput to the debugger
+        // output and exits.  No window or device is created.
+        std::string importPath = CommandLineValue(cmdLine, "-importobj=");
+        if(!importPath.empty())
+        {
+            ObjLoader::Options options;
+            options.Benchmark = true;
+
+            GeometryGenerator::MeshData mesh;
+            if(FAILED(ObjLoader::Load(AnsiToWString(importPath), mesh, options)))
+                MessageBox(nullptr, L"Cannot import the OBJ file.", L"Import", MB_OK);
+            return 0;
+        }
+
+        std::string benchmarkFrames = CommandLineValue(cmdLine, "-benchmark=");
+        std::string replayPath = CommandLineValue(cmdLine, "-replay=");
+        std::string recordPath = CommandLineValue(cmdLine, "-record=");
+
+        // Headless runs have no window, so nothing could ever end them but a
+        // benchmark or replay running out.
+        bool nullRender = strstr(cmdLine, "-nullrender") != nullptr;
+        if(nullRender && benchmarkFrames.empty() && replayPath.empty())
+        {
+            MessageBox(nullptr, L"-nullrender needs -benchmark= or -replay=.", L"Null render", MB_OK);
+            return 0;
+        }
+
         TreeBillboardsApp theApp(hInstance);
+        theApp.SetHeadless(nullRender);
+        std::string framesInFlight = CommandLineValue(cmdLine, "-frames=");
+        if(!framesInFlight.empty())
+        {
+            UINT count = ParseFrameCount(framesInFlight);
+            if(count == 0)
+            {
+                MessageBox(nullptr, L"-frames= needs a frame count of at least 1.", L"Frames in flight", MB_OK);
+                return 0;
+            }
+            theApp.SetFramesInFlight(count);
+        }
         if(!theApp.Initialize())
             return 0;
 
+        if(!benchmarkFrames.empty())
+        {
+            if(!theApp.StartBenchmark(ParseFrameCount(benchmarkFrames), "benchmark.json"))
+            {
+                MessageBox(nullptr, L"-benchmark= needs a frame count of at least 1.", L"Benchmark", MB_OK);
+                return 0;
+            }
+        }
+        else if(!replayPath.empty() && !theApp.StartReplay(replayPath))
+        {
+            MessageBox(nullptr, L"Cannot read the replay file.", L"Replay", MB_OK);
+            return 0;
+        }
+        else if(replayPath.empty() && !recordPath.empty())
+            theApp.StartRecording(recordPath);
+
         return theApp.Run();
     }
     catch(DxException& e)
@@ -222,7 +531,7 @@ TreeBillboardsApp::TreeBillboardsApp(HINSTANCE hInstance)
 
 TreeBillboardsApp::~TreeBillboardsApp()
 {
-    if(md3dDevice != nullptr)
+    if(mRenderDevice != nullptr)
         FlushCommandQueue();
 }
 
@@ -231,23 +540,35 @@ bool TreeBillboardsApp::Initialize()
     if(!D3DApp::Initialize())
         return false;
 
-    // Reset the command list to prep for initialization commands.
-    ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr));
+    // Headless there is no D3D12 device: what only the GPU reads (textures, root
+    // signature, descriptors, shaders, PSOs) is not created and the geometry buffers
+    // are null.  Everything Update and Draw work on is built as usual.
+    const bool gpu = mRenderDevice->NativeDevice() != nullptr;
+
+    if(gpu)
+    {
+        // Reset the command list to prep for initialization commands.
+        ThrowIfFailed(mCommandList->Reset(mDirectCmdListAlloc.Get(), nullptr));
 
-    // Get the increment size of a descriptor in this heap type.  This is hardware specific, 
-	// so we have to query this information.
-    mCbvSrvDescriptorSize = md3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        // Get the increment size of a descriptor in this heap type.  This is hardware specific, 
+        // so we have to query this information.
+        mCbvSrvDescriptorSize = md3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    }
 
     mWaves = std::make_unique<Waves>(160, 128/5.2, 1.0f, 0.03f, 4.0f, 2.0f);
+    BuildSimulation();
 
 	mCamera.SetPosition(55.0f, 4.0f, -65.0f);
 
 	//mCamera.SetPosition(0.0f, 70.0f, 0.0f);
  
-	LoadTextures();
-    BuildRootSignature();
-	BuildDescriptorHeaps();
-    BuildShadersAndInputLayouts();
+    if(gpu)
+    {
+        LoadTextures();
+        BuildRootSignature();
+        BuildDescriptorHeaps();
+        BuildShadersAndInputLayouts();
+    }
     BuildLandGeometry();
     BuildWavesGeometry();
 	BuildBoxGeometry();
@@ -264,12 +585,17 @@ bool TreeBillboardsApp::Initialize()
 	BuildMaterials();
     BuildRenderItems();
     BuildFrameResources();
-    BuildPSOs();
+    if(gpu)
+        BuildPSOs();
+    BuildLayerPasses();
 
     // Execute the initialization commands.
-    ThrowIfFailed(mCommandList->Close());
-    ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
-    mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+    if(gpu)
+    {
+        ThrowIfFailed(mCommandList->Close());
+        ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
+        mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+    }
 
     // Wait until initialization is complete.
     FlushCommandQueue();
@@ -287,34 +613,223 @@ void TreeBillboardsApp::OnResize()
 	mCamera.SetLens(0.25f * MathHelper::Pi, AspectRatio(), 1.0f, 1000.0f);
 }
 
+LRESULT TreeBillboardsApp::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	if(msg == WM_KEYUP && (int)wParam == VK_F6)
+	{
+		SetFramesInFlight(mFramesInFlight - 1);
+		return 0;
+	}
+	if(msg == WM_KEYUP && (int)wParam == VK_F7)
+	{
+		SetFramesInFlight(mFramesInFlight + 1);
+		return 0;
+	}
+
+	return D3DApp::MsgProc(hwnd, msg, wParam, lParam);
+}
+
+void TreeBillboardsApp::SetFramesInFlight(UINT count)
+{
+	count = std::max<UINT>(1, std::min<UINT>(count, gMaxFramesInFlight));
+	if(count == mFramesInFlight)
+		return;
+
+	mFramesInFlight = count;
+	if(mFrameResources.empty())
+		return;
+
+	// No frame resource may be in use by the GPU while they are replaced.
+	FlushCommandQueue();
+
+	mFrameResources.clear();
+	mCurrFrameResource = nullptr;
+	mCurrFrameResourceIndex = 0;
+	BuildFrameResources();
+}
+
+bool TreeBillboardsApp::StartRecording(const std::string& path)
+{
+	return mRecorder.Open(path);
+}
+
+bool TreeBillboardsApp::StartReplay(const std::string& path)
+{
+	mRecorder.Close();
+	return mReplay.Open(path);
+}
+
+bool TreeBillboardsApp::StartBenchmark(UINT frameCount, const std::string& path)
+{
+	if(frameCount == 0)
+		return false;
+
+	mRecorder.Close();
+
+	// Along the approach to the maze, through it, up over the trees and out across
+	// the water.  Each key is an eye position and the point it looks at.
+	mBenchmarkPath = CameraPath();
+	mBenchmarkPath.AddKey({ 55.0f, 4.0f, -65.0f }, { 0.0f, 4.0f, 0.0f });
+	mBenchmarkPath.AddKey({ 20.0f, 3.0f, -30.0f }, { 0.0f, 3.0f, -20.0f });
+	mBenchmarkPath.AddKey({ 0.0f, 3.0f, -20.0f }, { 0.0f, 3.0f, -10.0f });
+	mBenchmarkPath.AddKey({ -20.0f, 3.0f, -10.0f }, { -20.0f, 3.0f, 10.0f });
+	mBenchmarkPath.AddKey({ -20.0f, 3.0f, 12.0f }, { 0.0f, 3.0f, 25.0f });
+	mBenchmarkPath.AddKey({ 0.0f, 20.0f, 40.0f }, { 0.0f, 5.0f, 0.0f });
+	mBenchmarkPath.AddKey({ 40.0f, 15.0f, 30.0f }, { 69.0f, 0.0f, 0.0f });
+	mBenchmarkPath.AddKey({ 69.0f, 8.0f, 0.0f }, { 100.0f, 0.0f, 0.0f });
+	mBenchmarkPath.AddKey({ 90.0f, 20.0f, -40.0f }, { 0.0f, 5.0f, 0.0f });
+	mBenchmarkPath.Build();
+
+	mBenchmarkOutput = path;
+	mBenchmarkFrames = frameCount;
+	mBenchmarkFrame = 0;
+	mBenchmarkSegments.assign(mBenchmarkPath.SegmentCount(), BenchmarkSegment());
+	return true;
+}
+
+void TreeBillboardsApp::TickTimer()
+{
+	// A fixed step, so every run simulates and draws the same frames.
+	if(mBenchmarkFrames > 0)
+	{
+		mTimer.Tick(mAppPaused ? 0.0 : 1.0 / 60.0);
+		return;
+	}
+
+	if(!mReplay.IsOpen())
+	{
+		mTimer.Tick();
+		return;
+	}
+
+	// A paused frame is not drawn, so it must not use up a recorded one.
+	if(mAppPaused)
+	{
+		mTimer.Tick(0.0);
+		return;
+	}
+
+	if(!mReplay.Next(mFrameInput))
+	{
+		if(!mReplayFinished)
+		{
+			mReplayFinished = true;
+
+			FrameStatsReport report = mFrameStats.OverallReport(mWallTimer.TotalTime());
+			std::string summary = "Replayed " + std::to_string(mReplay.FramesReplayed()) + " frames in " +
+				std::to_string(report.WindowSeconds) + " s: mean " + std::to_string(report.MeanMs) +
+				" ms, p99 " + std::to_string(report.P99Ms) + " ms, max " + std::to_string(report.MaxMs) + " ms";
+			if(Headless())
+			{
+				double frames = std::max<double>(mReplay.FramesReplayed(), 1.0);
+				summary += ", mean " + std::to_string(mNullTotalCommands / frames) + " commands and " +
+					std::to_string(mNullTotalIndices / frames) + " indices";
+			}
+			OutputDebugStringA((summary + "\n").c_str());
+			Quit();
+		}
+
+		// Idle until the run ends.
+		mFrameInput = RecordedFrame();
+		mFrameInput.Seed = mSeedState;
+	}
+
+	mTimer.Tick(mFrameInput.DeltaTime);
+}
+
+void TreeBillboardsApp::PollFrameInput(const GameTimer& gt)
+{
+	if(!mReplay.IsOpen())
+	{
+		mFrameInput = RecordedFrame();
+		mFrameInput.DeltaTime = gt.DeltaTime();
+
+		// Headless, there is no window for the keyboard to be read through.
+		if(!Headless())
+		{
+			if (GetAsyncKeyState('W') & 0x8000)
+				mFrameInput.Keys |= FrameRecording::KeyForward;
+			if (GetAsyncKeyState('S') & 0x8000)
+				mFrameInput.Keys |= FrameRecording::KeyBackward;
+			if (GetAsyncKeyState('A') & 0x8000)
+				mFrameInput.Keys |= FrameRecording::KeyLeft;
+			if (GetAsyncKeyState('D') & 0x8000)
+				mFrameInput.Keys |= FrameRecording::KeyRight;
+			if (GetAsyncKeyState(VK_SHIFT) & 0x8000)
+				mFrameInput.Keys |= FrameRecording::KeyFast;
+		}
+
+		mFrameInput.Pitch = mMousePitch;
+		mFrameInput.Yaw = mMouseYaw;
+
+		mSeedState += 0x9E3779B9u;
+		mFrameInput.Seed = mSeedState;
+
+		if(mRecorder.IsOpen())
+			mRecorder.Write(mFrameInput);
+	}
+
+	mMousePitch = 0.0f;
+	mMouseYaw = 0.0f;
+
+	// Everything random this frame (lightning, wave disturbances) follows the seed.
+	srand(mFrameInput.Seed);
+}
+
 void TreeBillboardsApp::Update(const GameTimer& gt)
 {
-    OnKeyboardInput(gt);
+	PROFILE_SCOPE("Update");
+
+	if(mBenchmarkFrames > 0)
+	{
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+		mBenchmarkFrameStart = counter.QuadPart;
+		mBenchmarkStallStart = mFenceWaiter.TotalStallMs();
+	}
+
+    PollFrameInput(gt);
+	if(mBenchmarkFrames > 0)
+		UpdateBenchmarkCamera();
+	else
+		OnKeyboardInput(gt);
 	UpdateCamera(gt);
 	mCamera.UpdateViewMatrix();
     // Cycle through the circular frame resource array.
-    mCurrFrameResourceIndex = (mCurrFrameResourceIndex + 1) % gNumFrameResources;
+    mCurrFrameResourceIndex = (mCurrFrameResourceIndex + 1) % (int)mFrameResources.size();
     mCurrFrameResource = mFrameResources[mCurrFrameResourceIndex].get();
 
     // Has the GPU finished processing the commands of the current frame resource?
     // If not, wait until the GPU has completed commands up to this fence point.
-    if(mCurrFrameResource->Fence != 0 && mFence->GetCompletedValue() < mCurrFrameResource->Fence)
-    {
-        HANDLE eventHandle = CreateEventEx(nullptr, nullptr, false, EVENT_ALL_ACCESS);
-        ThrowIfFailed(mFence->SetEventOnCompletion(mCurrFrameResource->Fence, eventHandle));
-        WaitForSingleObject(eventHandle, INFINITE);
-        CloseHandle(eventHandle);
-    }
+    if(mCurrFrameResource->Fence != 0)
+        mRenderDevice->WaitForFence(mCurrFrameResource->Fence);
+
+	// Whatever the GPU has finished with can be handed out again.
+	mUploadRing->Reclaim(mRenderDevice->CompletedFenceValue());
+
+	mSimulation.Advance(gt.DeltaTime());
 
 	AnimateMaterials(gt);
+	CullRenderItems();
 	UpdateObjectCBs(gt);
+	UpdateInstanceData(gt);
 	UpdateMaterialCBs(gt);
 	UpdateMainPassCB(gt);
     UpdateWaves(gt);
+	BuildRenderQueue();
 }
 
 void TreeBillboardsApp::Draw(const GameTimer& gt)
 {
+	PROFILE_SCOPE("Draw");
+
+	if(Headless())
+	{
+		DrawNull();
+		EndBenchmarkFrame();
+		return;
+	}
+
     auto cmdListAlloc = mCurrFrameResource->CmdListAlloc;
 
     // Reuse the memory associated with command recording.
@@ -323,10 +838,7 @@ void TreeBillboardsApp::Draw(const GameTimer& gt)
 
     // A command list can be reset after it has been added to the command queue via ExecuteCommandList.
     // Reusing the command list reuses memory.
-    ThrowIfFailed(mCommandList->Reset(cmdListAlloc.Get(), mPSOs["opaque"].Get()));
-
-    mCommandList->RSSetViewports(1, &mScreenViewport);
-    mCommandList->RSSetScissorRects(1, &mScissorRect);
+    ThrowIfFailed(mCommandList->Reset(cmdListAlloc.Get(), nullptr));
 
     // Indicate a state transition on the resource usage.
 	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
@@ -336,53 +848,118 @@ void TreeBillboardsApp::Draw(const GameTimer& gt)
     mCommandList->ClearRenderTargetView(CurrentBackBufferView(), (float*)&mMainPassCB.FogColor, 0, nullptr);
     mCommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
 
-    // Specify the buffers we are going to render to.
-    mCommandList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
+    ThrowIfFailed(mCommandList->Close());
 
-	ID3D12DescriptorHeap* descriptorHeaps[] = { mSrvDescriptorHeap.Get() };
-	mCommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+	//
+	// The sorted render queue is split into contiguous chunks, one per worker
+	// command list, which are recorded in parallel.  Small queues use fewer lists,
+	// since each one costs its own setup and submission.
+	//
+	const UINT drawCount = mRenderQueue.Count();
+	const UINT chunkCount = std::max<UINT>(1, std::min<UINT>(mRecordWorkerCount,
+		(drawCount + gMinDrawsPerCommandList - 1) / gMinDrawsPerCommandList));
 
-	mCommandList->SetGraphicsRootSignature(mRootSignature.Get());
+	concurrency::parallel_for(0u, chunkCount, [&](UINT chunk)
+	{
+		PROFILE_SCOPE("Record chunk");
 
-	auto passCB = mCurrFrameResource->PassCB->Resource();
-	mCommandList->SetGraphicsRootConstantBufferView(2, passCB->GetGPUVirtualAddress());
+		auto workerAlloc = mCurrFrameResource->WorkerCmdListAllocs[chunk];
+		auto workerList = mCurrFrameResource->WorkerCmdLists[chunk];
 
-    DrawRenderItems(mCommandList.Get(), mRitemLayer[(int)RenderLayer::Opaque]);
+		ThrowIfFailed(workerAlloc->Reset());
+		ThrowIfFailed(workerList->Reset(workerAlloc.Get(), nullptr));
 
-	mCommandList->SetPipelineState(mPSOs["alphaTested"].Get());
-	DrawRenderItems(mCommandList.Get(), mRitemLayer[(int)RenderLayer::AlphaTested]);
+		D3D12RenderCommandList recorder(workerList.Get());
+		SetFrameState(&recorder);
+		DrawRenderQueue(&recorder, drawCount * chunk / chunkCount, drawCount * (chunk + 1) / chunkCount);
 
-	mCommandList->SetPipelineState(mPSOs["opaque"].Get());
-	DrawRenderItems(mCommandList.Get(), mRitemLayer[(int)RenderLayer::Opaque]);
+		if(chunk == chunkCount - 1)
+		{
+			// Indicate a state transition on the resource usage.
+			workerList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
+				D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
+		}
 
-	mCommandList->SetPipelineState(mPSOs["treeSprites"].Get());
-	DrawRenderItems(mCommandList.Get(), mRitemLayer[(int)RenderLayer::AlphaTestedTreeSprites]);
+		ThrowIfFailed(workerList->Close());
+	});
 
-	mCommandList->SetPipelineState(mPSOs["transparent"].Get());
-	DrawRenderItems(mCommandList.Get(), mRitemLayer[(int)RenderLayer::Transparent]);
+    // Submit the clears and then the chunks in queue order, in one call.
+	std::vector<ID3D12CommandList*> cmdsLists;
+	cmdsLists.reserve(1 + chunkCount);
+	cmdsLists.push_back(mCommandList.Get());
+	for(UINT chunk = 0; chunk < chunkCount; ++chunk)
+		cmdsLists.push_back(mCurrFrameResource->WorkerCmdLists[chunk].Get());
+    mCommandQueue->ExecuteCommandLists((UINT)cmdsLists.size(), cmdsLists.data());
 
-    // Indicate a state transition on the resource usage.
-	mCommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
+    // Swap the back and front buffers
+    {
+        PROFILE_SCOPE("Present");
+        ThrowIfFailed(mSwapChain->Present(0, 0));
+    }
+	mCurrBackBuffer = (mCurrBackBuffer + 1) % SwapChainBufferCount;
 
-    // Done recording commands.
-    ThrowIfFailed(mCommandList->Close());
+    // Add an instruction to the command queue to set a new fence point, and mark
+    // the frame's commands with it.  Because we are on the GPU timeline, the new
+    // fence point won't be set until the GPU finishes processing all the commands
+    // prior to this Signal().
+    mCurrFrameResource->Fence = mRenderDevice->Signal();
 
-    // Add the command list to the queue for execution.
-    ID3D12CommandList* cmdsLists[] = { mCommandList.Get() };
-    mCommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+	// This frame's upload ring allocations are free once the GPU reaches the fence.
+	mUploadRing->EndFrame(mCurrFrameResource->Fence);
 
-    // Swap the back and front buffers
-    ThrowIfFailed(mSwapChain->Present(0, 0));
-	mCurrBackBuffer = (mCurrBackBuffer + 1) % SwapChainBufferCount;
+	EndBenchmarkFrame();
+}
 
-    // Advance the fence value to mark commands up to this fence point.
-    mCurrFrameResource->Fence = ++mCurrentFence;
+void TreeBillboardsApp::DrawNull()
+{
+	// Same chunking and recording as Draw, but into CPU-side streams; nothing is
+	// submitted or presented.  The null device's fence is still signalled so frame
+	// resources and the upload ring cycle exactly as they do when rendering.
+	const UINT drawCount = mRenderQueue.Count();
+	const UINT chunkCount = std::max<UINT>(1, std::min<UINT>(mRecordWorkerCount,
+		(drawCount + gMinDrawsPerCommandList - 1) / gMinDrawsPerCommandList));
+
+	mNullCmdLists.resize(mRecordWorkerCount);
+	concurrency::parallel_for(0u, chunkCount, [&](UINT chunk)
+	{
+		PROFILE_SCOPE("Record chunk");
+
+		NullRenderCommandList& recorder = mNullCmdLists[chunk];
+		recorder.Reset();
+
+		SetFrameState(&recorder);
+		DrawRenderQueue(&recorder, drawCount * chunk / chunkCount, drawCount * (chunk + 1) / chunkCount);
+	});
+
+	mNullFrameCommands = 0;
+	mNullFrameIndices = 0;
+	for(UINT chunk = 0; chunk < chunkCount; ++chunk)
+	{
+		mNullFrameCommands += mNullCmdLists[chunk].CommandCount();
+		mNullFrameIndices += mNullCmdLists[chunk].IndexCount();
+	}
+	mNullTotalCommands += mNullFrameCommands;
+	mNullTotalIndices += mNullFrameIndices;
 
-    // Add an instruction to the command queue to set a new fence point. 
-    // Because we are on the GPU timeline, the new fence point won't be 
-    // set until the GPU finishes processing all the commands prior to this Signal().
-    mCommandQueue->Signal(mFence.Get(), mCurrentFence);
+	mCurrFrameResource->Fence = mRenderDevice->Signal();
+	mUploadRing->EndFrame(mCurrFrameResource->Fence);
+}
+
+void TreeBillboardsApp::SetFrameState(RenderCommandList* cmdList)
+{
+	// Command lists do not inherit state from each other, so every list that draws
+	// needs the viewport, targets, heaps, root signature and pass constants.
+	cmdList->RSSetViewports(1, &mScreenViewport);
+	cmdList->RSSetScissorRects(1, &mScissorRect);
+
+	cmdList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
+
+	ID3D12DescriptorHeap* descriptorHeaps[] = { mSrvDescriptorHeap.Get() };
+	cmdList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+
+	cmdList->SetGraphicsRootSignature(mRootSignature.Get());
+
+	cmdList->SetGraphicsRootConstantBufferView(2, mPassCBAddress);
 }
 
 void TreeBillboardsApp::OnMouseDown(WPARAM btnState, int x, int y)
@@ -406,8 +983,9 @@ void TreeBillboardsApp::OnMouseMove(WPARAM btnState, int x, int y)
 		float dx = XMConvertToRadians(0.25f * static_cast<float>(x - mLastMousePos.x));
 		float dy = XMConvertToRadians(0.25f * static_cast<float>(y - mLastMousePos.y));
 
-		mCamera.Pitch(dy);
-		mCamera.RotateY(dx);
+		// Applied in OnKeyboardInput with the rest of the frame's input.
+		mMousePitch += dy;
+		mMouseYaw += dx;
 	}
 
 	mLastMousePos.x = x;
@@ -446,48 +1024,32 @@ void TreeBillboardsApp::OnKeyboardInput(const GameTimer& gt)
 {
 	const float dt = gt.DeltaTime();
 	float moveSpeed = mCameraMoveSpeed;
+	const std::uint32_t keys = mFrameInput.Keys;
+
+	mCamera.Pitch(mFrameInput.Pitch);
+	mCamera.RotateY(mFrameInput.Yaw);
 
-	if (GetAsyncKeyState(VK_SHIFT) & 0x8000)
+	if (keys & FrameRecording::KeyFast)
 		moveSpeed *= 5.0f;
 
 	XMFLOAT3 currentPos = mCamera.GetPosition3f();
 	XMVECTOR displacement = XMVectorZero();
 
-	if (GetAsyncKeyState('W') & 0x8000)
+	if (keys & FrameRecording::KeyForward)
 		displacement += mCamera.GetLook() * moveSpeed * dt;
-	if (GetAsyncKeyState('S') & 0x8000)
+	if (keys & FrameRecording::KeyBackward)
 		displacement -= mCamera.GetLook() * moveSpeed * dt;
-	if (GetAsyncKeyState('A') & 0x8000)
+	if (keys & FrameRecording::KeyLeft)
 		displacement -= mCamera.GetRight() * moveSpeed * dt;
-	if (GetAsyncKeyState('D') & 0x8000)
+	if (keys & FrameRecording::KeyRight)
 		displacement += mCamera.GetRight() * moveSpeed * dt;
 
-	// Calculate new position
-	XMVECTOR newPosVec = XMLoadFloat3(&currentPos) + displacement;
-	XMFLOAT3 newPos;
-	XMStoreFloat3(&newPos, newPosVec);
+	// Sweep the move against the colliders and slide along any wall it meets
+	XMFLOAT3 move;
+	XMStoreFloat3(&move, displacement);
 
-	// Create a bounding sphere for the camera (radius 0.5 units)
-	BoundingSphere cameraSphere;
-	cameraSphere.Center = newPos;
-	cameraSphere.Radius = 0.5f;
-
-	// Check against all colliders
-	bool collision = false;
-	for (const auto& collider : mColliders)
-	{
-		if (collider.Intersects(cameraSphere))
-		{
-			collision = true;
-			break;
-		}
-	}
-
-	// Update camera position only if no collision
-	if (!collision)
-	{
-		mCamera.SetPosition(newPos.x, newPos.y, newPos.z);
-	}
+	XMFLOAT3 newPos = mCameraController.Move(mColliderGrid, currentPos, move);
+	mCamera.SetPosition(newPos.x, newPos.y, newPos.z);
 	//const float dt = gt.DeltaTime();
 	//float moveSpeed = mCameraMoveSpeed;
 
@@ -513,82 +1075,400 @@ void TreeBillboardsApp::UpdateCamera(const GameTimer& gt)
 
 }
 
-void TreeBillboardsApp::AnimateMaterials(const GameTimer& gt)
+void TreeBillboardsApp::UpdateBenchmarkCamera()
+{
+	// Equal steps of arc length, so the camera crosses the path at constant speed
+	// and lands on the last key on the last frame.  A single frame is drawn from
+	// the first key.
+	float distance = 0.0f;
+	if(mBenchmarkFrames > 1)
+	{
+		distance = mBenchmarkPath.Length() * (float)std::min<UINT>(mBenchmarkFrame, mBenchmarkFrames - 1) /
+			(float)(mBenchmarkFrames - 1);
+	}
+
+	XMFLOAT3 position, target;
+	mBenchmarkSegment = mBenchmarkPath.Evaluate(distance, position, target);
+	mCamera.LookAt(position, target, XMFLOAT3(0.0f, 1.0f, 0.0f));
+}
+
+void TreeBillboardsApp::EndBenchmarkFrame()
+{
+	// Frames after the last one only wait for the run to end.
+	if(mBenchmarkFrames == 0 || mBenchmarkFrame >= mBenchmarkFrames)
+		return;
+
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+
+	double frameMs = (double)(counter.QuadPart - mBenchmarkFrameStart) * 1000.0 / (double)frequency.QuadPart;
+	double stallMs = mFenceWaiter.TotalStallMs() - mBenchmarkStallStart;
+	double cpuMs = std::max<double>(frameMs - stallMs, 0.0);
+
+	BenchmarkSegment& segment = mBenchmarkSegments[mBenchmarkSegment];
+	++segment.Frames;
+	segment.CpuMs += cpuMs;
+	segment.MaxCpuMs = std::max<double>(segment.MaxCpuMs, cpuMs);
+	segment.GpuWaitMs += stallMs;
+	segment.Draws += mRenderQueue.Count();
+	segment.Visible += mVisibleSlots.size();
+	segment.Culled += mScene.Count() - mVisibleSlots.size();
+	segment.Commands += mNullFrameCommands;
+	segment.Indices += mNullFrameIndices;
+
+	if(++mBenchmarkFrame == mBenchmarkFrames)
+	{
+		WriteBenchmark();
+		Quit();
+	}
+}
+
+void TreeBillboardsApp::WriteBenchmark()
 {
+	std::ofstream file(mBenchmarkOutput);
+	if(!file)
+	{
+		OutputDebugStringA(("Cannot write " + mBenchmarkOutput + "\n").c_str());
+		return;
+	}
+
+	// Means are per frame of the segment; the totals cover the whole run.
+	BenchmarkSegment total;
+
+	file << std::fixed << std::setprecision(4);
+	file << "{\n\"frames\":" << mBenchmarkFrames << ",\n\"delta_time\":" << 1.0 / 60.0
+		<< ",\n\"path_length\":" << mBenchmarkPath.Length() << ",\n\"segments\":[";
+
+	for(UINT i = 0; i < (UINT)mBenchmarkSegments.size(); ++i)
+	{
+		const BenchmarkSegment& segment = mBenchmarkSegments[i];
+		double frames = std::max<double>(segment.Frames, 1.0);
+
+		file << (i == 0 ? "\n" : ",\n");
+		file << "{\"segment\":" << i << ",\"frames\":" << segment.Frames
+			<< ",\"cpu_ms_mean\":" << segment.CpuMs / frames
+			<< ",\"cpu_ms_max\":" << segment.MaxCpuMs
+			<< ",\"gpu_wait_ms_mean\":" << segment.GpuWaitMs / frames
+			<< ",\"draws_mean\":" << segment.Draws / frames
+			<< ",\"visible_mean\":" << segment.Visible / frames
+			<< ",\"culled_mean\":" << segment.Culled / frames;
+		if(Headless())
+		{
+			file << ",\"commands_mean\":" << segment.Commands / frames
+				<< ",\"indices_mean\":" << segment.Indices / frames;
+		}
+		file << "}";
+
+		total.Frames += segment.Frames;
+		total.CpuMs += segment.CpuMs;
+		total.MaxCpuMs = std::max<double>(total.MaxCpuMs, segment.MaxCpuMs);
+		total.GpuWaitMs += segment.GpuWaitMs;
+		total.Draws += segment.Draws;
+		total.Visible += segment.Visible;
+		total.Culled += segment.Culled;
+		total.Commands += segment.Commands;
+		total.Indices += segment.Indices;
+	}
+
+	double frames = std::max<double>(total.Frames, 1.0);
+	file << "\n],\n\"total\":{\"cpu_ms\":" << total.CpuMs
+		<< ",\"cpu_ms_mean\":" << total.CpuMs / frames
+		<< ",\"cpu_ms_max\":" << total.MaxCpuMs
+		<< ",\"gpu_wait_ms\":" << total.GpuWaitMs
+		<< ",\"draws\":" << total.Draws
+		<< ",\"visible\":" << total.Visible
+		<< ",\"culled\":" << total.Culled
+		<< ",\"upload_ring_high_water_bytes\":" << mUploadRing->HighWaterMark()
+		<< ",\"upload_ring_capacity_bytes\":" << mUploadRing->Capacity();
+	if(Headless())
+		file << ",\"commands\":" << total.Commands << ",\"indices\":" << total.Indices;
+	file << "}\n}\n";
+
+	OutputDebugStringA(("Benchmark: " + std::to_string(total.Frames) + " frames, mean cpu " +
+		std::to_string(total.CpuMs / frames) + " ms, max " + std::to_string(total.MaxCpuMs) +
+		" ms, written to " + mBenchmarkOutput + "\n").c_str());
+}
+
+void TreeBillboardsApp::BuildSimulation()
+{
+	// One step of the wave solver per scheduler step.  Step rather than Update: the
+	// scheduler's dt (1 / (1 / TimeStep) in float) can land just under TimeStep, and
+	// Update's accumulator would then only solve on every second step.
+	mSimulation.AddSystem("Waves", 1.0f / mWaves->TimeStep(), [this](float dt)
+	{
+		mWaves->Step();
+	});
+
+	// Every quarter second, generate a random wave.
+	mSimulation.AddSystem("Wave disturbances", 4.0f, [this](float dt)
+	{
+		int i = MathHelper::Rand(4, mWaves->RowCount() - 5);
+		int j = MathHelper::Rand(4, mWaves->ColumnCount() - 5);
+
+		float r = MathHelper::RandF(0.2f, 0.5f);
+
+		mWaves->Disturb(i, j, r);
+	});
+
 	// Scroll the water material texture coordinates.
-	auto waterMat = mMaterials["water"].get();
+	mWaterScrollSystem = mSimulation.AddSystem("Water scroll", 30.0f, [this](float dt)
+	{
+		mWaterScrollPrev = mWaterScroll;
+
+		mWaterScroll.x += 0.1f * dt;
+		mWaterScroll.y += 0.02f * dt;
+
+		// Wrap both ends together so the pair stays blendable.
+		if(mWaterScrollPrev.x >= 1.0f)
+		{
+			mWaterScrollPrev.x -= 1.0f;
+			mWaterScroll.x -= 1.0f;
+		}
+		if(mWaterScrollPrev.y >= 1.0f)
+		{
+			mWaterScrollPrev.y -= 1.0f;
+			mWaterScroll.y -= 1.0f;
+		}
+	});
+
+	mSimulation.AddSystem("Lightning", 60.0f, [this](float dt)
+	{
+		StepLightning(dt);
+	});
+}
+
+void TreeBillboardsApp::StepLightning(float dt)
+{
+	// randomly changing the light 
+	mLightningTimer += dt;
+
+	if (mLightningActive)
+	{
+		if (mLightningTimer >= mLightningDuration)
+		{
+			mLightningCooldown = 1.0f + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (5.0f - 1.0f)));
 
-	float& tu = waterMat->MatTransform(3, 0);
-	float& tv = waterMat->MatTransform(3, 1);
+			mLightningActive = false;
+			mLightningTimer = 0.0f;
+		}
+	}
+	else
+	{
+		if (mLightningTimer >= mLightningCooldown)
+		{
+			mLightningActive = true;
+			mLightningTimer = 0.0f;
+		}
+	}
+}
 
-	tu += 0.1f * gt.DeltaTime();
-	tv += 0.02f * gt.DeltaTime();
+void TreeBillboardsApp::AnimateMaterials(const GameTimer& gt)
+{
+	PROFILE_SCOPE("AnimateMaterials");
 
-	if(tu >= 1.0f)
-		tu -= 1.0f;
+	// Draw the water scroll between its last two steps, wrapped to [0, 1).
+	auto waterMat = mMaterials[mWaterMat].get();
 
-	if(tv >= 1.0f)
-		tv -= 1.0f;
+	float alpha = mSimulation.Alpha(mWaterScrollSystem);
+	float tu = mWaterScrollPrev.x + (mWaterScroll.x - mWaterScrollPrev.x) * alpha;
+	float tv = mWaterScrollPrev.y + (mWaterScroll.y - mWaterScrollPrev.y) * alpha;
 
-	waterMat->MatTransform(3, 0) = tu;
-	waterMat->MatTransform(3, 1) = tv;
+	waterMat->MatTransform(3, 0) = tu - floorf(tu);
+	waterMat->MatTransform(3, 1) = tv - floorf(tv);
 
 	// Material has changed, so need to update cbuffer.
-	waterMat->NumFramesDirty = gNumFrameResources;
+	MarkMaterialDirty(waterMat->MatCBIndex);
+}
+
+void TreeBillboardsApp::CullRenderItems()
+{
+	PROFILE_SCOPE("CullRenderItems");
+
+	XMFLOAT4 planes[6];
+	FrustumCulling::ExtractPlanes(XMMatrixMultiply(mCamera.GetView(), mCamera.GetProj()), planes);
+
+	XMFLOAT4X4 view;
+	XMStoreFloat4x4(&view, mCamera.GetView());
+	const float nearZ = mCamera.GetNearZ();
+	const float farZ = mCamera.GetFarZ();
+
+	FrustumCulling::Cull(planes, mScene.Bounds(), mVisibleSlots);
+
+	mItemVisible.assign(mScene.Count(), 0);
+	mItemDepths.resize(mScene.Count());
+	for(auto& visible : mVisibleItems)
+		visible.clear();
+
+	const AabbList& bounds = mScene.Bounds();
+	const UINT* layers = mScene.Layers();
+	for(UINT slot : mVisibleSlots)
+	{
+		mVisibleItems[layers[slot]].push_back(slot);
+		mItemVisible[slot] = 1;
+
+		// View space depth of the item's bounds center.
+		float depth = bounds.CenterX()[slot]*view._13 + bounds.CenterY()[slot]*view._23 + bounds.CenterZ()[slot]*view._33 + view._43;
+		mItemDepths[slot] = RenderQueue::QuantizeDepth(depth, nearZ, farZ);
+	}
+}
+
+void TreeBillboardsApp::MarkObjectDirty(UINT objCBIndex)
+{
+	// Every frame resource has its own copy of the constants.  A handle created
+	// since a list was sized is queued by growing the list.
+	for(auto& frameResource : mFrameResources)
+	{
+		if(objCBIndex >= frameResource->DirtyObjects.Capacity())
+			frameResource->DirtyObjects.Grow(mScene.HandleCapacity());
+		else
+			frameResource->DirtyObjects.Mark(objCBIndex);
+	}
+}
+
+void TreeBillboardsApp::MarkMaterialDirty(UINT matCBIndex)
+{
+	// Every frame resource has its own copy of the constants.
+	for(auto& frameResource : mFrameResources)
+		frameResource->DirtyMaterials.Mark(matCBIndex);
 }
 
 void TreeBillboardsApp::UpdateObjectCBs(const GameTimer& gt)
 {
-	auto currObjectCB = mCurrFrameResource->ObjectCB.get();
-	for(auto& e : mAllRitems)
+	PROFILE_SCOPE("UpdateObjectCBs");
+
+	// Items created or changed in the scene store since last frame are stale in
+	// every frame resource.
+	mScene.FlushDirty([&](UINT handle)
 	{
-		// Only update the cbuffer data if the constants have changed.  
-		// This needs to be tracked per frame resource.
-		if(e->NumFramesDirty > 0)
-		{
-			XMMATRIX world = XMLoadFloat4x4(&e->World);
-			XMMATRIX texTransform = XMLoadFloat4x4(&e->TexTransform);
+		MarkObjectDirty(handle);
+	});
+
+	// The GPU is done with this frame resource, so if the scene has outgrown its
+	// ObjectCB the buffer can simply be replaced.  The new one holds nothing yet,
+	// so every object is rewritten into it.
+	FrameResource* frameResource = mCurrFrameResource;
+	if(frameResource->ObjectCBCapacity < mScene.HandleCapacity())
+	{
+		UINT capacity = std::max<UINT>(mScene.HandleCapacity(), 2 * frameResource->ObjectCBCapacity);
+		frameResource->ObjectCB = std::make_unique<UploadBuffer<ObjectConstants>>(mRenderDevice.get(), capacity, true);
+		frameResource->ObjectCBCapacity = capacity;
+		frameResource->DirtyObjects.Reset(capacity);
+	}
+
+	// Only the objects whose constants changed since this frame resource was last
+	// used are rewritten.
+	auto currObjectCB = frameResource->ObjectCB.get();
+	const XMFLOAT4X4* worlds = mScene.Worlds();
+	const XMFLOAT4X4* texTransforms = mScene.TexTransforms();
+	frameResource->DirtyObjects.Flush([&](UINT handle)
+	{
+		// Spare capacity and destroyed items have nothing to write.
+		if(handle >= mScene.HandleCapacity())
+			return;
+
+		UINT slot = mScene.Slot(handle);
+		if(slot == SceneStore::InvalidHandle)
+			return;
 
-			ObjectConstants objConstants;
-			XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
-			XMStoreFloat4x4(&objConstants.TexTransform, XMMatrixTranspose(texTransform));
+		XMMATRIX world = XMLoadFloat4x4(&worlds[slot]);
+		XMMATRIX texTransform = XMLoadFloat4x4(&texTransforms[slot]);
 
-			currObjectCB->CopyData(e->ObjCBIndex, objConstants);
+		ObjectConstants objConstants;
+		XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
+		XMStoreFloat4x4(&objConstants.TexTransform, XMMatrixTranspose(texTransform));
+
+		currObjectCB->CopyData(handle, objConstants);
+	});
+}
 
-			// Next FrameResource need to be updated too.
-			e->NumFramesDirty--;
+void TreeBillboardsApp::UpdateInstanceData(const GameTimer& gt)
+{
+	PROFILE_SCOPE("UpdateInstanceData");
+
+	// Instanced items are packed per batch every frame rather than tracked with
+	// dirty flags, so a batch only ever holds the instances that passed culling.
+	// They are packed nearest first: instances of one draw rasterize in order, so
+	// this gives early-Z the same front-to-back order as separate draws would.
+	const XMFLOAT4X4* worlds = mScene.Worlds();
+	const XMFLOAT4X4* texTransforms = mScene.TexTransforms();
+	for(auto& layer : mInstanceBatches)
+	{
+		for(auto& batch : layer)
+		{
+			mInstanceDepths.clear();
+			mInstanceItems.clear();
+			for(UINT handle : batch.Items)
+			{
+				UINT slot = mScene.Slot(handle);
+				if(!mItemVisible[slot])
+					continue;
+
+				mInstanceDepths.push_back(mItemDepths[slot]);
+				mInstanceItems.push_back(slot);
+			}
+
+			const size_t count = mInstanceItems.size();
+			if(mInstanceScratchDepths.size() < count)
+			{
+				mInstanceScratchDepths.resize(count);
+				mInstanceScratchItems.resize(count);
+			}
+			RadixSort::SortPairs(mInstanceDepths.data(), mInstanceItems.data(),
+				mInstanceScratchDepths.data(), mInstanceScratchItems.data(), count);
+
+			batch.InstanceCount = (UINT)count;
+			batch.NearestDepth = count > 0 ? mInstanceDepths[0] : 0;
+			batch.InstanceAddress = 0;
+			if(count == 0)
+				continue;
+
+			UploadRing::Allocation instances = mUploadRing->Allocate(count*sizeof(InstanceData));
+			InstanceData* instanceData = static_cast<InstanceData*>(instances.Cpu);
+			batch.InstanceAddress = instances.Gpu;
+
+			for(size_t n = 0; n < count; ++n)
+			{
+				const UINT slot = mInstanceItems[n];
+
+				XMMATRIX world = XMLoadFloat4x4(&worlds[slot]);
+				XMMATRIX texTransform = XMLoadFloat4x4(&texTransforms[slot]);
+
+				InstanceData data;
+				XMStoreFloat4x4(&data.World, XMMatrixTranspose(world));
+				XMStoreFloat4x4(&data.TexTransform, XMMatrixTranspose(texTransform));
+
+				instanceData[n] = data;
+			}
 		}
 	}
 }
 
 void TreeBillboardsApp::UpdateMaterialCBs(const GameTimer& gt)
 {
+	PROFILE_SCOPE("UpdateMaterialCBs");
+
 	auto currMaterialCB = mCurrFrameResource->MaterialCB.get();
-	for(auto& e : mMaterials)
+	mCurrFrameResource->DirtyMaterials.Flush([&](UINT matCBIndex)
 	{
-		// Only update the cbuffer data if the constants have changed.  If the cbuffer
-		// data changes, it needs to be updated for each FrameResource.
-		Material* mat = e.second.get();
-		if(mat->NumFramesDirty > 0)
-		{
-			XMMATRIX matTransform = XMLoadFloat4x4(&mat->MatTransform);
+		const Material* mat = mMaterialsByCBIndex[matCBIndex];
 
-			MaterialConstants matConstants;
-			matConstants.DiffuseAlbedo = mat->DiffuseAlbedo;
-			matConstants.FresnelR0 = mat->FresnelR0;
-			matConstants.Roughness = mat->Roughness;
-			XMStoreFloat4x4(&matConstants.MatTransform, XMMatrixTranspose(matTransform));
+		XMMATRIX matTransform = XMLoadFloat4x4(&mat->MatTransform);
 
-			currMaterialCB->CopyData(mat->MatCBIndex, matConstants);
+		MaterialConstants matConstants;
+		matConstants.DiffuseAlbedo = mat->DiffuseAlbedo;
+		matConstants.FresnelR0 = mat->FresnelR0;
+		matConstants.Roughness = mat->Roughness;
+		XMStoreFloat4x4(&matConstants.MatTransform, XMMatrixTranspose(matTransform));
 
-			// Next FrameResource need to be updated too.
-			mat->NumFramesDirty--;
-		}
-	}
+		currMaterialCB->CopyData(matCBIndex, matConstants);
+	});
 }
 
 void TreeBillboardsApp::UpdateMainPassCB(const GameTimer& gt)
 {
+	PROFILE_SCOPE("UpdateMainPassCB");
+
 	XMMATRIX view = mCamera.GetView();
 	XMMATRIX proj = mCamera.GetProj();
 	//XMMATRIX view = XMLoadFloat4x4(&mView);
@@ -617,80 +1497,40 @@ void TreeBillboardsApp::UpdateMainPassCB(const GameTimer& gt)
 
 	mMainPassCB.FogColor = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f); // fog color black
 
-	// randomly changing the light 
-	static float lightningTimer = 0.0f;
-	static bool lightningActive = false;
-	static float lightningDuration = 0.1f; // Duration of each lightning 
-	static float lightningCooldown = 3.0f; // lightning flashes
-
-	lightningTimer += gt.DeltaTime();
-
-	if (lightningActive)
+	// The lightning timer is stepped by the simulation; only its state is read here.
+	if (mLightningActive)
 	{
-		if (lightningTimer >= lightningDuration)
-		{
-			lightningCooldown = 1.0f + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (5.0f - 1.0f)));
-
-			lightningActive = false;
-			lightningTimer = 0.0f;
-		}
-		else
-		{
-			// Bright white light for lightning
-			mMainPassCB.Lights[0].Strength = { 1.0f, 1.0f, 1.0f };
-			mMainPassCB.Lights[1].Strength = { 1.0f, 1.0f, 1.0f };
-			mMainPassCB.Lights[2].Strength = { 1.0f, 1.0f, 1.0f };
-			mMainPassCB.Lights[3].Strength = { 1.0f, 1.0f, 1.0f };
-		}
+		// Bright white light for lightning
+		mMainPassCB.Lights[0].Strength = { 1.0f, 1.0f, 1.0f };
+		mMainPassCB.Lights[1].Strength = { 1.0f, 1.0f, 1.0f };
+		mMainPassCB.Lights[2].Strength = { 1.0f, 1.0f, 1.0f };
+		mMainPassCB.Lights[3].Strength = { 1.0f, 1.0f, 1.0f };
 	}
 	else
 	{
-		if (lightningTimer >= lightningCooldown)
-		{
-			lightningActive = true;
-			lightningTimer = 0.0f;
-		}
-		else
-		{
-			// Normal lighting conditions
-			mMainPassCB.Lights[0].Direction = { 0.57735f, -0.57735f, 0.57735f };
-			mMainPassCB.Lights[0].Strength = { 0.15f, 0.15f, 0.0f };
-			mMainPassCB.Lights[1].Direction = { -0.57735f, -0.57735f, 0.57735f };
-			mMainPassCB.Lights[1].Strength = { 1.0f, 0.5f, 0.0f };
-			mMainPassCB.Lights[2].Direction = { 0.0f, -0.707f, -0.707f };
-			mMainPassCB.Lights[2].Strength = { 1.0f, 1.0f, 0.0f };
-			mMainPassCB.Lights[3].Direction = { 0.0f, 0.707f, 0.707f };
-			mMainPassCB.Lights[3].Strength = { 1.0f, 0.5f, 0.0f };
-		}
+		// Normal lighting conditions
+		mMainPassCB.Lights[0].Direction = { 0.57735f, -0.57735f, 0.57735f };
+		mMainPassCB.Lights[0].Strength = { 0.15f, 0.15f, 0.0f };
+		mMainPassCB.Lights[1].Direction = { -0.57735f, -0.57735f, 0.57735f };
+		mMainPassCB.Lights[1].Strength = { 1.0f, 0.5f, 0.0f };
+		mMainPassCB.Lights[2].Direction = { 0.0f, -0.707f, -0.707f };
+		mMainPassCB.Lights[2].Strength = { 1.0f, 1.0f, 0.0f };
+		mMainPassCB.Lights[3].Direction = { 0.0f, 0.707f, 0.707f };
+		mMainPassCB.Lights[3].Strength = { 1.0f, 0.5f, 0.0f };
 	}
 
 
-	auto currPassCB = mCurrFrameResource->PassCB.get();
-	currPassCB->CopyData(0, mMainPassCB);
+	mPassCBAddress = mUploadRing->AllocateConstants(mMainPassCB);
 
 
 }
 
 void TreeBillboardsApp::UpdateWaves(const GameTimer& gt)
 {
-	// Every quarter second, generate a random wave.
-	static float t_base = 0.0f;
-	if((mTimer.TotalTime() - t_base) >= 0.25f)
-	{
-		t_base += 0.25f;
-
-		int i = MathHelper::Rand(4, mWaves->RowCount() - 5);
-		int j = MathHelper::Rand(4, mWaves->ColumnCount() - 5);
-
-		float r = MathHelper::RandF(0.2f, 0.5f);
-
-		mWaves->Disturb(i, j, r);
-	}
+	PROFILE_SCOPE("UpdateWaves");
 
-	// Update the wave simulation.
-	mWaves->Update(gt.DeltaTime());
-
-	// Update the wave vertex buffer with the new solution.
+	// The wave simulation itself is stepped by mSimulation; this uploads its
+	// current solution.
 	auto currWavesVB = mCurrFrameResource->WavesVB.get();
 	for(int i = 0; i < mWaves->VertexCount(); ++i)
 	{
@@ -707,101 +1547,82 @@ void TreeBillboardsApp::UpdateWaves(const GameTimer& gt)
 		currWavesVB->CopyData(i, v);
 	}
 
-	// Set the dynamic VB of the wave renderitem to the current frame VB.
-	mWavesRitem->Geo->VertexBufferGPU = currWavesVB->Resource();
+	// Set the dynamic VB of the water geometry to the current frame VB.
+	mWavesGeo->VertexBufferGPU = currWavesVB->Resource();
 }
 
-void TreeBillboardsApp::LoadTextures()
+void TreeBillboardsApp::BuildRenderQueue()
 {
-	auto grassTex = std::make_unique<Texture>();
-	grassTex->Name = "grassTex";
-	grassTex->Filename = L"../../Textures/grass.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), grassTex->Filename.c_str(),
-		grassTex->Resource, grassTex->UploadHeap));
-
-	auto waterTex = std::make_unique<Texture>();
-	waterTex->Name = "waterTex";
-	waterTex->Filename = L"../../Textures/water1.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), waterTex->Filename.c_str(),
-		waterTex->Resource, waterTex->UploadHeap));
-
-	auto fenceTex = std::make_unique<Texture>();
-	fenceTex->Name = "fenceTex";
-	fenceTex->Filename = L"../../Textures/diamond1.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), fenceTex->Filename.c_str(),
-		fenceTex->Resource, fenceTex->UploadHeap));
-
-	auto bricksTex = std::make_unique<Texture>();
-	bricksTex->Name = "bricksTex";
-	bricksTex->Filename = L"../../Textures/subsea.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), bricksTex->Filename.c_str(),
-		bricksTex->Resource, bricksTex->UploadHeap));
-
-	auto treeArrayTex = std::make_unique<Texture>();
-	treeArrayTex->Name = "treeArrayTex";
-	treeArrayTex->Filename = L"../../Textures/crookTextureArray.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), treeArrayTex->Filename.c_str(),
-		treeArrayTex->Resource, treeArrayTex->UploadHeap));
-
-	auto bricks3Tex = std::make_unique<Texture>();
-	bricks3Tex->Name = "bricks3Tex";
-	bricks3Tex->Filename = L"../../Textures/wall.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), bricks3Tex->Filename.c_str(),
-		bricks3Tex->Resource, bricks3Tex->UploadHeap));
-
-	auto woodCrateTex = std::make_unique<Texture>();
-	woodCrateTex->Name = "woodCrateTex";
-	woodCrateTex->Filename = L"../../Textures/wooddoor.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), woodCrateTex->Filename.c_str(),
-		woodCrateTex->Resource, woodCrateTex->UploadHeap));
-
-	auto tileTex = std::make_unique<Texture>();
-	tileTex->Name = "tileTex";
-	tileTex->Filename = L"../../Textures/wooden_roof.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), tileTex->Filename.c_str(),
-		tileTex->Resource, tileTex->UploadHeap));
-
-	auto checkboardTex = std::make_unique<Texture>();
-	checkboardTex->Name = "checkboardTex";
-	checkboardTex->Filename = L"../../Textures/jerus.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), checkboardTex->Filename.c_str(),
-		checkboardTex->Resource, checkboardTex->UploadHeap));
-
-	auto bricks2Tex = std::make_unique<Texture>();
-	bricks2Tex->Name = "bricks2Tex";
-	bricks2Tex->Filename = L"../../Textures/brick5.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), bricks2Tex->Filename.c_str(),
-		bricks2Tex->Resource, bricks2Tex->UploadHeap));
-
-	auto mazeWallTex = std::make_unique<Texture>();
-	mazeWallTex->Name = "mazeWallTex";
-	mazeWallTex->Filename = L"../../Textures/wall.dds";
-	ThrowIfFailed(DirectX::CreateDDSTextureFromFile12(md3dDevice.Get(),
-		mCommandList.Get(), mazeWallTex->Filename.c_str(),
-		mazeWallTex->Resource, mazeWallTex->UploadHeap));
-
-	mTextures[grassTex->Name] = std::move(grassTex);
-	mTextures[waterTex->Name] = std::move(waterTex);
-	mTextures[fenceTex->Name] = std::move(fenceTex);
-	mTextures[bricksTex->Name] = std::move(bricksTex);
-	mTextures[treeArrayTex->Name] = std::move(treeArrayTex);
-	mTextures[bricks3Tex->Name] = std::move(bricks3Tex);
-	mTextures[woodCrateTex->Name] = std::move(woodCrateTex);
-	mTextures[tileTex->Name] = std::move(tileTex);
-	mTextures[checkboardTex->Name] = std::move(checkboardTex);
-	mTextures[bricks2Tex->Name] = std::move(bricks2Tex);
-	mTextures[mazeWallTex->Name] = std::move(mazeWallTex);
+	PROFILE_SCOPE("BuildRenderQueue");
+
+	mDrawPackets.clear();
+	mRenderQueue.Clear();
+
+	// Each pass uses a single PSO, so the pass index doubles as the key's PSO id.
+	for(UINT pass = 0; pass < (UINT)RenderLayer::Count; ++pass)
+	{
+		const LayerPass& layerPass = mLayerPasses[pass];
+		const int layer = (int)layerPass.Layer;
 
+		if(layerPass.Instanced)
+		{
+			// A batch's depth is that of its nearest instance.  Being below the
+			// state fields, it only orders batches with the same material and geometry.
+			for(const auto& batch : mInstanceBatches[layer])
+			{
+				if(batch.InstanceCount == 0)
+					continue;
+
+				DrawPacket packet;
+				packet.Pso = layerPass.Pso;
+				packet.Batch = &batch;
+
+				mRenderQueue.Add(RenderQueue::MakeKey(pass, pass, batch.MatId, batch.GeoId, batch.NearestDepth), (UINT)mDrawPackets.size());
+				mDrawPackets.push_back(packet);
+			}
+		}
+		else
+		{
+			const UINT* geometries = mScene.Geometries();
+			const UINT* materials = mScene.Materials();
+			for(UINT slot : mVisibleItems[layer])
+			{
+				const UINT depth = mItemDepths[slot];
+
+				DrawPacket packet;
+				packet.Pso = layerPass.Pso;
+				packet.ItemSlot = slot;
+
+				UINT64 key = layerPass.BackToFront ?
+					RenderQueue::MakeBackToFrontKey(pass, pass, materials[slot], geometries[slot], depth) :
+					RenderQueue::MakeKey(pass, pass, materials[slot], geometries[slot], depth);
+				mRenderQueue.Add(key, (UINT)mDrawPackets.size());
+				mDrawPackets.push_back(packet);
+			}
+		}
+	}
+
+	mRenderQueue.Sort();
+}
+
+void TreeBillboardsApp::LoadTextures()
+{
+	// The files are read in parallel; creation and upload recording happen here.
+	TextureLoader loader;
+	loader.Add("grassTex", L"../../Textures/grass.dds");
+	loader.Add("waterTex", L"../../Textures/water1.dds");
+	loader.Add("fenceTex", L"../../Textures/diamond1.dds");
+	loader.Add("bricksTex", L"../../Textures/subsea.dds");
+	loader.Add("treeArrayTex", L"../../Textures/crookTextureArray.dds");
+	loader.Add("bricks3Tex", L"../../Textures/wall.dds");
+	loader.Add("woodCrateTex", L"../../Textures/wooddoor.dds");
+	loader.Add("tileTex", L"../../Textures/wooden_roof.dds");
+	loader.Add("checkboardTex", L"../../Textures/jerus.dds");
+	loader.Add("bricks2Tex", L"../../Textures/brick5.dds");
+	loader.Add("mazeWallTex", L"../../Textures/wall.dds");
+
+	for(auto& tex : loader.Load(md3dDevice.Get(), mCommandList.Get()))
+		mTextures.Add(tex->Name, std::move(tex));
 }
 
 void TreeBillboardsApp::BuildRootSignature()
@@ -810,19 +1631,20 @@ void TreeBillboardsApp::BuildRootSignature()
 	texTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
 
     // Root parameter can be a table, root descriptor or root constants.
-    CD3DX12_ROOT_PARAMETER slotRootParameter[4];
+    CD3DX12_ROOT_PARAMETER slotRootParameter[5];
 
 	// Perfomance TIP: Order from most frequent to least frequent.
 	slotRootParameter[0].InitAsDescriptorTable(1, &texTable, D3D12_SHADER_VISIBILITY_PIXEL);
     slotRootParameter[1].InitAsConstantBufferView(0);
     slotRootParameter[2].InitAsConstantBufferView(1);
     slotRootParameter[3].InitAsConstantBufferView(2);
+	slotRootParameter[4].InitAsShaderResourceView(1, 0, D3D12_SHADER_VISIBILITY_VERTEX);
 
 
 	auto staticSamplers = GetStaticSamplers();
 
     // A root signature is an array of root parameters.
-	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(4, slotRootParameter,
+	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(5, slotRootParameter,
 		(UINT)staticSamplers.size(), staticSamplers.data(),
 		D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
@@ -861,17 +1683,17 @@ void TreeBillboardsApp::BuildDescriptorHeaps()
 	//
 	CD3DX12_CPU_DESCRIPTOR_HANDLE hDescriptor(mSrvDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
 
-	auto grassTex = mTextures["grassTex"]->Resource;
-	auto waterTex = mTextures["waterTex"]->Resource;
-	auto fenceTex = mTextures["fenceTex"]->Resource;
-	auto bricksTex = mTextures["bricksTex"]->Resource;
-	auto treeArrayTex = mTextures["treeArrayTex"]->Resource;
-	auto bricks3Tex = mTextures["bricks3Tex"]->Resource;
-	auto woodCrateTex = mTextures["woodCrateTex"]->Resource;
-	auto tileTex = mTextures["tileTex"]->Resource; 
-	auto checkboardTex = mTextures["checkboardTex"]->Resource; 
-	auto bricks2Tex = mTextures["bricks2Tex"]->Resource; 
-	auto mazeWallTex = mTextures["mazeWallTex"]->Resource;
+	auto grassTex = mTextures.Get("grassTex")->Resource;
+	auto waterTex = mTextures.Get("waterTex")->Resource;
+	auto fenceTex = mTextures.Get("fenceTex")->Resource;
+	auto bricksTex = mTextures.Get("bricksTex")->Resource;
+	auto treeArrayTex = mTextures.Get("treeArrayTex")->Resource;
+	auto bricks3Tex = mTextures.Get("bricks3Tex")->Resource;
+	auto woodCrateTex = mTextures.Get("woodCrateTex")->Resource;
+	auto tileTex = mTextures.Get("tileTex")->Resource; 
+	auto checkboardTex = mTextures.Get("checkboardTex")->Resource; 
+	auto bricks2Tex = mTextures.Get("bricks2Tex")->Resource; 
+	auto mazeWallTex = mTextures.Get("mazeWallTex")->Resource;
 
 
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
@@ -958,6 +1780,7 @@ void TreeBillboardsApp::BuildShadersAndInputLayouts()
 	};
 
 	mShaders["standardVS"] = d3dUtil::CompileShader(L"Shaders\\Default.hlsl", nullptr, "VS", "vs_5_1");
+	mShaders["instancedVS"] = d3dUtil::CompileShader(L"Shaders\\Default.hlsl", nullptr, "VSInstanced", "vs_5_1");
 	mShaders["opaquePS"] = d3dUtil::CompileShader(L"Shaders\\Default.hlsl", defines, "PS", "ps_5_1");
 	mShaders["alphaTestedPS"] = d3dUtil::CompileShader(L"Shaders\\Default.hlsl", alphaTestDefines, "PS", "ps_5_1");
 	
@@ -981,6 +1804,9 @@ void TreeBillboardsApp::BuildShadersAndInputLayouts()
 
 void TreeBillboardsApp::BuildLandGeometry()
 {
+    if(LoadCookedGeometry("landGeo"))
+        return;
+
     GeometryGenerator geoGen;
     GeometryGenerator::MeshData grid = geoGen.CreateGrid(160.0f, 160.0f, 50, 50);
 
@@ -996,9 +1822,7 @@ void TreeBillboardsApp::BuildLandGeometry()
         auto& p = grid.Vertices[i].Position;
         vertices[i].Pos = p;
 		vertices[i].Pos.y = 0.0f; // Set Y to 0 to make it completely flat
-		vertices[i].Normal = XMFLOAT3(0.0f, 1.0f, 0.0f);
         //vertices[i].Pos.y = GetHillsHeight(p.x, p.z);
-        //vertices[i].Normal = GetHillsNormal(p.x, p.z);
 		vertices[i].TexC = grid.Vertices[i].TexC;
     }
 
@@ -1007,6 +1831,16 @@ void TreeBillboardsApp::BuildLandGeometry()
     std::vector<std::uint16_t> indices = grid.GetIndices16();
     const UINT ibByteSize = (UINT)indices.size() * sizeof(std::uint16_t);
 
+	// Normals from the triangles, so they follow whatever height function is
+	// applied above.  Vertex has no tangent, so none are produced.
+	GeometryGenerator::VertexStreams streams;
+	streams.Position = &vertices[0].Pos;
+	streams.PositionStride = sizeof(Vertex);
+	streams.Normal = &vertices[0].Normal;
+	streams.NormalStride = sizeof(Vertex);
+	streams.VertexCount = (UINT)vertices.size();
+	GeometryGenerator::ComputeNormalsAndTangents(streams, indices.data(), (UINT)indices.size());
+
 	auto geo = std::make_unique<MeshGeometry>();
 	geo->Name = "landGeo";
 
@@ -1016,11 +1850,11 @@ void TreeBillboardsApp::BuildLandGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1034,7 +1868,10 @@ void TreeBillboardsApp::BuildLandGeometry()
 
 	geo->DrawArgs["grid"] = submesh;
 
-	mGeometries["landGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("landGeo", std::move(geo));
 }
 
 void TreeBillboardsApp::BuildWavesGeometry()
@@ -1075,8 +1912,8 @@ void TreeBillboardsApp::BuildWavesGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1088,13 +1925,22 @@ void TreeBillboardsApp::BuildWavesGeometry()
 	submesh.StartIndexLocation = 0;
 	submesh.BaseVertexLocation = 0;
 
+	// The vertices are rewritten every frame, so bound the grid plus some room
+	// for the wave height rather than any one solution.
+	submesh.Bounds = BoundingBox(XMFLOAT3(0.0f, 0.0f, 0.0f),
+		XMFLOAT3(0.5f*mWaves->Width(), 2.0f, 0.5f*mWaves->Depth()));
+
 	geo->DrawArgs["grid"] = submesh;
 
-	mGeometries["waterGeo"] = std::move(geo);
+	mWavesGeo = geo.get();
+	mGeometries.Add("waterGeo", std::move(geo));
 }
 
 void TreeBillboardsApp::BuildBoxGeometry()
 {
+	if(LoadCookedGeometry("boxGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData box = geoGen.CreateBox(15.0f, 8.0f, 15.0f, 3);
 
@@ -1121,11 +1967,11 @@ void TreeBillboardsApp::BuildBoxGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1139,7 +1985,10 @@ void TreeBillboardsApp::BuildBoxGeometry()
 
 	geo->DrawArgs["box"] = submesh;
 
-	mGeometries["boxGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("boxGeo", std::move(geo));
 }
 
 void TreeBillboardsApp::BuildTreeSpritesGeometry()
@@ -1210,11 +2059,11 @@ void TreeBillboardsApp::BuildTreeSpritesGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(TreeSpriteVertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1226,12 +2075,28 @@ void TreeBillboardsApp::BuildTreeSpritesGeometry()
 	submesh.StartIndexLocation = 0;
 	submesh.BaseVertexLocation = 0;
 
+	// The geometry shader expands each point into a billboard facing the eye, so
+	// grow the bounds by half a sprite in every direction it can face.
+	XMVECTOR vMin = XMVectorReplicate(+MathHelper::Infinity);
+	XMVECTOR vMax = XMVectorReplicate(-MathHelper::Infinity);
+	for(const TreeSpriteVertex& v : vertices)
+	{
+		XMVECTOR half = XMVectorSet(0.5f*v.Size.x, 0.5f*v.Size.y, 0.5f*v.Size.x, 0.0f);
+		XMVECTOR p = XMLoadFloat3(&v.Pos);
+		vMin = XMVectorMin(vMin, XMVectorSubtract(p, half));
+		vMax = XMVectorMax(vMax, XMVectorAdd(p, half));
+	}
+	BoundingBox::CreateFromPoints(submesh.Bounds, vMin, vMax);
+
 	geo->DrawArgs["points"] = submesh;
 
-	mGeometries["treeSpritesGeo"] = std::move(geo);
+	mGeometries.Add("treeSpritesGeo", std::move(geo));
 }
 void TreeBillboardsApp::BuildDoorGeometry()
 {
+	if(LoadCookedGeometry("doorGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData door = geoGen.CreateDoor(2.0f, 3.3f, 2.0f, 3);
 
@@ -1258,11 +2123,11 @@ void TreeBillboardsApp::BuildDoorGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1276,10 +2141,16 @@ void TreeBillboardsApp::BuildDoorGeometry()
 
 	geo->DrawArgs["door"] = boxsubmesh;
 
-	mGeometries["doorGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("doorGeo", std::move(geo));
 }
 void TreeBillboardsApp::BuildConeGeometry()
 {
+	if(LoadCookedGeometry("coneGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData cone = geoGen.CreateCone(2.0f, 4.0f, 20, 10); // Bottom radius , Height , Slices , Stacks
 
@@ -1306,11 +2177,11 @@ void TreeBillboardsApp::BuildConeGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1324,10 +2195,16 @@ void TreeBillboardsApp::BuildConeGeometry()
 
 	geo->DrawArgs["cone"] = coneSubmesh;
 
-	mGeometries["coneGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("coneGeo", std::move(geo));
 }
 void TreeBillboardsApp::BuildCylinderGeometry()
 {
+	if(LoadCookedGeometry("cylinderGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData cylinder = geoGen.CreateCylinder(2.0f, 2.0f, 8.0f, 20, 10); // Bottom radius, Top radius , Height , Slices , Stacks 
 
@@ -1354,11 +2231,11 @@ void TreeBillboardsApp::BuildCylinderGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1372,10 +2249,16 @@ void TreeBillboardsApp::BuildCylinderGeometry()
 
 	geo->DrawArgs["cylinder"] = cylinderSubmesh;
 
-	mGeometries["cylinderGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("cylinderGeo", std::move(geo));
 }
 void TreeBillboardsApp::BuildPyramidGeometry()
 {
+	if(LoadCookedGeometry("pyramidGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData pyramid = geoGen.CreatePyramid(15.0f, 10.0f); // Base width , Height 
 
@@ -1402,11 +2285,11 @@ void TreeBillboardsApp::BuildPyramidGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1420,10 +2303,16 @@ void TreeBillboardsApp::BuildPyramidGeometry()
 
 	geo->DrawArgs["pyramid"] = pyramidSubmesh;
 
-	mGeometries["pyramidGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("pyramidGeo", std::move(geo));
 }
 void TreeBillboardsApp::BuildWedgeGeometry()
 {
+	if(LoadCookedGeometry("wedgeGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData wedge = geoGen.CreateWedge(0.5f, 5.0f, 5.0f); // Width , Height , Depth 
 
@@ -1450,11 +2339,11 @@ void TreeBillboardsApp::BuildWedgeGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1468,10 +2357,16 @@ void TreeBillboardsApp::BuildWedgeGeometry()
 
 	geo->DrawArgs["wedge"] = wedgeSubmesh;
 
-	mGeometries["wedgeGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("wedgeGeo", std::move(geo));
 }
 void TreeBillboardsApp::BuildTorusGeometry()
 {
+	if(LoadCookedGeometry("torusGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData torus = geoGen.CreateTorus(2.0f, 0.3f, 20, 20); // Radius , Tube radius , Slices0, Stacks
 
@@ -1498,11 +2393,11 @@ void TreeBillboardsApp::BuildTorusGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1516,10 +2411,16 @@ void TreeBillboardsApp::BuildTorusGeometry()
 
 	geo->DrawArgs["torus"] = torusSubmesh;
 
-	mGeometries["torusGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("torusGeo", std::move(geo));
 }
 void TreeBillboardsApp::BuildDiamondGeometry()
 {
+	if(LoadCookedGeometry("diamondGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData diamond = geoGen.CreateDiamond(4.0f, 2.0f, 0); // Height , Width , No subdivisions
 
@@ -1546,11 +2447,11 @@ void TreeBillboardsApp::BuildDiamondGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1564,10 +2465,16 @@ void TreeBillboardsApp::BuildDiamondGeometry()
 
 	geo->DrawArgs["diamond"] = diamondSubmesh;
 
-	mGeometries["diamondGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("diamondGeo", std::move(geo));
 }
 void TreeBillboardsApp::BuildTriangularPrismGeometry()
 {
+	if(LoadCookedGeometry("prismGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData prism = geoGen.CreateTriangularPrism(15.0f, 9.0f, 2.0f); // Base width , Height, Depth
 
@@ -1594,11 +2501,11 @@ void TreeBillboardsApp::BuildTriangularPrismGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1612,13 +2519,19 @@ void TreeBillboardsApp::BuildTriangularPrismGeometry()
 
 	geo->DrawArgs["prism"] = prismSubmesh;
 
-	mGeometries["prismGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("prismGeo", std::move(geo));
 }
 void TreeBillboardsApp::BuildWallGeometry()
 {
 
 
 
+	if(LoadCookedGeometry("wallGeo"))
+		return;
+
 	GeometryGenerator geoGen;
 	GeometryGenerator::MeshData wall = geoGen.CreateBox(30.0f, 8.0f, 1.0f, 3); // Width, Height, Depth, subdivisions
 
@@ -1646,11 +2559,11 @@ void TreeBillboardsApp::BuildWallGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
+	geo->VertexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		vertices.data(), vbByteSize, geo->VertexBufferUploader);
 
-	geo->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(md3dDevice.Get(),
-		mCommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->IndexBufferGPU = mRenderDevice->CreateDefaultBuffer(
+		indices.data(), ibByteSize, geo->IndexBufferUploader);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -1666,11 +2579,42 @@ void TreeBillboardsApp::BuildWallGeometry()
 
 	geo->DrawArgs["wall"] = submesh;
 
-	mGeometries["wallGeo"] = std::move(geo);
+	d3dUtil::ComputeSubmeshBounds(*geo);
+	CookGeometry(*geo);
+
+	mGeometries.Add("wallGeo", std::move(geo));
+
 
 
+}
+bool TreeBillboardsApp::LoadCookedGeometry(const std::string& name)
+{
+	// Cooked meshes are a cache: if the file is missing, from another format
+	// version, or older than the executable that generates the geometry, the caller
+	// falls back to generating it and re-cooks it.
+	std::wstring filename = L"Cooked\\" + AnsiToWString(name) + L".mesh";
+
+	static const ULONGLONG executableTime = ExecutableWriteTime();
+	if(LastWriteTime(filename.c_str()) < executableTime)
+		return false;
+
+	MappedMeshFile meshFile;
+	if(FAILED(meshFile.Open(filename)))
+		return false;
+
+	mGeometries.Add(name, meshFile.CreateGeometry(mRenderDevice.get(), name));
+	return true;
+}
+
+void TreeBillboardsApp::CookGeometry(MeshGeometry& geo)
+{
+	CreateDirectoryW(L"Cooked", nullptr);
 
+	std::wstring filename = L"Cooked\\" + AnsiToWString(geo.Name) + L".mesh";
+	if(FAILED(MeshFileWriter::Write(filename, geo)))
+		OutputDebugStringW((L"Failed to cook " + filename + L"\n").c_str());
 }
+
 void TreeBillboardsApp::BuildPSOs()
 {
     D3D12_GRAPHICS_PIPELINE_STATE_DESC opaquePsoDesc;
@@ -1706,7 +2650,7 @@ void TreeBillboardsApp::BuildPSOs()
 	opaquePsoDesc.SampleDesc.Count = m4xMsaaState ? 4 : 1;
 	opaquePsoDesc.SampleDesc.Quality = m4xMsaaState ? (m4xMsaaQuality - 1) : 0;
 	opaquePsoDesc.DSVFormat = mDepthStencilFormat;
-    ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&opaquePsoDesc, IID_PPV_ARGS(&mPSOs["opaque"])));
+    ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&opaquePsoDesc, IID_PPV_ARGS(&mPSOs[mPSOs.Add("opaque")])));
 
 	//
 	// PSO for transparent objects
@@ -1729,7 +2673,7 @@ void TreeBillboardsApp::BuildPSOs()
 	//transparentPsoDesc.BlendState.AlphaToCoverageEnable = true;
 
 	transparentPsoDesc.BlendState.RenderTarget[0] = transparencyBlendDesc;
-	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&transparentPsoDesc, IID_PPV_ARGS(&mPSOs["transparent"])));
+	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&transparentPsoDesc, IID_PPV_ARGS(&mPSOs[mPSOs.Add("transparent")])));
 
 	//
 	// PSO for alpha tested objects
@@ -1742,7 +2686,25 @@ void TreeBillboardsApp::BuildPSOs()
 		mShaders["alphaTestedPS"]->GetBufferSize()
 	};
 	alphaTestedPsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
-	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&alphaTestedPsoDesc, IID_PPV_ARGS(&mPSOs["alphaTested"])));
+	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&alphaTestedPsoDesc, IID_PPV_ARGS(&mPSOs[mPSOs.Add("alphaTested")])));
+
+	//
+	// Instanced variants: same state, but the world and texture transforms come
+	// from the instance buffer instead of the object constant buffer.
+	//
+	D3D12_SHADER_BYTECODE instancedVS =
+	{
+		reinterpret_cast<BYTE*>(mShaders["instancedVS"]->GetBufferPointer()),
+		mShaders["instancedVS"]->GetBufferSize()
+	};
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC opaqueInstancedPsoDesc = opaquePsoDesc;
+	opaqueInstancedPsoDesc.VS = instancedVS;
+	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&opaqueInstancedPsoDesc, IID_PPV_ARGS(&mPSOs[mPSOs.Add("opaqueInstanced")])));
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC alphaTestedInstancedPsoDesc = alphaTestedPsoDesc;
+	alphaTestedInstancedPsoDesc.VS = instancedVS;
+	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&alphaTestedInstancedPsoDesc, IID_PPV_ARGS(&mPSOs[mPSOs.Add("alphaTestedInstanced")])));
 
 	//
 	// PSO for tree sprites
@@ -1768,16 +2730,44 @@ void TreeBillboardsApp::BuildPSOs()
 	treeSpritePsoDesc.InputLayout = { mTreeSpriteInputLayout.data(), (UINT)mTreeSpriteInputLayout.size() };
 	treeSpritePsoDesc.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
 
-	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&treeSpritePsoDesc, IID_PPV_ARGS(&mPSOs["treeSprites"])));
+	ThrowIfFailed(md3dDevice->CreateGraphicsPipelineState(&treeSpritePsoDesc, IID_PPV_ARGS(&mPSOs[mPSOs.Add("treeSprites")])));
+}
+
+void TreeBillboardsApp::BuildLayerPasses()
+{
+	// Headless there are no PSOs; the passes, and so the draw order, are unchanged.
+	auto pso = [this](const char* name) -> ID3D12PipelineState*
+	{
+		UINT handle = mPSOs.Find(name);
+		return handle != NameRegistry::InvalidHandle ? mPSOs[handle].Get() : nullptr;
+	};
+
+	//
+	// Draw order of the layers: opaque first, then alpha tested and the tree
+	// sprites, and the blended water last over everything else.
+	//
+	mLayerPasses[0] = { RenderLayer::Opaque, pso("opaqueInstanced"), true, false, "Draw opaque" };
+	mLayerPasses[1] = { RenderLayer::AlphaTested, pso("alphaTestedInstanced"), true, false, "Draw alpha tested" };
+	mLayerPasses[2] = { RenderLayer::AlphaTestedTreeSprites, pso("treeSprites"), false, false, "Draw tree sprites" };
+	mLayerPasses[3] = { RenderLayer::Transparent, pso("transparent"), false, true, "Draw transparent" };
 }
 
 void TreeBillboardsApp::BuildFrameResources()
 {
-    for(int i = 0; i < gNumFrameResources; ++i)
+    mRecordWorkerCount = std::max<UINT>(1, std::min<UINT>(std::thread::hardware_concurrency(), 8));
+
+    // Pass constants come from the upload ring.  Object constants stay in each
+    // frame resource, indexed by scene store handle, and grow with the scene.
+    for(UINT i = 0; i < mFramesInFlight; ++i)
     {
-        mFrameResources.push_back(std::make_unique<FrameResource>(md3dDevice.Get(),
-            1, (UINT)mAllRitems.size(), (UINT)mMaterials.size(), mWaves->VertexCount()));
+        mFrameResources.push_back(std::make_unique<FrameResource>(mRenderDevice.get(),
+            0, mScene.HandleCapacity(), mMaterials.Count(), mWaves->VertexCount(), mRecordWorkerCount));
     }
+
+    // The ring is tied to the fence rather than to the frame resources, so it
+    // survives a change of frames in flight.
+    if(mUploadRing == nullptr)
+        mUploadRing = std::make_unique<UploadRing>(mRenderDevice.get(), gUploadRingByteSize);
 }
 
 void TreeBillboardsApp::BuildMaterials()
@@ -1874,1289 +2864,292 @@ void TreeBillboardsApp::BuildMaterials()
 	mazeWall->FresnelR0 = XMFLOAT3(0.1f, 0.1f, 0.1f);
 	mazeWall->Roughness = 0.3f;
 
-	mMaterials["grass"] = std::move(grass);
-	mMaterials["water"] = std::move(water);
-	mMaterials["wirefence"] = std::move(wirefence);
-	mMaterials["bricks"] = std::move(bricks);
-	mMaterials["treeSprites"] = std::move(treeSprites);
-	mMaterials["bricks3"] = std::move(bricks3);
-	mMaterials["woodCrate"] = std::move(woodCrate);
-	mMaterials["tile"] = std::move(tile);
-	mMaterials["checkboard"] = std::move(checkboard);
-	mMaterials["bricks2"] = std::move(bricks2);
-	mMaterials["mazeWall"] = std::move(mazeWall);
+	mMaterials.Add("grass", std::move(grass));
+	mMaterials.Add("water", std::move(water));
+	mMaterials.Add("wirefence", std::move(wirefence));
+	mMaterials.Add("bricks", std::move(bricks));
+	mMaterials.Add("treeSprites", std::move(treeSprites));
+	mMaterials.Add("bricks3", std::move(bricks3));
+	mMaterials.Add("woodCrate", std::move(woodCrate));
+	mMaterials.Add("tile", std::move(tile));
+	mMaterials.Add("checkboard", std::move(checkboard));
+	mMaterials.Add("bricks2", std::move(bricks2));
+	mMaterials.Add("mazeWall", std::move(mazeWall));
+
+	mWaterMat = mMaterials.Find("water");
+
+	// Dirty materials are queued by MatCBIndex.
+	mMaterialsByCBIndex.assign(mMaterials.Count(), nullptr);
+	for(UINT i = 0; i < mMaterials.Count(); ++i)
+		mMaterialsByCBIndex[mMaterials[i]->MatCBIndex] = mMaterials[i].get();
 }
 
 void TreeBillboardsApp::BuildRenderItems()
 {
-	// WATER
-    auto wavesRitem = std::make_unique<RenderItem>();
-    wavesRitem->World = MathHelper::Identity4x4();
-	XMMATRIX wavesWorld = XMMatrixTranslation(69.0f, 0.1f, 0.0f);
-	XMStoreFloat4x4(&wavesRitem->World, wavesWorld);
-	XMStoreFloat4x4(&wavesRitem->TexTransform, XMMatrixScaling(5.0f, 5.0f, 1.0f));
-	wavesRitem->ObjCBIndex = 0;
-	wavesRitem->Mat = mMaterials["water"].get();
-	wavesRitem->Geo = mGeometries["waterGeo"].get();
-	wavesRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	wavesRitem->IndexCount = wavesRitem->Geo->DrawArgs["grid"].IndexCount;
-	wavesRitem->StartIndexLocation = wavesRitem->Geo->DrawArgs["grid"].StartIndexLocation;
-	wavesRitem->BaseVertexLocation = wavesRitem->Geo->DrawArgs["grid"].BaseVertexLocation;
-
-    mWavesRitem = wavesRitem.get();
-
-	mRitemLayer[(int)RenderLayer::Transparent].push_back(wavesRitem.get());
-
-	// LAND
-    auto gridRitem = std::make_unique<RenderItem>();
-    gridRitem->World = MathHelper::Identity4x4();
-	XMStoreFloat4x4(&gridRitem->World, XMMatrixTranslation(0.0f, 0.0f, 0.0f));
-	XMStoreFloat4x4(&gridRitem->TexTransform, XMMatrixScaling(5.0f, 5.0f, 1.0f));
-	gridRitem->ObjCBIndex = 1;
-	gridRitem->Mat = mMaterials["grass"].get();
-	gridRitem->Geo = mGeometries["landGeo"].get();
-	gridRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-    gridRitem->IndexCount = gridRitem->Geo->DrawArgs["grid"].IndexCount;
-    gridRitem->StartIndexLocation = gridRitem->Geo->DrawArgs["grid"].StartIndexLocation;
-    gridRitem->BaseVertexLocation = gridRitem->Geo->DrawArgs["grid"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(gridRitem.get());
-
-	// WALL
-	auto boxRitem = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&boxRitem->World, XMMatrixTranslation(0.0f, 4.0f, 0.0f));
-	boxRitem->ObjCBIndex = 2;
-	boxRitem->Mat = mMaterials["bricks2"].get();
-	boxRitem->Geo = mGeometries["boxGeo"].get();
-	boxRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	boxRitem->IndexCount = boxRitem->Geo->DrawArgs["box"].IndexCount;
-	boxRitem->StartIndexLocation = boxRitem->Geo->DrawArgs["box"].StartIndexLocation;
-	boxRitem->BaseVertexLocation = boxRitem->Geo->DrawArgs["box"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::AlphaTested].push_back(boxRitem.get());
-
-
-	// TREES
-	auto treeSpritesRitem = std::make_unique<RenderItem>();
-	treeSpritesRitem->World = MathHelper::Identity4x4();
-	treeSpritesRitem->ObjCBIndex = 3;
-	treeSpritesRitem->Mat = mMaterials["treeSprites"].get();
-	treeSpritesRitem->Geo = mGeometries["treeSpritesGeo"].get();
-	//step2
-	treeSpritesRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_POINTLIST;
-	treeSpritesRitem->IndexCount = treeSpritesRitem->Geo->DrawArgs["points"].IndexCount;
-	treeSpritesRitem->StartIndexLocation = treeSpritesRitem->Geo->DrawArgs["points"].StartIndexLocation;
-	treeSpritesRitem->BaseVertexLocation = treeSpritesRitem->Geo->DrawArgs["points"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::AlphaTestedTreeSprites].push_back(treeSpritesRitem.get());
+	// The maze and everything else in the level lives in the scene file; the cooked
+	// copy is rebuilt automatically whenever the text file is newer.
+	CreateDirectoryW(L"Cooked", nullptr);
 
-	
-	//DOOR
-	auto boxRitem2 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&boxRitem2->World, XMMatrixTranslation(0.0f, 1.6f, -6.8f));
-	boxRitem2->ObjCBIndex = 4;
-	boxRitem2->Mat = mMaterials["woodCrate"].get();
-	boxRitem2->Geo = mGeometries["doorGeo"].get();
-	boxRitem2->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	boxRitem2->IndexCount = boxRitem2->Geo->DrawArgs["door"].IndexCount;
-	boxRitem2->StartIndexLocation = boxRitem2->Geo->DrawArgs["door"].StartIndexLocation;
-	boxRitem2->BaseVertexLocation = boxRitem2->Geo->DrawArgs["door"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::AlphaTested].push_back(boxRitem2.get());
+	Scene scene;
+	ThrowIfFailed(scene.Load(L"Scenes\\maze.scene", L"Cooked\\maze.scenebin"));
 
-	
-	// CONES
-	auto coneRitem = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&coneRitem->World, XMMatrixTranslation(7.0f, 10.0f, 7.0f)); // Position the cone at (3, 1, 0)
-	coneRitem->ObjCBIndex = 5; 
-	coneRitem->Mat = mMaterials["checkboard"].get(); // "checkboard" material 
-	coneRitem->Geo = mGeometries["coneGeo"].get();
-	coneRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	coneRitem->IndexCount = coneRitem->Geo->DrawArgs["cone"].IndexCount;
-	coneRitem->StartIndexLocation = coneRitem->Geo->DrawArgs["cone"].StartIndexLocation;
-	coneRitem->BaseVertexLocation = coneRitem->Geo->DrawArgs["cone"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(coneRitem.get());
-
-	auto coneRitem2 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&coneRitem2->World, XMMatrixTranslation(-7.0f, 10.0f, 7.0f)); // Position the cone at (3, 1, 0)
-	coneRitem2->ObjCBIndex = 6; 
-	coneRitem2->Mat = mMaterials["checkboard"].get(); //  "checkboard" material 
-	coneRitem2->Geo = mGeometries["coneGeo"].get();
-	coneRitem2->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	coneRitem2->IndexCount = coneRitem2->Geo->DrawArgs["cone"].IndexCount;
-	coneRitem2->StartIndexLocation = coneRitem2->Geo->DrawArgs["cone"].StartIndexLocation;
-	coneRitem2->BaseVertexLocation = coneRitem2->Geo->DrawArgs["cone"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(coneRitem2.get());
-
-	auto coneRitem3 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&coneRitem3->World, XMMatrixTranslation(7.0f, 10.0f, -7.0f)); // Position the cone at (3, 1, 0)
-	coneRitem3->ObjCBIndex = 7; 
-	coneRitem3->Mat = mMaterials["checkboard"].get(); 
-	coneRitem3->Geo = mGeometries["coneGeo"].get();
-	coneRitem3->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	coneRitem3->IndexCount = coneRitem3->Geo->DrawArgs["cone"].IndexCount;
-	coneRitem3->StartIndexLocation = coneRitem3->Geo->DrawArgs["cone"].StartIndexLocation;
-	coneRitem3->BaseVertexLocation = coneRitem3->Geo->DrawArgs["cone"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(coneRitem3.get());
-
-	auto coneRitem4 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&coneRitem4->World, XMMatrixTranslation(-7.0f, 10.0f, -7.0f)); 
-	coneRitem4->ObjCBIndex = 8; 
-	coneRitem4->Mat = mMaterials["checkboard"].get(); 
-	coneRitem4->Geo = mGeometries["coneGeo"].get();
-	coneRitem4->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	coneRitem4->IndexCount = coneRitem4->Geo->DrawArgs["cone"].IndexCount;
-	coneRitem4->StartIndexLocation = coneRitem4->Geo->DrawArgs["cone"].StartIndexLocation;
-	coneRitem4->BaseVertexLocation = coneRitem4->Geo->DrawArgs["cone"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(coneRitem4.get());
-
-
-
-	// CYLINDER
-	auto cylinderRitem = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&cylinderRitem->World, XMMatrixTranslation(7.0f, 4.0f, 7.0f));
-	cylinderRitem->ObjCBIndex = 9; 
-	cylinderRitem->Mat = mMaterials["bricks"].get(); 
-	cylinderRitem->Geo = mGeometries["cylinderGeo"].get();
-	cylinderRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	cylinderRitem->IndexCount = cylinderRitem->Geo->DrawArgs["cylinder"].IndexCount;
-	cylinderRitem->StartIndexLocation = cylinderRitem->Geo->DrawArgs["cylinder"].StartIndexLocation;
-	cylinderRitem->BaseVertexLocation = cylinderRitem->Geo->DrawArgs["cylinder"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(cylinderRitem.get());
-
-	auto cylinderRitem2 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&cylinderRitem2->World, XMMatrixTranslation(-7.0f, 4.0f, 7.0f)); 
-	cylinderRitem2->ObjCBIndex = 10;
-	cylinderRitem2->Mat = mMaterials["bricks"].get(); 
-	cylinderRitem2->Geo = mGeometries["cylinderGeo"].get();
-	cylinderRitem2->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	cylinderRitem2->IndexCount = cylinderRitem2->Geo->DrawArgs["cylinder"].IndexCount;
-	cylinderRitem2->StartIndexLocation = cylinderRitem2->Geo->DrawArgs["cylinder"].StartIndexLocation;
-	cylinderRitem2->BaseVertexLocation = cylinderRitem2->Geo->DrawArgs["cylinder"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(cylinderRitem2.get());
-
-	auto cylinderRitem3 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&cylinderRitem3->World, XMMatrixTranslation(-7.0f, 4.0f, -7.0f));
-	cylinderRitem3->ObjCBIndex = 11; 
-	cylinderRitem3->Mat = mMaterials["bricks"].get();
-	cylinderRitem3->Geo = mGeometries["cylinderGeo"].get();
-	cylinderRitem3->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	cylinderRitem3->IndexCount = cylinderRitem3->Geo->DrawArgs["cylinder"].IndexCount;
-	cylinderRitem3->StartIndexLocation = cylinderRitem3->Geo->DrawArgs["cylinder"].StartIndexLocation;
-	cylinderRitem3->BaseVertexLocation = cylinderRitem3->Geo->DrawArgs["cylinder"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(cylinderRitem3.get());
-
-	auto cylinderRitem4 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&cylinderRitem4->World, XMMatrixTranslation(7.0f, 4.0f, -7.0f)); 
-	cylinderRitem4->ObjCBIndex = 12; 
-	cylinderRitem4->Mat = mMaterials["bricks"].get(); 
-	cylinderRitem4->Geo = mGeometries["cylinderGeo"].get();
-	cylinderRitem4->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	cylinderRitem4->IndexCount = cylinderRitem4->Geo->DrawArgs["cylinder"].IndexCount;
-	cylinderRitem4->StartIndexLocation = cylinderRitem4->Geo->DrawArgs["cylinder"].StartIndexLocation;
-	cylinderRitem4->BaseVertexLocation = cylinderRitem4->Geo->DrawArgs["cylinder"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(cylinderRitem4.get());
-	
+	static const std::pair<const char*, RenderLayer> layerNames[] =
+	{
+		{ "opaque", RenderLayer::Opaque },
+		{ "transparent", RenderLayer::Transparent },
+		{ "alpha_tested", RenderLayer::AlphaTested },
+		{ "tree_sprites", RenderLayer::AlphaTestedTreeSprites },
+	};
 
-	// PYRAMID
-	auto pyramidRitem = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&pyramidRitem->World, XMMatrixTranslation(0.0f, 13.0f, 0.0f)); 
-	pyramidRitem->ObjCBIndex = 13; 
-	pyramidRitem->Mat = mMaterials["tile"].get(); 
-	pyramidRitem->Geo = mGeometries["pyramidGeo"].get();
-	pyramidRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	pyramidRitem->IndexCount = pyramidRitem->Geo->DrawArgs["pyramid"].IndexCount;
-	pyramidRitem->StartIndexLocation = pyramidRitem->Geo->DrawArgs["pyramid"].StartIndexLocation;
-	pyramidRitem->BaseVertexLocation = pyramidRitem->Geo->DrawArgs["pyramid"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(pyramidRitem.get());
-
-	// WEDGE
-	auto wedgeRitem = std::make_unique<RenderItem>();
-	XMMATRIX rotation = XMMatrixRotationY(XMConvertToRadians(180.0f)); // Rotate 180 degrees around Y-axis
-	XMMATRIX translation = XMMatrixTranslation(-2.0f, 2.4f, -10.0f);
-	XMMATRIX world = rotation * translation;
-	XMStoreFloat4x4(&wedgeRitem->World, world);
-	wedgeRitem->ObjCBIndex = 14;
-	wedgeRitem->Mat = mMaterials["bricks3"].get();
-	wedgeRitem->Geo = mGeometries["wedgeGeo"].get();
-	wedgeRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	wedgeRitem->IndexCount = wedgeRitem->Geo->DrawArgs["wedge"].IndexCount;
-	wedgeRitem->StartIndexLocation = wedgeRitem->Geo->DrawArgs["wedge"].StartIndexLocation;
-	wedgeRitem->BaseVertexLocation = wedgeRitem->Geo->DrawArgs["wedge"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wedgeRitem.get());
-
-	auto wedgeRitem2 = std::make_unique<RenderItem>();
-	XMMATRIX rotation2 = XMMatrixRotationY(XMConvertToRadians(180.0f)); // Rotate 180 degrees around Y-axis
-	XMMATRIX translation2 = XMMatrixTranslation(2.0f, 2.4f, -10.0f);
-	XMMATRIX world2 = rotation2 * translation2;
-	XMStoreFloat4x4(&wedgeRitem2->World, world2);
-	wedgeRitem2->ObjCBIndex = 15;
-	wedgeRitem2->Mat = mMaterials["bricks3"].get();
-	wedgeRitem2->Geo = mGeometries["wedgeGeo"].get();
-	wedgeRitem2->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	wedgeRitem2->IndexCount = wedgeRitem2->Geo->DrawArgs["wedge"].IndexCount;
-	wedgeRitem2->StartIndexLocation = wedgeRitem2->Geo->DrawArgs["wedge"].StartIndexLocation;
-	wedgeRitem2->BaseVertexLocation = wedgeRitem2->Geo->DrawArgs["wedge"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wedgeRitem2.get());
-
-
-
-	// TORUS
-	auto torusRitem = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&torusRitem->World, XMMatrixTranslation(0.0f, 19.9f, 0.0f)); // Position 
-	torusRitem->ObjCBIndex = 16; 
-	torusRitem->Mat = mMaterials["bricks"].get(); 
-	torusRitem->Geo = mGeometries["torusGeo"].get();
-	torusRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	torusRitem->IndexCount = torusRitem->Geo->DrawArgs["torus"].IndexCount;
-	torusRitem->StartIndexLocation = torusRitem->Geo->DrawArgs["torus"].StartIndexLocation;
-	torusRitem->BaseVertexLocation = torusRitem->Geo->DrawArgs["torus"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(torusRitem.get());
-
-	//DIAMOND
-	auto diamondRitem = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&diamondRitem->World, XMMatrixTranslation(0.0f, 20.0f, 0.0f)); // Position 
-	diamondRitem->ObjCBIndex = 17; 
-	diamondRitem->Mat = mMaterials["wirefence"].get(); // material
-	diamondRitem->Geo = mGeometries["diamondGeo"].get();
-	diamondRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	diamondRitem->IndexCount = diamondRitem->Geo->DrawArgs["diamond"].IndexCount;
-	diamondRitem->StartIndexLocation = diamondRitem->Geo->DrawArgs["diamond"].StartIndexLocation;
-	diamondRitem->BaseVertexLocation = diamondRitem->Geo->DrawArgs["diamond"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(diamondRitem.get());
-
-
-	// PRISM
-	auto prismRitem = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&prismRitem->World, XMMatrixTranslation(0.0f, 4.0f, 8.0f)); // Position 
-	prismRitem->ObjCBIndex = 18;
-	prismRitem->Mat = mMaterials["bricks2"].get();
-	prismRitem->Geo = mGeometries["prismGeo"].get();
-	prismRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	prismRitem->IndexCount = prismRitem->Geo->DrawArgs["prism"].IndexCount;
-	prismRitem->StartIndexLocation = prismRitem->Geo->DrawArgs["prism"].StartIndexLocation;
-	prismRitem->BaseVertexLocation = prismRitem->Geo->DrawArgs["prism"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(prismRitem.get());
-
-	//Maze
-	// FRONT Wall ONE
-	auto wallRitem1 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&wallRitem1->World, XMMatrixTranslation(0.0f, 4.0f, -17.0f)); // Position the wall
-	wallRitem1->ObjCBIndex = 19; // Next available index
-	wallRitem1->Mat = mMaterials["mazeWall"].get();
-	wallRitem1->Geo = mGeometries["wallGeo"].get();
-	wallRitem1->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	wallRitem1->IndexCount = wallRitem1->Geo->DrawArgs["wall"].IndexCount;
-	wallRitem1->StartIndexLocation = wallRitem1->Geo->DrawArgs["wall"].StartIndexLocation;
-	wallRitem1->BaseVertexLocation = wallRitem1->Geo->DrawArgs["wall"].BaseVertexLocation;
-	BoundingBox WallCollider;
-	WallCollider.Center = XMFLOAT3(0.0f, 4.0f, -17.0f); // Same position as the wall
-	WallCollider.Extents = XMFLOAT3(15.0f, 4.0f, 0.5f); // Half of width (30/2), height (8/2), and depth (1/2)
-
-	// Add the collider to the list
-	mColliders.push_back(WallCollider);
+	// Resolve every name in the scene's string table once, however many instances use it.
+	const UINT stringCount = scene.StringCount();
+	std::vector<UINT> geos(stringCount, NameRegistry::InvalidHandle);
+	std::vector<UINT> mats(stringCount, NameRegistry::InvalidHandle);
+	std::vector<int> layers(stringCount, -1);
+	for(UINT i = 0; i < stringCount; ++i)
+	{
+		const std::string& name = scene.String(i);
 
-		
-	// LEFT Wall ONE
-	auto wallRitem2 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&wallRitem2->World, XMMatrixScaling(0.3f, 1.0f, 1.0f)*
-	XMMatrixRotationY(XMConvertToRadians(90.0f))*  // Rotate 90 degrees to make it a side wall
-	XMMatrixTranslation(15.0f, 4.0f, -12.5f));       // Position
-	wallRitem2->ObjCBIndex = 20;
-	wallRitem2->Mat = mMaterials["mazeWall"].get();
-	wallRitem2->Geo = mGeometries["wallGeo"].get();
-	wallRitem2->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	wallRitem2->IndexCount = wallRitem2->Geo->DrawArgs["wall"].IndexCount;
-	wallRitem2->StartIndexLocation = wallRitem2->Geo->DrawArgs["wall"].StartIndexLocation;
-	wallRitem2->BaseVertexLocation = wallRitem2->Geo->DrawArgs["wall"].BaseVertexLocation;
-	BoundingBox leftWallOneCollider; // Renamed for clarity
-	leftWallOneCollider.Center = XMFLOAT3(15.0f, 4.0f, -12.5f);
-	leftWallOneCollider.Extents = XMFLOAT3(0.5f, 4.0f, 4.5f); // Half the width, height, and depth
-
-	// Add the collider to the list
-	mColliders.push_back(leftWallOneCollider);
-
-
-
-	// RIGHT WALL
-	auto wallRitem3 = std::make_unique<RenderItem>();
-	XMStoreFloat4x4(&wallRitem3->World,
-	XMMatrixRotationY(XMConvertToRadians(-90.0f))* // Rotate -90 degrees
-	XMMatrixTranslation(-15.0f, 4.0f, -2.0f));      // Position
-	wallRitem3->ObjCBIndex = 21;
-	wallRitem3->Mat = mMaterials["mazeWall"].get();
-	wallRitem3->Geo = mGeometries["wallGeo"].get();
-	wallRitem3->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	wallRitem3->IndexCount = wallRitem3->Geo->DrawArgs["wall"].IndexCount;
-	wallRitem3->StartIndexLocation = wallRitem3->Geo->DrawArgs["wall"].StartIndexLocation;
-	wallRitem3->BaseVertexLocation = wallRitem3->Geo->DrawArgs["wall"].BaseVertexLocation;
-	BoundingBox collider3;
-	collider3.Center = XMFLOAT3(-15.0f, 4.0f, -2.0f);
-	collider3.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f); // Rotated -90Y: Extents swap X/Z
-	mColliders.push_back(collider3);
-
-	// wallRitem4: BACK WALL
-	auto wallRitem4 = std::make_unique<RenderItem>();
-	XMFLOAT3 center4 = XMFLOAT3(-5.0f, 4.0f, 19.0f);
-	float scaleX4 = 1.35f;
-	XMStoreFloat4x4(&wallRitem4->World, XMMatrixScaling(scaleX4, 1.0f, 1.0f)* XMMatrixTranslation(center4.x, center4.y, center4.z));
-	wallRitem4->ObjCBIndex = 22;
-	wallRitem4->Mat = mMaterials["mazeWall"].get(); wallRitem4->Geo = mGeometries["wallGeo"].get(); wallRitem4->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem4->IndexCount = wallRitem4->Geo->DrawArgs["wall"].IndexCount; wallRitem4->StartIndexLocation = wallRitem4->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem4->BaseVertexLocation = wallRitem4->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem4.get());
-	BoundingBox collider4;
-	collider4.Center = center4;
-	collider4.Extents = XMFLOAT3(15.0f * scaleX4, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider4);
-
-
-	// wallRitem5: LEFT WALL
-	auto wallRitem5 = std::make_unique<RenderItem>();
-	XMFLOAT3 center5 = XMFLOAT3(15.0f, 4.0f, 9.8f);
-	float scaleX5 = 0.66f;
-	XMStoreFloat4x4(&wallRitem5->World, XMMatrixScaling(scaleX5, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center5.x, center5.y, center5.z));
-	wallRitem5->ObjCBIndex = 23;
-	wallRitem5->Mat = mMaterials["mazeWall"].get(); wallRitem5->Geo = mGeometries["wallGeo"].get(); wallRitem5->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem5->IndexCount = wallRitem5->Geo->DrawArgs["wall"].IndexCount; wallRitem5->StartIndexLocation = wallRitem5->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem5->BaseVertexLocation = wallRitem5->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem5.get());
-	BoundingBox collider5;
-	collider5.Center = center5;
-	collider5.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX5); // Rotated 90Y
-	mColliders.push_back(collider5);
-
-
-	// wallRitem6: RIGHT WALL
-	auto wallRitem6 = std::make_unique<RenderItem>();
-	XMFLOAT3 center6 = XMFLOAT3(-25.0f, 4.0f, -2.0f);
-	float scaleX6 = 1.4f;
-	XMStoreFloat4x4(&wallRitem6->World, XMMatrixScaling(scaleX6, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center6.x, center6.y, center6.z));
-	wallRitem6->ObjCBIndex = 24;
-	wallRitem6->Mat = mMaterials["mazeWall"].get(); wallRitem6->Geo = mGeometries["wallGeo"].get(); wallRitem6->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem6->IndexCount = wallRitem6->Geo->DrawArgs["wall"].IndexCount; wallRitem6->StartIndexLocation = wallRitem6->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem6->BaseVertexLocation = wallRitem6->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem6.get());
-	BoundingBox collider6;
-	collider6.Center = center6;
-	collider6.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX6); // Rotated -90Y
-	mColliders.push_back(collider6);
-
-
-
-	// wallRitem7: BACK WALL
-	auto wallRitem7 = std::make_unique<RenderItem>();
-	XMFLOAT3 center7 = XMFLOAT3(-12.0f, 4.0f, -23.0f);
-	float scaleX7 = 0.9f;
-	XMStoreFloat4x4(&wallRitem7->World, XMMatrixScaling(scaleX7, 1.0f, 1.0f)* XMMatrixTranslation(center7.x, center7.y, center7.z));
-	wallRitem7->ObjCBIndex = 25;
-	wallRitem7->Mat = mMaterials["mazeWall"].get(); wallRitem7->Geo = mGeometries["wallGeo"].get(); wallRitem7->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem7->IndexCount = wallRitem7->Geo->DrawArgs["wall"].IndexCount; wallRitem7->StartIndexLocation = wallRitem7->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem7->BaseVertexLocation = wallRitem7->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem7.get());
-	BoundingBox collider7;
-	collider7.Center = center7;
-	collider7.Extents = XMFLOAT3(15.0f * scaleX7, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider7);
-
-	// wallRitem8: FRONT WALL
-	auto wallRitem8 = std::make_unique<RenderItem>();
-	XMFLOAT3 center8 = XMFLOAT3(14.0f, 4.0f, -23.0f);
-	float scaleX8 = 0.45f;
-	XMStoreFloat4x4(&wallRitem8->World, XMMatrixScaling(scaleX8, 1.0f, 1.0f)* XMMatrixTranslation(center8.x, center8.y, center8.z));
-	wallRitem8->ObjCBIndex = 26;
-	wallRitem8->Mat = mMaterials["mazeWall"].get(); wallRitem8->Geo = mGeometries["wallGeo"].get(); wallRitem8->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem8->IndexCount = wallRitem8->Geo->DrawArgs["wall"].IndexCount; wallRitem8->StartIndexLocation = wallRitem8->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem8->BaseVertexLocation = wallRitem8->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem8.get());
-	BoundingBox collider8;
-	collider8.Center = center8;
-	collider8.Extents = XMFLOAT3(15.0f * scaleX8, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider8);
-
-
-	// wallRitem9: LEFT Wall
-	auto wallRitem9 = std::make_unique<RenderItem>();
-	XMFLOAT3 center9 = XMFLOAT3(21.0f, 4.0f, -15.5f);
-	float scaleX9 = 0.5f;
-	XMStoreFloat4x4(&wallRitem9->World, XMMatrixScaling(scaleX9, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center9.x, center9.y, center9.z));
-	wallRitem9->ObjCBIndex = 27;
-	wallRitem9->Mat = mMaterials["mazeWall"].get(); wallRitem9->Geo = mGeometries["wallGeo"].get(); wallRitem9->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem9->IndexCount = wallRitem9->Geo->DrawArgs["wall"].IndexCount; wallRitem9->StartIndexLocation = wallRitem9->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem9->BaseVertexLocation = wallRitem9->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem9.get());
-	BoundingBox collider9;
-	collider9.Center = center9;
-	collider9.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX9); // Rotated 90Y
-	mColliders.push_back(collider9);
-
-	// wallRitem10: FRONT WALL
-	auto wallRitem10 = std::make_unique<RenderItem>();
-	XMFLOAT3 center10 = XMFLOAT3(18.0f, 4.0f, -8.5f);
-	float scaleX10 = 0.2f;
-	XMStoreFloat4x4(&wallRitem10->World, XMMatrixScaling(scaleX10, 1.0f, 1.0f)* XMMatrixTranslation(center10.x, center10.y, center10.z));
-	wallRitem10->ObjCBIndex = 28;
-	wallRitem10->Mat = mMaterials["mazeWall"].get(); wallRitem10->Geo = mGeometries["wallGeo"].get(); wallRitem10->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem10->IndexCount = wallRitem10->Geo->DrawArgs["wall"].IndexCount; wallRitem10->StartIndexLocation = wallRitem10->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem10->BaseVertexLocation = wallRitem10->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem10.get());
-	BoundingBox collider10;
-	collider10.Center = center10;
-	collider10.Extents = XMFLOAT3(15.0f * scaleX10, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider10);
-
-	// wallRitem11: FRONT WALL
-	auto wallRitem11 = std::make_unique<RenderItem>();
-	XMFLOAT3 center11 = XMFLOAT3(20.5f, 4.0f, -0.5f);
-	float scaleX11 = 0.4f;
-	XMStoreFloat4x4(&wallRitem11->World, XMMatrixScaling(scaleX11, 1.0f, 1.0f)* XMMatrixTranslation(center11.x, center11.y, center11.z));
-	wallRitem11->ObjCBIndex = 29;
-	wallRitem11->Mat = mMaterials["mazeWall"].get(); wallRitem11->Geo = mGeometries["wallGeo"].get(); wallRitem11->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem11->IndexCount = wallRitem11->Geo->DrawArgs["wall"].IndexCount; wallRitem11->StartIndexLocation = wallRitem11->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem11->BaseVertexLocation = wallRitem11->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem11.get());
-	BoundingBox collider11;
-	collider11.Center = center11;
-	collider11.Extents = XMFLOAT3(15.0f * scaleX11, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider11);
-
-
-	// wallRitem12: LEFT Wall
-	auto wallRitem12 = std::make_unique<RenderItem>();
-	XMFLOAT3 center12 = XMFLOAT3(21.0f, 4.0f, 12.0f);
-	float scaleX12 = 0.5f;
-	XMStoreFloat4x4(&wallRitem12->World, XMMatrixScaling(scaleX12, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center12.x, center12.y, center12.z));
-	wallRitem12->ObjCBIndex = 30;
-	wallRitem12->Mat = mMaterials["mazeWall"].get(); wallRitem12->Geo = mGeometries["wallGeo"].get(); wallRitem12->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem12->IndexCount = wallRitem12->Geo->DrawArgs["wall"].IndexCount; wallRitem12->StartIndexLocation = wallRitem12->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem12->BaseVertexLocation = wallRitem12->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem12.get());
-	BoundingBox collider12;
-	collider12.Center = center12;
-	collider12.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX12); // Rotated 90Y
-	mColliders.push_back(collider12);
-
-	// wallRitem13: LEFT Wall
-	auto wallRitem13 = std::make_unique<RenderItem>();
-	XMFLOAT3 center13 = XMFLOAT3(27.0f, 4.0f, 9.5f);
-	float scaleX13 = 1.2f;
-	XMStoreFloat4x4(&wallRitem13->World, XMMatrixScaling(scaleX13, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center13.x, center13.y, center13.z));
-	wallRitem13->ObjCBIndex = 31;
-	wallRitem13->Mat = mMaterials["mazeWall"].get(); wallRitem13->Geo = mGeometries["wallGeo"].get(); wallRitem13->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem13->IndexCount = wallRitem13->Geo->DrawArgs["wall"].IndexCount; wallRitem13->StartIndexLocation = wallRitem13->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem13->BaseVertexLocation = wallRitem13->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem13.get());
-	BoundingBox collider13;
-	collider13.Center = center13;
-	collider13.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX13); // Rotated 90Y
-	mColliders.push_back(collider13);
-
-
-	// wallRitem14: FRONT WALL
-	auto wallRitem14 = std::make_unique<RenderItem>();
-	XMFLOAT3 center14 = XMFLOAT3(39.0f, 4.0f, -15.0f);
-	float scaleX14 = 1.2f;
-	XMStoreFloat4x4(&wallRitem14->World, XMMatrixScaling(scaleX14, 1.0f, 1.0f)* XMMatrixTranslation(center14.x, center14.y, center14.z));
-	wallRitem14->ObjCBIndex = 32;
-	// ... setup ...
-	wallRitem14->Mat = mMaterials["mazeWall"].get(); wallRitem14->Geo = mGeometries["wallGeo"].get(); wallRitem14->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem14->IndexCount = wallRitem14->Geo->DrawArgs["wall"].IndexCount; wallRitem14->StartIndexLocation = wallRitem14->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem14->BaseVertexLocation = wallRitem14->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem14.get());
-	BoundingBox collider14;
-	collider14.Center = center14;
-	collider14.Extents = XMFLOAT3(15.0f * scaleX14, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider14);
-
-
-	// wallRitem15: LEFT Wall
-	auto wallRitem15 = std::make_unique<RenderItem>();
-	XMFLOAT3 center15 = XMFLOAT3(1.0f, 4.0f, -25.6f);
-	float scaleX15 = 0.2f;
-	XMStoreFloat4x4(&wallRitem15->World, XMMatrixScaling(scaleX15, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center15.x, center15.y, center15.z));
-	wallRitem15->ObjCBIndex = 33;
-	wallRitem15->Mat = mMaterials["mazeWall"].get(); wallRitem15->Geo = mGeometries["wallGeo"].get(); wallRitem15->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem15->IndexCount = wallRitem15->Geo->DrawArgs["wall"].IndexCount; wallRitem15->StartIndexLocation = wallRitem15->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem15->BaseVertexLocation = wallRitem15->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem15.get());
-	BoundingBox collider15;
-	collider15.Center = center15;
-	collider15.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX15); // Rotated 90Y
-	mColliders.push_back(collider15);
-
-	// wallRitem16: FRONT WALL
-	auto wallRitem16 = std::make_unique<RenderItem>();
-	XMFLOAT3 center16 = XMFLOAT3(-3.0f, 4.0f, -28.6f);
-	float scaleX16 = 2.0f;
-	XMStoreFloat4x4(&wallRitem16->World, XMMatrixScaling(scaleX16, 1.0f, 1.0f)* XMMatrixTranslation(center16.x, center16.y, center16.z));
-	wallRitem16->ObjCBIndex = 34;
-	wallRitem16->Mat = mMaterials["mazeWall"].get(); wallRitem16->Geo = mGeometries["wallGeo"].get(); wallRitem16->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem16->IndexCount = wallRitem16->Geo->DrawArgs["wall"].IndexCount; wallRitem16->StartIndexLocation = wallRitem16->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem16->BaseVertexLocation = wallRitem16->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem16.get());
-	BoundingBox collider16;
-	collider16.Center = center16;
-	collider16.Extents = XMFLOAT3(15.0f * scaleX16, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider16);
-
-
-	// wallRitem17: LEFT Wall
-	auto wallRitem17 = std::make_unique<RenderItem>();
-	XMFLOAT3 center17 = XMFLOAT3(27.0f, 4.0f, -28.0f);
-	float scaleX17 = 0.45f;
-	XMStoreFloat4x4(&wallRitem17->World, XMMatrixScaling(scaleX17, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center17.x, center17.y, center17.z));
-	wallRitem17->ObjCBIndex = 35;
-	wallRitem17->Mat = mMaterials["mazeWall"].get(); wallRitem17->Geo = mGeometries["wallGeo"].get(); wallRitem17->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem17->IndexCount = wallRitem17->Geo->DrawArgs["wall"].IndexCount; wallRitem17->StartIndexLocation = wallRitem17->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem17->BaseVertexLocation = wallRitem17->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem17.get());
-	BoundingBox collider17;
-	collider17.Center = center17;
-	collider17.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX17); // Rotated 90Y
-	mColliders.push_back(collider17);
-
-	// wallRitem18: LEFT Wall
-	auto wallRitem18 = std::make_unique<RenderItem>();
-	XMFLOAT3 center18 = XMFLOAT3(50.0f, 4.0f, -28.0f);
-	float scaleX18 = 0.45f;
-	XMStoreFloat4x4(&wallRitem18->World, XMMatrixScaling(scaleX18, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center18.x, center18.y, center18.z));
-	wallRitem18->ObjCBIndex = 36;
-	wallRitem18->Mat = mMaterials["mazeWall"].get(); wallRitem18->Geo = mGeometries["wallGeo"].get(); wallRitem18->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem18->IndexCount = wallRitem18->Geo->DrawArgs["wall"].IndexCount; wallRitem18->StartIndexLocation = wallRitem18->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem18->BaseVertexLocation = wallRitem18->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem18.get());
-	BoundingBox collider18;
-	collider18.Center = center18;
-	collider18.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX18); // Rotated 90Y
-	mColliders.push_back(collider18);
-
-	// wallRitem19: LEFT Wall
-	auto wallRitem19 = std::make_unique<RenderItem>();
-	XMFLOAT3 center19 = XMFLOAT3(35.0f, 4.0f, -36.0f);
-	float scaleX19 = 0.9f;
-	XMStoreFloat4x4(&wallRitem19->World, XMMatrixScaling(scaleX19, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center19.x, center19.y, center19.z));
-	wallRitem19->ObjCBIndex = 37;
-	wallRitem19->Mat = mMaterials["mazeWall"].get(); wallRitem19->Geo = mGeometries["wallGeo"].get(); wallRitem19->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem19->IndexCount = wallRitem19->Geo->DrawArgs["wall"].IndexCount; wallRitem19->StartIndexLocation = wallRitem19->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem19->BaseVertexLocation = wallRitem19->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem19.get());
-	BoundingBox collider19;
-	collider19.Center = center19;
-	collider19.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX19); // Rotated 90Y
-	mColliders.push_back(collider19);
-
-	// wallRitem20: LEFT Wall (Boundary)
-	auto wallRitem20 = std::make_unique<RenderItem>();
-	XMFLOAT3 center20 = XMFLOAT3(58.0f, 4.0f, 0.0f);
-	float scaleX20 = 3.9f; // Very long
-	XMStoreFloat4x4(&wallRitem20->World, XMMatrixScaling(scaleX20, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center20.x, center20.y, center20.z));
-	wallRitem20->ObjCBIndex = 38;
-	wallRitem20->Mat = mMaterials["mazeWall"].get(); wallRitem20->Geo = mGeometries["wallGeo"].get(); wallRitem20->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem20->IndexCount = wallRitem20->Geo->DrawArgs["wall"].IndexCount; wallRitem20->StartIndexLocation = wallRitem20->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem20->BaseVertexLocation = wallRitem20->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem20.get());
-	BoundingBox collider20;
-	collider20.Center = center20;
-	collider20.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX20); // Rotated 90Y
-	mColliders.push_back(collider20);
-
-
-	// wallRitem21: BACK WALL (Boundary)
-	auto wallRitem21 = std::make_unique<RenderItem>();
-	XMFLOAT3 center21 = XMFLOAT3(0.0f, 4.0f, 58.0f);
-	float scaleX21 = 3.9f; // Very long
-	XMStoreFloat4x4(&wallRitem21->World, XMMatrixScaling(scaleX21, 1.0f, 1.0f)* XMMatrixTranslation(center21.x, center21.y, center21.z));
-	wallRitem21->ObjCBIndex = 39;
-	wallRitem21->Mat = mMaterials["mazeWall"].get(); wallRitem21->Geo = mGeometries["wallGeo"].get(); wallRitem21->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem21->IndexCount = wallRitem21->Geo->DrawArgs["wall"].IndexCount; wallRitem21->StartIndexLocation = wallRitem21->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem21->BaseVertexLocation = wallRitem21->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem21.get());
-	BoundingBox collider21;
-	collider21.Center = center21;
-	collider21.Extents = XMFLOAT3(15.0f * scaleX21, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider21);
-
-	// wallRitem22: RIGHT WALL (Boundary)
-	auto wallRitem22 = std::make_unique<RenderItem>();
-	XMFLOAT3 center22 = XMFLOAT3(-58.0f, 4.0f, 0.0f);
-	float scaleX22 = 3.9f; // Very long
-	XMStoreFloat4x4(&wallRitem22->World, XMMatrixScaling(scaleX22, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center22.x, center22.y, center22.z));
-	wallRitem22->ObjCBIndex = 40;
-	wallRitem22->Mat = mMaterials["mazeWall"].get(); wallRitem22->Geo = mGeometries["wallGeo"].get(); wallRitem22->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem22->IndexCount = wallRitem22->Geo->DrawArgs["wall"].IndexCount; wallRitem22->StartIndexLocation = wallRitem22->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem22->BaseVertexLocation = wallRitem22->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem22.get());
-	BoundingBox collider22;
-	collider22.Center = center22;
-	collider22.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX22); // Rotated -90Y
-	mColliders.push_back(collider22);
-
-
-	// wallRitem23: FRONTWALL (Boundary)
-	auto wallRitem23 = std::make_unique<RenderItem>();
-	XMFLOAT3 center23 = XMFLOAT3(-3.5f, 4.0f, -58.0f);
-	float scaleX23 = 3.65f; // Very long
-	XMStoreFloat4x4(&wallRitem23->World, XMMatrixScaling(scaleX23, 1.0f, 1.0f)* XMMatrixTranslation(center23.x, center23.y, center23.z));
-	wallRitem23->ObjCBIndex = 41;
-	wallRitem23->Mat = mMaterials["mazeWall"].get(); wallRitem23->Geo = mGeometries["wallGeo"].get(); wallRitem23->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem23->IndexCount = wallRitem23->Geo->DrawArgs["wall"].IndexCount; wallRitem23->StartIndexLocation = wallRitem23->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem23->BaseVertexLocation = wallRitem23->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem23.get());
-	BoundingBox collider23;
-	collider23.Center = center23;
-	collider23.Extents = XMFLOAT3(15.0f * scaleX23, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider23);
-
-	// SECOND WATER (WAVE)
-	auto wavesRitem2 = std::make_unique<RenderItem>();
-	wavesRitem2->World = MathHelper::Identity4x4();
-	XMMATRIX wavesWorld2 = XMMatrixTranslation(-69.0f, 0.1f, 0.0f); // Positioned on the opposite side
-	XMStoreFloat4x4(&wavesRitem2->World, wavesWorld2);
-	XMStoreFloat4x4(&wavesRitem2->TexTransform, XMMatrixScaling(5.0f, 5.0f, 1.0f));
-	wavesRitem2->ObjCBIndex = 42; // Make sure this is unique
-	wavesRitem2->Mat = mMaterials["water"].get();
-	wavesRitem2->Geo = mGeometries["waterGeo"].get();
-	wavesRitem2->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	wavesRitem2->IndexCount = wavesRitem2->Geo->DrawArgs["grid"].IndexCount;
-	wavesRitem2->StartIndexLocation = wavesRitem2->Geo->DrawArgs["grid"].StartIndexLocation;
-	wavesRitem2->BaseVertexLocation = wavesRitem2->Geo->DrawArgs["grid"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Transparent].push_back(wavesRitem2.get());
-
-	// THIRD WAVE (WAVE)
-	auto wavesRitem3 = std::make_unique<RenderItem>();
-	wavesRitem3->World = MathHelper::Identity4x4();
-	// Rotate 90 degrees around Y-axis and position it perpendicular to the other waves
-	XMMATRIX wavesWorld3 = XMMatrixRotationY(XMConvertToRadians(90.0f)) *
-		XMMatrixTranslation(0.0f, 0.1f, 69.0f);
-	XMStoreFloat4x4(&wavesRitem3->World, wavesWorld3);
-	XMStoreFloat4x4(&wavesRitem3->TexTransform, XMMatrixScaling(5.0f, 5.0f, 1.0f));
-	wavesRitem3->ObjCBIndex = 43; // Make sure this is unique
-	wavesRitem3->Mat = mMaterials["water"].get();
-	wavesRitem3->Geo = mGeometries["waterGeo"].get();
-	wavesRitem3->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	wavesRitem3->IndexCount = wavesRitem3->Geo->DrawArgs["grid"].IndexCount;
-	wavesRitem3->StartIndexLocation = wavesRitem3->Geo->DrawArgs["grid"].StartIndexLocation;
-	wavesRitem3->BaseVertexLocation = wavesRitem3->Geo->DrawArgs["grid"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Transparent].push_back(wavesRitem3.get());
-
-	// FOURTH WAVE (WAVE)
-	auto wavesRitem4 = std::make_unique<RenderItem>();
-	wavesRitem4->World = MathHelper::Identity4x4();
-	// Rotate 90 degrees around Y-axis and position it perpendicular to the other waves
-	XMMATRIX wavesWorld4 = XMMatrixRotationY(XMConvertToRadians(90.0f)) *
-		XMMatrixTranslation(0.0f, 0.1f, -69.0f);
-	XMStoreFloat4x4(&wavesRitem4->World, wavesWorld4);
-	XMStoreFloat4x4(&wavesRitem4->TexTransform, XMMatrixScaling(5.0f, 5.0f, 1.0f));
-	wavesRitem4->ObjCBIndex = 44; // Make sure this is unique
-	wavesRitem4->Mat = mMaterials["water"].get();
-	wavesRitem4->Geo = mGeometries["waterGeo"].get();
-	wavesRitem4->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-	wavesRitem4->IndexCount = wavesRitem4->Geo->DrawArgs["grid"].IndexCount;
-	wavesRitem4->StartIndexLocation = wavesRitem4->Geo->DrawArgs["grid"].StartIndexLocation;
-	wavesRitem4->BaseVertexLocation = wavesRitem4->Geo->DrawArgs["grid"].BaseVertexLocation;
-
-	mRitemLayer[(int)RenderLayer::Transparent].push_back(wavesRitem4.get());
-	
-	// wallRitem24: LEFT Wall
-	auto wallRitem24 = std::make_unique<RenderItem>();
-	XMFLOAT3 center24 = XMFLOAT3(43.0f, 4.0f, -30.0f);
-	float scaleX24 = 1.0f; // No X scale specified, assume 1
-	XMStoreFloat4x4(&wallRitem24->World, XMMatrixScaling(scaleX24, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center24.x, center24.y, center24.z));
-	wallRitem24->ObjCBIndex = 45;
-	wallRitem24->Mat = mMaterials["mazeWall"].get(); wallRitem24->Geo = mGeometries["wallGeo"].get(); wallRitem24->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem24->IndexCount = wallRitem24->Geo->DrawArgs["wall"].IndexCount; wallRitem24->StartIndexLocation = wallRitem24->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem24->BaseVertexLocation = wallRitem24->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem24.get());
-	BoundingBox collider24;
-	collider24.Center = center24;
-	collider24.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX24); // Rotated 90Y
-	mColliders.push_back(collider24);
-
-
-	// wallRitem25: FRONTWALL
-	auto wallRitem25 = std::make_unique<RenderItem>();
-	XMFLOAT3 center25 = XMFLOAT3(0.0f, 4.0f, -50.0f);
-	float scaleX25 = 3.4f;
-	XMStoreFloat4x4(&wallRitem25->World, XMMatrixScaling(scaleX25, 1.0f, 1.0f)* XMMatrixTranslation(center25.x, center25.y, center25.z));
-	wallRitem25->ObjCBIndex = 46;
-	wallRitem25->Mat = mMaterials["mazeWall"].get(); wallRitem25->Geo = mGeometries["wallGeo"].get(); wallRitem25->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem25->IndexCount = wallRitem25->Geo->DrawArgs["wall"].IndexCount; wallRitem25->StartIndexLocation = wallRitem25->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem25->BaseVertexLocation = wallRitem25->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem25.get());
-	BoundingBox collider25;
-	collider25.Center = center25;
-	collider25.Extents = XMFLOAT3(15.0f * scaleX25, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider25);
-
-	// wallRitem26: LEFT Wall
-	auto wallRitem26 = std::make_unique<RenderItem>();
-	XMFLOAT3 center26 = XMFLOAT3(50.5f, 4.0f, -46.0f);
-	float scaleX26 = 0.3f;
-	XMStoreFloat4x4(&wallRitem26->World, XMMatrixScaling(scaleX26, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center26.x, center26.y, center26.z));
-	wallRitem26->ObjCBIndex =47;
-	wallRitem26->Mat = mMaterials["mazeWall"].get(); wallRitem26->Geo = mGeometries["wallGeo"].get(); wallRitem26->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem26->IndexCount = wallRitem26->Geo->DrawArgs["wall"].IndexCount; wallRitem26->StartIndexLocation = wallRitem26->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem26->BaseVertexLocation = wallRitem26->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem26.get());
-	BoundingBox collider26;
-	collider26.Center = center26;
-	collider26.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX26); // Rotated 90Y
-	mColliders.push_back(collider26);
-
-	// wallRitem27: FRONTWALL
-	auto wallRitem27 = std::make_unique<RenderItem>();
-	XMFLOAT3 center27 = XMFLOAT3(46.5f, 4.0f, -34.3f);
-	float scaleX27 = 0.2f;
-	XMStoreFloat4x4(&wallRitem27->World, XMMatrixScaling(scaleX27, 1.0f, 1.0f)* XMMatrixTranslation(center27.x, center27.y, center27.z));
-	wallRitem27->ObjCBIndex = 48;
-	wallRitem27->Mat = mMaterials["mazeWall"].get(); wallRitem27->Geo = mGeometries["wallGeo"].get(); wallRitem27->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem27->IndexCount = wallRitem27->Geo->DrawArgs["wall"].IndexCount; wallRitem27->StartIndexLocation = wallRitem27->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem27->BaseVertexLocation = wallRitem27->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem27.get());
-	BoundingBox collider27;
-	collider27.Center = center27;
-	collider27.Extents = XMFLOAT3(15.0f * scaleX27, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider27);
-
-	// wallRitem28: FRONTWALL
-	auto wallRitem28 = std::make_unique<RenderItem>();
-	XMFLOAT3 center28 = XMFLOAT3(23.0f, 4.0f, -44.0f);
-	float scaleX28 = 0.3f;
-	XMStoreFloat4x4(&wallRitem28->World, XMMatrixScaling(scaleX28, 1.0f, 1.0f)* XMMatrixTranslation(center28.x, center28.y, center28.z));
-	wallRitem28->ObjCBIndex = 49;
-	wallRitem28->Mat = mMaterials["mazeWall"].get(); wallRitem28->Geo = mGeometries["wallGeo"].get(); wallRitem28->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem28->IndexCount = wallRitem28->Geo->DrawArgs["wall"].IndexCount; wallRitem28->StartIndexLocation = wallRitem28->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem28->BaseVertexLocation = wallRitem28->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem28.get());
-	BoundingBox collider28;
-	collider28.Center = center28;
-	collider28.Extents = XMFLOAT3(15.0f * scaleX28, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider28);
-
-	// wallRitem29: LEFT Wall
-	auto wallRitem29 = std::make_unique<RenderItem>();
-	XMFLOAT3 center29 = XMFLOAT3(18.0f, 4.0f, -40.0f);
-	float scaleX29 = 0.3f;
-	XMStoreFloat4x4(&wallRitem29->World, XMMatrixScaling(scaleX29, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center29.x, center29.y, center29.z));
-	wallRitem29->ObjCBIndex = 50;
-	wallRitem29->Mat = mMaterials["mazeWall"].get(); wallRitem29->Geo = mGeometries["wallGeo"].get(); wallRitem29->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem29->IndexCount = wallRitem29->Geo->DrawArgs["wall"].IndexCount; wallRitem29->StartIndexLocation = wallRitem29->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem29->BaseVertexLocation = wallRitem29->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem29.get());
-	BoundingBox collider29;
-	collider29.Center = center29;
-	collider29.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX29); // Rotated 90Y
-	mColliders.push_back(collider29);
-
-	// wallRitem30: FRONTWALL
-	auto wallRitem30 = std::make_unique<RenderItem>();
-	XMFLOAT3 center30 = XMFLOAT3(-11.0f, 4.0f, -44.0f);
-	float scaleX30 = 1.45f;
-	XMStoreFloat4x4(&wallRitem30->World, XMMatrixScaling(scaleX30, 1.0f, 1.0f)* XMMatrixTranslation(center30.x, center30.y, center30.z));
-	wallRitem30->ObjCBIndex = 51;
-	wallRitem30->Mat = mMaterials["mazeWall"].get(); wallRitem30->Geo = mGeometries["wallGeo"].get(); wallRitem30->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem30->IndexCount = wallRitem30->Geo->DrawArgs["wall"].IndexCount; wallRitem30->StartIndexLocation = wallRitem30->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem30->BaseVertexLocation = wallRitem30->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem30.get());
-	BoundingBox collider30;
-	collider30.Center = center30;
-	collider30.Extents = XMFLOAT3(15.0f * scaleX30, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider30);
-
-	// wallRitem31: FRONTWALL
-	auto wallRitem31 = std::make_unique<RenderItem>();
-	XMFLOAT3 center31 = XMFLOAT3(-8.0f, 4.0f, -37.0f);
-	float scaleX31 = 1.25f;
-	XMStoreFloat4x4(&wallRitem31->World, XMMatrixScaling(scaleX31, 1.0f, 1.0f)* XMMatrixTranslation(center31.x, center31.y, center31.z));
-	wallRitem31->ObjCBIndex = 52;
-	wallRitem31->Mat = mMaterials["mazeWall"].get(); wallRitem31->Geo = mGeometries["wallGeo"].get(); wallRitem31->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem31->IndexCount = wallRitem31->Geo->DrawArgs["wall"].IndexCount; wallRitem31->StartIndexLocation = wallRitem31->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem31->BaseVertexLocation = wallRitem31->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem31.get());
-	BoundingBox collider31;
-	collider31.Center = center31;
-	collider31.Extents = XMFLOAT3(15.0f * scaleX31, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider31);
-
-	// wallRitem32: LEFT Wall
-	auto wallRitem32 = std::make_unique<RenderItem>();
-	XMFLOAT3 center32 = XMFLOAT3(-32.5f, 4.0f, -36.5f);
-	float scaleX32 = 0.51f;
-	XMStoreFloat4x4(&wallRitem32->World, XMMatrixScaling(scaleX32, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center32.x, center32.y, center32.z));
-	wallRitem32->ObjCBIndex = 53;
-	wallRitem32->Mat = mMaterials["mazeWall"].get(); wallRitem32->Geo = mGeometries["wallGeo"].get(); wallRitem32->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem32->IndexCount = wallRitem32->Geo->DrawArgs["wall"].IndexCount; wallRitem32->StartIndexLocation = wallRitem32->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem32->BaseVertexLocation = wallRitem32->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem32.get());
-	BoundingBox collider32;
-	collider32.Center = center32;
-	collider32.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX32); // Rotated 90Y
-	mColliders.push_back(collider32);
-
-
-	// wallRitem33: LEFT Wall
-	auto wallRitem33 = std::make_unique<RenderItem>();
-	XMFLOAT3 center33 = XMFLOAT3(-50.5f, 4.0f, -36.5f);
-	float scaleX33 = 0.51f;
-	XMStoreFloat4x4(&wallRitem33->World, XMMatrixScaling(scaleX33, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(90.0f))*
-		XMMatrixTranslation(center33.x, center33.y, center33.z));
-	wallRitem33->ObjCBIndex = 54;
-	wallRitem33->Mat = mMaterials["mazeWall"].get(); wallRitem33->Geo = mGeometries["wallGeo"].get(); wallRitem33->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem33->IndexCount = wallRitem33->Geo->DrawArgs["wall"].IndexCount; wallRitem33->StartIndexLocation = wallRitem33->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem33->BaseVertexLocation = wallRitem33->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem33.get());
-	BoundingBox collider33;
-	collider33.Center = center33;
-	collider33.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX33); // Rotated 90Y
-	mColliders.push_back(collider33);
-
-	// wallRitem34: FRONTWALL
-	auto wallRitem34 = std::make_unique<RenderItem>();
-	XMFLOAT3 center34 = XMFLOAT3(-39.0f, 4.0f, -37.0f);
-	float scaleX34 = 0.4f;
-	XMStoreFloat4x4(&wallRitem34->World, XMMatrixScaling(scaleX34, 1.0f, 1.0f)* XMMatrixTranslation(center34.x, center34.y, center34.z));
-	wallRitem34->ObjCBIndex = 55;
-	wallRitem34->Mat = mMaterials["mazeWall"].get(); wallRitem34->Geo = mGeometries["wallGeo"].get(); wallRitem34->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem34->IndexCount = wallRitem34->Geo->DrawArgs["wall"].IndexCount; wallRitem34->StartIndexLocation = wallRitem34->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem34->BaseVertexLocation = wallRitem34->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem34.get());
-	BoundingBox collider34;
-	collider34.Center = center34;
-	collider34.Extents = XMFLOAT3(15.0f * scaleX34, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider34);
-
-	// wallRitem35: FRONTWALL
-	auto wallRitem35 = std::make_unique<RenderItem>();
-	XMFLOAT3 center35 = XMFLOAT3(-45.0f, 4.0f, -28.5f);
-	float scaleX35 = 0.4f;
-	XMStoreFloat4x4(&wallRitem35->World, XMMatrixScaling(scaleX35, 1.0f, 1.0f)* XMMatrixTranslation(center35.x, center35.y, center35.z));
-	wallRitem35->ObjCBIndex = 56;
-	wallRitem35->Mat = mMaterials["mazeWall"].get(); wallRitem35->Geo = mGeometries["wallGeo"].get(); wallRitem35->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem35->IndexCount = wallRitem35->Geo->DrawArgs["wall"].IndexCount; wallRitem35->StartIndexLocation = wallRitem35->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem35->BaseVertexLocation = wallRitem35->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem35.get());
-	BoundingBox collider35;
-	collider35.Center = center35;
-	collider35.Extents = XMFLOAT3(15.0f * scaleX35, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider35);
-
-	// wallRitem36: FRONTWALL
-	auto wallRitem36 = std::make_unique<RenderItem>();
-	XMFLOAT3 center36 = XMFLOAT3(-45.0f, 4.0f, -44.0f);
-	float scaleX36 = 0.4f;
-	XMStoreFloat4x4(&wallRitem36->World, XMMatrixScaling(scaleX36, 1.0f, 1.0f)* XMMatrixTranslation(center36.x, center36.y, center36.z));
-	wallRitem36->ObjCBIndex = 57;
-	wallRitem36->Mat = mMaterials["mazeWall"].get(); wallRitem36->Geo = mGeometries["wallGeo"].get(); wallRitem36->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem36->IndexCount = wallRitem36->Geo->DrawArgs["wall"].IndexCount; wallRitem36->StartIndexLocation = wallRitem36->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem36->BaseVertexLocation = wallRitem36->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem36.get());
-	BoundingBox collider36;
-	collider36.Center = center36;
-	collider36.Extents = XMFLOAT3(15.0f * scaleX36, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider36);
-
-
-	// wallRitem37: RIGHT WALL
-	auto wallRitem37 = std::make_unique<RenderItem>();
-	XMFLOAT3 center37 = XMFLOAT3(-33.0f, 4.0f, -1.5f);
-	float scaleX37 = 1.45f;
-	XMStoreFloat4x4(&wallRitem37->World, XMMatrixScaling(scaleX37, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center37.x, center37.y, center37.z));
-	wallRitem37->ObjCBIndex = 58;
-	wallRitem37->Mat = mMaterials["mazeWall"].get(); wallRitem37->Geo = mGeometries["wallGeo"].get(); wallRitem37->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem37->IndexCount = wallRitem37->Geo->DrawArgs["wall"].IndexCount; wallRitem37->StartIndexLocation = wallRitem37->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem37->BaseVertexLocation = wallRitem37->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem37.get());
-	BoundingBox collider37;
-	collider37.Center = center37;
-	collider37.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX37); // Rotated -90Y
-	mColliders.push_back(collider37);
-
-	// wallRitem38: RIGHT WALL
-	auto wallRitem38 = std::make_unique<RenderItem>();
-	XMFLOAT3 center38 = XMFLOAT3(-41.0f, 4.0f, -5.0f);
-	float scaleX38 = 1.2f;
-	XMStoreFloat4x4(&wallRitem38->World, XMMatrixScaling(scaleX38, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center38.x, center38.y, center38.z));
-	wallRitem38->ObjCBIndex = 59;
-	wallRitem38->Mat = mMaterials["mazeWall"].get(); wallRitem38->Geo = mGeometries["wallGeo"].get(); wallRitem38->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem38->IndexCount = wallRitem38->Geo->DrawArgs["wall"].IndexCount; wallRitem38->StartIndexLocation = wallRitem38->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem38->BaseVertexLocation = wallRitem38->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem38.get());
-	BoundingBox collider38;
-	collider38.Center = center38;
-	collider38.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX38); // Rotated -90Y
-	mColliders.push_back(collider38);
-
-	// wallRitem39: RIGHT WALL
-	auto wallRitem39 = std::make_unique<RenderItem>();
-	XMFLOAT3 center39 = XMFLOAT3(-48.0f, 4.0f, 2.0f);
-	float scaleX39 = 1.2f;
-	XMStoreFloat4x4(&wallRitem39->World, XMMatrixScaling(scaleX39, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center39.x, center39.y, center39.z));
-	wallRitem39->ObjCBIndex = 60;
-	wallRitem39->Mat = mMaterials["mazeWall"].get(); wallRitem39->Geo = mGeometries["wallGeo"].get(); wallRitem39->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem39->IndexCount = wallRitem39->Geo->DrawArgs["wall"].IndexCount; wallRitem39->StartIndexLocation = wallRitem39->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem39->BaseVertexLocation = wallRitem39->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem39.get());
-	BoundingBox collider39;
-	collider39.Center = center39;
-	collider39.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX39); // Rotated -90Y
-	mColliders.push_back(collider39);
-
-
-	// wallRitem40: FRONTWALL
-	auto wallRitem40 = std::make_unique<RenderItem>();
-	XMFLOAT3 center40 = XMFLOAT3(-46.0f, 4.0f, -22.5f);
-	float scaleX40 = 0.34f;
-	XMStoreFloat4x4(&wallRitem40->World, XMMatrixScaling(scaleX40, 1.0f, 1.0f)* XMMatrixTranslation(center40.x, center40.y, center40.z));
-	wallRitem40->ObjCBIndex = 61;
-	wallRitem40->Mat = mMaterials["mazeWall"].get(); wallRitem40->Geo = mGeometries["wallGeo"].get(); wallRitem40->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem40->IndexCount = wallRitem40->Geo->DrawArgs["wall"].IndexCount; wallRitem40->StartIndexLocation = wallRitem40->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem40->BaseVertexLocation = wallRitem40->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem40.get());
-	BoundingBox collider40;
-	collider40.Center = center40;
-	collider40.Extents = XMFLOAT3(15.0f * scaleX40, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider40);
-
-	// wallRitem41: FRONTWALL
-	auto wallRitem41 = std::make_unique<RenderItem>();
-	XMFLOAT3 center41 = XMFLOAT3(-40.5f, 4.0f, 20.0f);
-	float scaleX41 = 0.53f;
-	XMStoreFloat4x4(&wallRitem41->World, XMMatrixScaling(scaleX41, 1.0f, 1.0f)* XMMatrixTranslation(center41.x, center41.y, center41.z));
-	wallRitem41->ObjCBIndex = 62;
-	wallRitem41->Mat = mMaterials["mazeWall"].get(); wallRitem41->Geo = mGeometries["wallGeo"].get(); wallRitem41->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem41->IndexCount = wallRitem41->Geo->DrawArgs["wall"].IndexCount; wallRitem41->StartIndexLocation = wallRitem41->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem41->BaseVertexLocation = wallRitem41->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem41.get());
-	BoundingBox collider41;
-	collider41.Center = center41;
-	collider41.Extents = XMFLOAT3(15.0f * scaleX41, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider41);
-
-
-	// wallRitem42: FRONTWALL
-	auto wallRitem42 = std::make_unique<RenderItem>();
-	XMFLOAT3 center42 = XMFLOAT3(-11.5f, 4.0f, 29.0f);
-	float scaleX42 = 2.6f;
-	XMStoreFloat4x4(&wallRitem42->World, XMMatrixScaling(scaleX42, 1.0f, 1.0f)* XMMatrixTranslation(center42.x, center42.y, center42.z));
-	wallRitem42->ObjCBIndex = 63;
-	wallRitem42->Mat = mMaterials["mazeWall"].get(); wallRitem42->Geo = mGeometries["wallGeo"].get(); wallRitem42->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem42->IndexCount = wallRitem42->Geo->DrawArgs["wall"].IndexCount; wallRitem42->StartIndexLocation = wallRitem42->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem42->BaseVertexLocation = wallRitem42->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem42.get());
-	BoundingBox collider42;
-	collider42.Center = center42;
-	collider42.Extents = XMFLOAT3(15.0f * scaleX42, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider42);
-
-	// wallRitem43: FRONTWALL
-	auto wallRitem43 = std::make_unique<RenderItem>();
-	XMFLOAT3 center43 = XMFLOAT3(-27.5f, 4.0f, 39.0f);
-	float scaleX43 = 2.0f;
-	XMStoreFloat4x4(&wallRitem43->World, XMMatrixScaling(scaleX43, 1.0f, 1.0f)* XMMatrixTranslation(center43.x, center43.y, center43.z));
-	wallRitem43->ObjCBIndex = 64;
-	wallRitem43->Mat = mMaterials["mazeWall"].get(); wallRitem43->Geo = mGeometries["wallGeo"].get(); wallRitem43->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem43->IndexCount = wallRitem43->Geo->DrawArgs["wall"].IndexCount; wallRitem43->StartIndexLocation = wallRitem43->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem43->BaseVertexLocation = wallRitem43->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem43.get());
-	BoundingBox collider43;
-	collider43.Center = center43;
-	collider43.Extents = XMFLOAT3(15.0f * scaleX43, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider43);
-
-	// wallRitem44: FRONTWALL
-	auto wallRitem44 = std::make_unique<RenderItem>();
-	XMFLOAT3 center44 = XMFLOAT3(-20.5f, 4.0f, 48.0f);
-	float scaleX44 = 2.0f;
-	XMStoreFloat4x4(&wallRitem44->World, XMMatrixScaling(scaleX44, 1.0f, 1.0f)* XMMatrixTranslation(center44.x, center44.y, center44.z));
-	wallRitem44->ObjCBIndex = 65;
-	wallRitem44->Mat = mMaterials["mazeWall"].get(); wallRitem44->Geo = mGeometries["wallGeo"].get(); wallRitem44->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem44->IndexCount = wallRitem44->Geo->DrawArgs["wall"].IndexCount; wallRitem44->StartIndexLocation = wallRitem44->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem44->BaseVertexLocation = wallRitem44->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem44.get());
-	BoundingBox collider44;
-	collider44.Center = center44;
-	collider44.Extents = XMFLOAT3(15.0f * scaleX44, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider44);
-
-
-	// wallRitem45: RIGHT WALL
-	auto wallRitem45 = std::make_unique<RenderItem>();
-	XMFLOAT3 center45 = XMFLOAT3(9.0f, 4.0f, 38.5f);
-	float scaleX45 = 0.65f;
-	XMStoreFloat4x4(&wallRitem45->World, XMMatrixScaling(scaleX45, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center45.x, center45.y, center45.z));
-	wallRitem45->ObjCBIndex = 66;
-	wallRitem45->Mat = mMaterials["mazeWall"].get(); wallRitem45->Geo = mGeometries["wallGeo"].get(); wallRitem45->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem45->IndexCount = wallRitem45->Geo->DrawArgs["wall"].IndexCount; wallRitem45->StartIndexLocation = wallRitem45->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem45->BaseVertexLocation = wallRitem45->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem45.get());
-	BoundingBox collider45;
-	collider45.Center = center45;
-	collider45.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX45); // Rotated -90Y
-	mColliders.push_back(collider45);
-
-	// wallRitem46: RIGHT WALL
-	auto wallRitem46 = std::make_unique<RenderItem>();
-	XMFLOAT3 center46 = XMFLOAT3(27.0f, 4.0f, 37.5f);
-	float scaleX46 = 0.7f;
-	XMStoreFloat4x4(&wallRitem46->World, XMMatrixScaling(scaleX46, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center46.x, center46.y, center46.z));
-	wallRitem46->ObjCBIndex = 67;
-	wallRitem46->Mat = mMaterials["mazeWall"].get(); wallRitem46->Geo = mGeometries["wallGeo"].get(); wallRitem46->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem46->IndexCount = wallRitem46->Geo->DrawArgs["wall"].IndexCount; wallRitem46->StartIndexLocation = wallRitem46->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem46->BaseVertexLocation = wallRitem46->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem46.get());
-	BoundingBox collider46;
-	collider46.Center = center46;
-	collider46.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX46); // Rotated -90Y
-	mColliders.push_back(collider46);
-
-	// wallRitem47: RIGHT WALL
-	auto wallRitem47 = std::make_unique<RenderItem>();
-	XMFLOAT3 center47 = XMFLOAT3(18.0f, 4.0f, 47.5f);
-	float scaleX47 = 0.7f;
-	XMStoreFloat4x4(&wallRitem47->World, XMMatrixScaling(scaleX47, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center47.x, center47.y, center47.z));
-	wallRitem47->ObjCBIndex = 68;
-	wallRitem47->Mat = mMaterials["mazeWall"].get(); wallRitem47->Geo = mGeometries["wallGeo"].get(); wallRitem47->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem47->IndexCount = wallRitem47->Geo->DrawArgs["wall"].IndexCount; wallRitem47->StartIndexLocation = wallRitem47->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem47->BaseVertexLocation = wallRitem47->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem47.get());
-	BoundingBox collider47;
-	collider47.Center = center47;
-	collider47.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX47); // Rotated -90Y
-	mColliders.push_back(collider47);
-
-	// wallRitem48: FRONTWALL
-	auto wallRitem48 = std::make_unique<RenderItem>();
-	XMFLOAT3 center48 = XMFLOAT3(38.5f, 4.0f, 48.0f);
-	float scaleX48 = 0.78f;
-	XMStoreFloat4x4(&wallRitem48->World, XMMatrixScaling(scaleX48, 1.0f, 1.0f)* XMMatrixTranslation(center48.x, center48.y, center48.z));
-	wallRitem48->ObjCBIndex = 69;
-	wallRitem48->Mat = mMaterials["mazeWall"].get(); wallRitem48->Geo = mGeometries["wallGeo"].get(); wallRitem48->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem48->IndexCount = wallRitem48->Geo->DrawArgs["wall"].IndexCount; wallRitem48->StartIndexLocation = wallRitem48->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem48->BaseVertexLocation = wallRitem48->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem48.get());
-	BoundingBox collider48;
-	collider48.Center = center48;
-	collider48.Extents = XMFLOAT3(15.0f * scaleX48, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider48);
-
-	// wallRitem49: FRONTWALL
-	auto wallRitem49 = std::make_unique<RenderItem>();
-	XMFLOAT3 center49 = XMFLOAT3(46.7f, 4.0f, 38.0f);
-	float scaleX49 = 0.76f;
-	XMStoreFloat4x4(&wallRitem49->World, XMMatrixScaling(scaleX49, 1.0f, 1.0f)* XMMatrixTranslation(center49.x, center49.y, center49.z));
-	wallRitem49->ObjCBIndex = 70;
-	wallRitem49->Mat = mMaterials["mazeWall"].get(); wallRitem49->Geo = mGeometries["wallGeo"].get(); wallRitem49->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem49->IndexCount = wallRitem49->Geo->DrawArgs["wall"].IndexCount; wallRitem49->StartIndexLocation = wallRitem49->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem49->BaseVertexLocation = wallRitem49->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem49.get());
-	BoundingBox collider49;
-	collider49.Center = center49;
-	collider49.Extents = XMFLOAT3(15.0f * scaleX49, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider49);
-
-
-	// wallRitem50: FRONTWALL
-	auto wallRitem50 = std::make_unique<RenderItem>();
-	XMFLOAT3 center50 = XMFLOAT3(38.5f, 4.0f, 28.0f);
-	float scaleX50 = 0.78f;
-	XMStoreFloat4x4(&wallRitem50->World, XMMatrixScaling(scaleX50, 1.0f, 1.0f)* XMMatrixTranslation(center50.x, center50.y, center50.z));
-	wallRitem50->ObjCBIndex = 71;
-	wallRitem50->Mat = mMaterials["mazeWall"].get(); wallRitem50->Geo = mGeometries["wallGeo"].get(); wallRitem50->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem50->IndexCount = wallRitem50->Geo->DrawArgs["wall"].IndexCount; wallRitem50->StartIndexLocation = wallRitem50->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem50->BaseVertexLocation = wallRitem50->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem50.get());
-	BoundingBox collider50;
-	collider50.Center = center50;
-	collider50.Extents = XMFLOAT3(15.0f * scaleX50, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider50);
-
-
-	// wallRitem51: FRONTWALL
-	auto wallRitem51 = std::make_unique<RenderItem>();
-	XMFLOAT3 center51 = XMFLOAT3(38.8f, 4.0f, -9.0f);
-	float scaleX51 = 0.82f;
-	XMStoreFloat4x4(&wallRitem51->World, XMMatrixScaling(scaleX51, 1.0f, 1.0f)* XMMatrixTranslation(center51.x, center51.y, center51.z));
-	wallRitem51->ObjCBIndex = 72;
-	wallRitem51->Mat = mMaterials["mazeWall"].get(); wallRitem51->Geo = mGeometries["wallGeo"].get(); wallRitem51->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem51->IndexCount = wallRitem51->Geo->DrawArgs["wall"].IndexCount; wallRitem51->StartIndexLocation = wallRitem51->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem51->BaseVertexLocation = wallRitem51->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem51.get());
-	BoundingBox collider51;
-	collider51.Center = center51;
-	collider51.Extents = XMFLOAT3(15.0f * scaleX51, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider51);
-
-	// wallRitem52: FRONTWALL
-	auto wallRitem52 = std::make_unique<RenderItem>();
-	XMFLOAT3 center52 = XMFLOAT3(45.8f, 4.0f, -2.0f);
-	float scaleX52 = 0.82f;
-	XMStoreFloat4x4(&wallRitem52->World, XMMatrixScaling(scaleX52, 1.0f, 1.0f)* XMMatrixTranslation(center52.x, center52.y, center52.z));
-	wallRitem52->ObjCBIndex = 73;
-	wallRitem52->Mat = mMaterials["mazeWall"].get(); wallRitem52->Geo = mGeometries["wallGeo"].get(); wallRitem52->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem52->IndexCount = wallRitem52->Geo->DrawArgs["wall"].IndexCount; wallRitem52->StartIndexLocation = wallRitem52->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem52->BaseVertexLocation = wallRitem52->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem52.get());
-	BoundingBox collider52;
-	collider52.Center = center52;
-	collider52.Extents = XMFLOAT3(15.0f * scaleX52, 4.0f, 0.5f); // Scaled X
-	mColliders.push_back(collider52);
-
-	// wallRitem53: RIGHT WALL
-	auto wallRitem53 = std::make_unique<RenderItem>();
-	XMFLOAT3 center53 = XMFLOAT3(34.0f, 4.0f, 10.0f);
-	float scaleX53 = 0.8f;
-	XMStoreFloat4x4(&wallRitem53->World, XMMatrixScaling(scaleX53, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center53.x, center53.y, center53.z));
-	wallRitem53->ObjCBIndex = 74;
-	wallRitem53->Mat = mMaterials["mazeWall"].get(); wallRitem53->Geo = mGeometries["wallGeo"].get(); wallRitem53->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem53->IndexCount = wallRitem53->Geo->DrawArgs["wall"].IndexCount; wallRitem53->StartIndexLocation = wallRitem53->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem53->BaseVertexLocation = wallRitem53->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem53.get());
-	BoundingBox collider53;
-	collider53.Center = center53;
-	collider53.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX53); // Rotated -90Y
-	mColliders.push_back(collider53);
-
-
-	// wallRitem54: RIGHT WALL
-	auto wallRitem54 = std::make_unique<RenderItem>();
-	XMFLOAT3 center54 = XMFLOAT3(49.8f, 4.0f, 16.0f);
-	float scaleX54 = 0.8f;
-	XMStoreFloat4x4(&wallRitem54->World, XMMatrixScaling(scaleX54, 1.0f, 1.0f)*
-		XMMatrixRotationY(XMConvertToRadians(-90.0f))*
-		XMMatrixTranslation(center54.x, center54.y, center54.z));
-	wallRitem54->ObjCBIndex = 75;
-	wallRitem54->Mat = mMaterials["mazeWall"].get(); wallRitem54->Geo = mGeometries["wallGeo"].get(); wallRitem54->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; wallRitem54->IndexCount = wallRitem54->Geo->DrawArgs["wall"].IndexCount; wallRitem54->StartIndexLocation = wallRitem54->Geo->DrawArgs["wall"].StartIndexLocation; wallRitem54->BaseVertexLocation = wallRitem54->Geo->DrawArgs["wall"].BaseVertexLocation;
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem54.get());
-	BoundingBox collider54;
-	collider54.Center = center54;
-	collider54.Extents = XMFLOAT3(0.5f, 4.0f, 15.0f * scaleX54); // Rotated -90Y
-	mColliders.push_back(collider54);
-
-
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem1.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem2.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem3.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem4.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem5.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem6.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem7.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem8.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem9.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem10.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem11.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem12.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem13.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem14.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem15.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem16.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem17.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem18.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem19.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem20.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem21.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem22.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem23.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem24.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem25.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem26.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem27.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem28.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem29.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem30.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem31.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem32.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem33.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem34.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem35.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem36.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem37.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem38.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem39.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem40.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem41.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem42.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem43.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem44.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem45.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem46.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem47.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem48.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem49.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem50.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem51.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem52.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem53.get());
-	mRitemLayer[(int)RenderLayer::Opaque].push_back(wallRitem54.get());
-
-    mAllRitems.push_back(std::move(wavesRitem));
-	mAllRitems.push_back(std::move(wavesRitem2));
-	mAllRitems.push_back(std::move(wavesRitem3));
-	mAllRitems.push_back(std::move(wavesRitem4));
-    mAllRitems.push_back(std::move(gridRitem));
-	mAllRitems.push_back(std::move(boxRitem));
-	mAllRitems.push_back(std::move(treeSpritesRitem));
-	mAllRitems.push_back(std::move(boxRitem2));
-	mAllRitems.push_back(std::move(coneRitem));
-	mAllRitems.push_back(std::move(coneRitem2));
-	mAllRitems.push_back(std::move(coneRitem3));
-	mAllRitems.push_back(std::move(coneRitem4));
-	mAllRitems.push_back(std::move(cylinderRitem));
-	mAllRitems.push_back(std::move(cylinderRitem2));
-	mAllRitems.push_back(std::move(cylinderRitem3));
-	mAllRitems.push_back(std::move(cylinderRitem4));
-	mAllRitems.push_back(std::move(pyramidRitem));
-	mAllRitems.push_back(std::move(wedgeRitem));
-	mAllRitems.push_back(std::move(wedgeRitem2));
-	mAllRitems.push_back(std::move(torusRitem));
-	mAllRitems.push_back(std::move(diamondRitem));
-	mAllRitems.push_back(std::move(prismRitem));
-	mAllRitems.push_back(std::move(wallRitem1));
-	mAllRitems.push_back(std::move(wallRitem2));
-	mAllRitems.push_back(std::move(wallRitem3));
-	mAllRitems.push_back(std::move(wallRitem4));
-	mAllRitems.push_back(std::move(wallRitem5));
-	mAllRitems.push_back(std::move(wallRitem6));
-	mAllRitems.push_back(std::move(wallRitem7));
-	mAllRitems.push_back(std::move(wallRitem8));
-	mAllRitems.push_back(std::move(wallRitem9));
-	mAllRitems.push_back(std::move(wallRitem10));
-	mAllRitems.push_back(std::move(wallRitem11));
-	mAllRitems.push_back(std::move(wallRitem12));
-	mAllRitems.push_back(std::move(wallRitem13));
-	mAllRitems.push_back(std::move(wallRitem14));
-	mAllRitems.push_back(std::move(wallRitem15));
-	mAllRitems.push_back(std::move(wallRitem16));
-	mAllRitems.push_back(std::move(wallRitem17));
-	mAllRitems.push_back(std::move(wallRitem18));
-	mAllRitems.push_back(std::move(wallRitem19));
-	mAllRitems.push_back(std::move(wallRitem20));
-	mAllRitems.push_back(std::move(wallRitem21));
-	mAllRitems.push_back(std::move(wallRitem22));
-	mAllRitems.push_back(std::move(wallRitem23));
-	mAllRitems.push_back(std::move(wallRitem24));
-	mAllRitems.push_back(std::move(wallRitem25));
-	mAllRitems.push_back(std::move(wallRitem26));
-	mAllRitems.push_back(std::move(wallRitem27));
-	mAllRitems.push_back(std::move(wallRitem28));
-	mAllRitems.push_back(std::move(wallRitem29));
-	mAllRitems.push_back(std::move(wallRitem30));
-	mAllRitems.push_back(std::move(wallRitem31));
-	mAllRitems.push_back(std::move(wallRitem32));
-	mAllRitems.push_back(std::move(wallRitem33));
-	mAllRitems.push_back(std::move(wallRitem34));
-	mAllRitems.push_back(std::move(wallRitem35));
-	mAllRitems.push_back(std::move(wallRitem36));
-	mAllRitems.push_back(std::move(wallRitem37));
-	mAllRitems.push_back(std::move(wallRitem38));
-	mAllRitems.push_back(std::move(wallRitem39));
-	mAllRitems.push_back(std::move(wallRitem40));
-	mAllRitems.push_back(std::move(wallRitem41));
-	mAllRitems.push_back(std::move(wallRitem42));
-	mAllRitems.push_back(std::move(wallRitem43));
-	mAllRitems.push_back(std::move(wallRitem44));
-	mAllRitems.push_back(std::move(wallRitem45));
-	mAllRitems.push_back(std::move(wallRitem46));
-	mAllRitems.push_back(std::move(wallRitem47));
-	mAllRitems.push_back(std::move(wallRitem48));
-	mAllRitems.push_back(std::move(wallRitem49));
-	mAllRitems.push_back(std::move(wallRitem50));
-	mAllRitems.push_back(std::move(wallRitem51));
-	mAllRitems.push_back(std::move(wallRitem52));
-	mAllRitems.push_back(std::move(wallRitem53));
-	mAllRitems.push_back(std::move(wallRitem54));
-}
-
-void TreeBillboardsApp::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<RenderItem*>& ritems)
-{
-    UINT objCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(ObjectConstants));
-    UINT matCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(MaterialConstants));
-
-	auto objectCB = mCurrFrameResource->ObjectCB->Resource();
-	auto matCB = mCurrFrameResource->MaterialCB->Resource();
-
-    // For each render item...
-    for(size_t i = 0; i < ritems.size(); ++i)
-    {
-        auto ri = ritems[i];
+		geos[i] = mGeometries.Find(name);
+
+		mats[i] = mMaterials.Find(name);
+
+		for(const auto& layer : layerNames)
+		{
+			if(name == layer.first)
+				layers[i] = (int)layer.second;
+		}
+	}
 
-        cmdList->IASetVertexBuffers(0, 1, &ri->Geo->VertexBufferView());
-        cmdList->IASetIndexBuffer(&ri->Geo->IndexBufferView());
-		//step3
-        cmdList->IASetPrimitiveTopology(ri->PrimitiveType);
+	// Submeshes are looked up per (geometry, submesh) pair, so cache those too.
+	std::unordered_map<std::uint64_t, const SubmeshGeometry*> submeshes;
 
-		CD3DX12_GPU_DESCRIPTOR_HANDLE tex(mSrvDescriptorHeap->GetGPUDescriptorHandleForHeapStart());
-		tex.Offset(ri->Mat->DiffuseSrvHeapIndex, mCbvSrvDescriptorSize);
+	const UINT instanceCount = scene.InstanceCount();
+	mScene.Reserve(instanceCount);
+	mColliders.reserve(instanceCount);
 
-        D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = objectCB->GetGPUVirtualAddress() + ri->ObjCBIndex*objCBByteSize;
-		D3D12_GPU_VIRTUAL_ADDRESS matCBAddress = matCB->GetGPUVirtualAddress() + ri->Mat->MatCBIndex*matCBByteSize;
+	for(UINT i = 0; i < instanceCount; ++i)
+	{
+		const SceneInstance& instance = scene.Instance(i);
 
-		cmdList->SetGraphicsRootDescriptorTable(0, tex);
-        cmdList->SetGraphicsRootConstantBufferView(20, objCBAddress);
-        cmdList->SetGraphicsRootConstantBufferView(3, matCBAddress);
+		UINT geoHandle = geos[instance.Geometry];
+		MeshGeometry* geo = geoHandle != NameRegistry::InvalidHandle ? mGeometries[geoHandle].get() : nullptr;
+		UINT mat = mats[instance.Material];
+		int layer = layers[instance.Layer];
 
-        cmdList->DrawIndexedInstanced(ri->IndexCount, 1, ri->StartIndexLocation, ri->BaseVertexLocation, 0);
-    }
+		const SubmeshGeometry* submesh = nullptr;
+		if(geo != nullptr)
+		{
+			std::uint64_t key = ((std::uint64_t)instance.Geometry << 32) | instance.Submesh;
+			auto cached = submeshes.find(key);
+			if(cached != submeshes.end())
+			{
+				submesh = cached->second;
+			}
+			else
+			{
+				auto args = geo->DrawArgs.find(scene.String(instance.Submesh));
+				submesh = args != geo->DrawArgs.end() ? &args->second : nullptr;
+				submeshes.emplace(key, submesh);
+			}
+		}
+
+		if(submesh == nullptr || mat == NameRegistry::InvalidHandle || layer < 0)
+		{
+			std::string text = "Scene instance " + std::to_string(i) + " skipped: unknown " +
+				(submesh == nullptr ? "geometry/submesh" : mat == NameRegistry::InvalidHandle ? "material" : "layer") + "\n";
+			OutputDebugStringA(text.c_str());
+			continue;
+		}
+
+		SceneItemDesc item;
+		XMStoreFloat4x4(&item.World, Scene::World(instance));
+		XMStoreFloat4x4(&item.TexTransform, Scene::TexTransform(instance));
+		item.LocalBounds = submesh->Bounds;
+		item.Geometry = geoHandle;
+		item.Material = mat;
+		item.Layer = (UINT)layer;
+		item.Draw.PrimitiveType = (D3D12_PRIMITIVE_TOPOLOGY)instance.PrimitiveType;
+		item.Draw.IndexCount = submesh->IndexCount;
+		item.Draw.StartIndexLocation = submesh->StartIndexLocation;
+		item.Draw.BaseVertexLocation = submesh->BaseVertexLocation;
+
+		UINT handle = mScene.Create(item);
+
+		if(instance.Collider == SceneCollider::Box)
+			mColliders.push_back(BoundingBox(instance.ColliderCenter, instance.ColliderExtents));
+		else if(instance.Collider == SceneCollider::Auto)
+			mColliders.push_back(mScene.Bounds().Get(mScene.Slot(handle)));
+	}
+
+	// Cells about the length of a short maze wall keep only a handful of colliders
+	// in each cell.
+	mColliderGrid.Build(mColliders, 8.0f);
+
+	BuildInstanceBatches();
+}
+
+void TreeBillboardsApp::BuildInstanceBatches()
+{
+	// Only layers whose PSO has an instanced variant are batched.  Transparent items
+	// keep their own draws so their order can be controlled, and the tree sprites
+	// use their own vertex shader.
+	const RenderLayer instancedLayers[] = { RenderLayer::Opaque, RenderLayer::AlphaTested };
+
+	const UINT* layers = mScene.Layers();
+	const UINT* geometries = mScene.Geometries();
+	const UINT* materials = mScene.Materials();
+	const DrawArgs* draws = mScene.Draws();
+
+	for(RenderLayer layer : instancedLayers)
+	{
+		auto& batches = mInstanceBatches[(int)layer];
+		batches.clear();
+
+		typedef std::tuple<UINT, UINT, UINT, int, UINT, int> BatchKey;
+		std::map<BatchKey, size_t> batchIndices;
+
+		for(UINT slot = 0; slot < mScene.Count(); ++slot)
+		{
+			if(layers[slot] != (UINT)layer)
+				continue;
+
+			const DrawArgs& args = draws[slot];
+			BatchKey key(geometries[slot], args.StartIndexLocation, args.IndexCount, args.BaseVertexLocation, materials[slot], (int)args.PrimitiveType);
+
+			auto it = batchIndices.find(key);
+			if(it == batchIndices.end())
+			{
+				InstanceBatch batch;
+				batch.Geo = mGeometries[geometries[slot]].get();
+				batch.Mat = mMaterials[materials[slot]].get();
+				batch.GeoId = geometries[slot];
+				batch.MatId = materials[slot];
+				batch.Draw = args;
+
+				it = batchIndices.emplace(key, batches.size()).first;
+				batches.push_back(std::move(batch));
+			}
+
+			batches[it->second].Items.push_back(mScene.Handle(slot));
+		}
+	}
+}
+
+void TreeBillboardsApp::DrawRenderQueue(RenderCommandList* cmdList, UINT first, UINT last)
+{
+	UINT objCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(ObjectConstants));
+	UINT matCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(MaterialConstants));
+
+	// An empty scene has no ObjectCB, and no item draws to bind one for.
+	D3D12_GPU_VIRTUAL_ADDRESS objectCB = mCurrFrameResource->ObjectCB ? mCurrFrameResource->ObjectCB->GpuAddress() : 0;
+	D3D12_GPU_VIRTUAL_ADDRESS matCB = mCurrFrameResource->MaterialCB->GpuAddress();
+
+	// Headless there is no descriptor heap; the null list only records the handle.
+	D3D12_GPU_DESCRIPTOR_HANDLE srvHeapStart = {};
+	if(mSrvDescriptorHeap != nullptr)
+		srvHeapStart = mSrvDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
+
+	// State bound by the previous draw in this list.  The queue is sorted so that
+	// draws sharing a PSO, material or geometry are adjacent; only what differs is
+	// rebound.
+	ID3D12PipelineState* boundPso = nullptr;
+	const MeshGeometry* boundGeo = nullptr;
+	D3D12_PRIMITIVE_TOPOLOGY boundTopology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	const Material* boundMat = nullptr;
+
+	// Each pass's draws are timed as one profiler scope; the queue keeps a pass's
+	// draws together.
+	UINT currentPass = (UINT)RenderLayer::Count;
+	std::uint64_t passBegin = 0;
+
+	for(UINT i = first; i < last; ++i)
+	{
+		const DrawPacket& packet = mDrawPackets[mRenderQueue.Item(i)];
+
+		UINT pass = RenderQueue::KeyLayer(mRenderQueue.Key(i));
+		if(pass != currentPass)
+		{
+			std::uint64_t now = Profiler::Ticks();
+			if(currentPass != (UINT)RenderLayer::Count)
+				Profiler::Record(mLayerPasses[currentPass].Name, passBegin, now);
+
+			currentPass = pass;
+			passBegin = now;
+		}
+
+		MeshGeometry* geo;
+		Material* mat;
+		const DrawArgs* args;
+		if(packet.Batch != nullptr)
+		{
+			geo = packet.Batch->Geo;
+			mat = packet.Batch->Mat;
+			args = &packet.Batch->Draw;
+		}
+		else
+		{
+			geo = mGeometries[mScene.Geometries()[packet.ItemSlot]].get();
+			mat = mMaterials[mScene.Materials()[packet.ItemSlot]].get();
+			args = &mScene.Draws()[packet.ItemSlot];
+		}
+		D3D12_PRIMITIVE_TOPOLOGY topology = args->PrimitiveType;
+
+		if(packet.Pso != boundPso)
+		{
+			cmdList->SetPipelineState(packet.Pso);
+			boundPso = packet.Pso;
+		}
+
+		if(geo != boundGeo)
+		{
+			cmdList->IASetVertexBuffers(0, 1, &geo->VertexBufferView());
+			cmdList->IASetIndexBuffer(&geo->IndexBufferView());
+			boundGeo = geo;
+		}
+
+		if(topology != boundTopology)
+		{
+			cmdList->IASetPrimitiveTopology(topology);
+			boundTopology = topology;
+		}
+
+		if(mat != boundMat)
+		{
+			CD3DX12_GPU_DESCRIPTOR_HANDLE tex(srvHeapStart);
+			tex.Offset(mat->DiffuseSrvHeapIndex, mCbvSrvDescriptorSize);
+
+			D3D12_GPU_VIRTUAL_ADDRESS matCBAddress = matCB + mat->MatCBIndex*matCBByteSize;
+
+			cmdList->SetGraphicsRootDescriptorTable(0, tex);
+			cmdList->SetGraphicsRootConstantBufferView(3, matCBAddress);
+			boundMat = mat;
+		}
+
+		if(packet.Batch != nullptr)
+		{
+			const InstanceBatch& batch = *packet.Batch;
+
+			// SV_InstanceID starts at zero for every draw, so the SRV points at the
+			// batch's own instances.
+			cmdList->SetGraphicsRootShaderResourceView(4, batch.InstanceAddress);
+
+			cmdList->DrawIndexedInstanced(args->IndexCount, batch.InstanceCount, args->StartIndexLocation, args->BaseVertexLocation, 0);
+		}
+		else
+		{
+			// Scene store handles double as ObjectCB indices.
+			UINT objCBIndex = mScene.Handle(packet.ItemSlot);
+
+			D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = objectCB + (UINT64)objCBIndex*objCBByteSize;
+			cmdList->SetGraphicsRootConstantBufferView(1, objCBAddress);
+
+			cmdList->DrawIndexedInstanced(args->IndexCount, 1, args->StartIndexLocation, args->BaseVertexLocation, 0);
+		}
+	}
+
+	if(currentPass != (UINT)RenderLayer::Count)
+		Profiler::Record(mLayerPasses[currentPass].Name, passBegin, Profiler::Ticks());
 }
 
 std::array<const CD3DX12_STATIC_SAMPLER_DESC, 6> TreeBillboardsApp::GetStaticSamplers()